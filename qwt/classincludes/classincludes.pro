@@ -61,6 +61,7 @@ CLASSHEADERS = \
     QwtScaleDraw \
     QwtScaleEngine \
     QwtScaleMap \
+    QwtScratchArena \
     QwtSimpleCompassRose \
     QwtSplineBasis \
     QwtSpline \
@@ -68,6 +69,7 @@ CLASSHEADERS = \
     QwtSplineC2 \
     QwtSplineCubic \
     QwtSplineG1 \
+    QwtSplineIncremental \
     QwtSplineInterpolating \
     QwtSplineLocal \
     QwtSplineParameter \
@@ -114,6 +116,7 @@ contains(QWT_CONFIG, QwtPlot) {
         QwtPlotPicker \
         QwtPlotRasterItem \
         QwtPlotRenderer \
+        QwtPlotBatchRenderer \
         QwtPlotRescaler \
         QwtPlotScaleItem \
         QwtPlotSeriesItem \
@@ -134,8 +137,12 @@ contains(QWT_CONFIG, QwtPlot) {
         QwtIntervalSeriesData \
         QwtPoint3DSeriesData \
         QwtPointSeriesData \
+        QwtPointColumns \
         QwtSetSeriesData \
         QwtSyntheticPointData \
+        QwtCachedSyntheticPointData \
+        QwtFunctorPointData \
+        QwtLevelOfDetailPointData \
         QwtPointArrayData \
         QwtTradingChartData \
         QwtCPointerData
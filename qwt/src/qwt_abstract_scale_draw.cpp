@@ -14,8 +14,38 @@
 #include "qwt_scale_map.h"
 #include <qpainter.h>
 #include <qpalette.h>
-#include <qmap.h>
+#include <qcache.h>
 #include <qlocale.h>
+#include <string.h>
+
+namespace
+{
+    class LabelKey
+    {
+    public:
+        LabelKey( double value, int format ):
+            format( format )
+        {
+            if ( value == 0.0 )
+                value = 0.0; // -0.0 and 0.0 are the same label
+
+            ::memcpy( &bits, &value, sizeof( bits ) );
+        }
+
+        inline bool operator==( const LabelKey &other ) const
+        {
+            return bits == other.bits && format == other.format;
+        }
+
+        quint64 bits;
+        int format;
+    };
+
+    inline uint qHash( const LabelKey &key )
+    {
+        return ::qHash( key.bits ) ^ uint( key.format );
+    }
+}
 
 class QwtAbstractScaleDraw::PrivateData
 {
@@ -23,8 +53,13 @@ public:
     PrivateData():
         spacing( 4.0 ),
         penWidth( 0 ),
-        minExtent( 0.0 )
+        minExtent( 0.0 ),
+        labelFormat( 0 ),
+        isLabelFormatValid( false ),
+        labelRetention( false )
     {
+        labelCache.setMaxCost( 100 );
+
         components = QwtAbstractScaleDraw::Backbone 
             | QwtAbstractScaleDraw::Ticks 
             | QwtAbstractScaleDraw::Labels;
@@ -45,7 +80,12 @@ public:
 
     double minExtent;
 
-    QMap<double, QwtText> labelCache;
+    QCache<LabelKey, QwtText> labelCache;
+    QwtText uncachedLabel;
+
+    int labelFormat;
+    bool isLabelFormatValid;
+    bool labelRetention;
 };
 
 /*!
@@ -97,13 +137,22 @@ bool QwtAbstractScaleDraw::hasComponent( ScaleComponent component ) const
 
 /*!
   Change the scale division
+
+  The cache of tickLabel() is invalidated, unless labelRetention()
+  is enabled.
+
   \param scaleDiv New scale division
+  \sa setLabelRetention()
 */
 void QwtAbstractScaleDraw::setScaleDiv( const QwtScaleDiv &scaleDiv )
 {
     d_data->scaleDiv = scaleDiv;
     d_data->map.setScaleInterval( scaleDiv.lowerBound(), scaleDiv.upperBound() );
-    d_data->labelCache.clear();
+
+    if ( !d_data->labelRetention )
+        d_data->labelCache.clear();
+
+    d_data->isLabelFormatValid = false;
 }
 
 /*!
@@ -376,6 +425,30 @@ QwtText QwtAbstractScaleDraw::label( double value ) const
     return QLocale().toString( value );
 }
 
+/*!
+  \brief Identifier for the state, that has an effect on the labels
+
+  Labels are cached by their value and the identifier returned
+  from labelFormatKey(). When labelRetention() is enabled, a cached
+  label is reused for a different scale division, as long as the 
+  format of the labels has not changed. labelFormatKey() is called 
+  after a new scale division has been assigned and when the cache 
+  has been invalidated.
+
+  Scale draws, where the format of the labels depends on the
+  scale division ( like QwtDateScaleDraw ) need to overload
+  labelFormatKey(), before enabling labelRetention(). Scale draws,
+  where the labels depend on other attributes need to call
+  invalidateCache(), when these attributes are changed.
+
+  \return 0
+  \sa tickLabel(), invalidateCache()
+*/
+int QwtAbstractScaleDraw::labelFormatKey() const
+{
+    return 0;
+}
+
 /*!
    \brief Convert a value into its representing label and cache it.
 
@@ -384,37 +457,117 @@ QwtText QwtAbstractScaleDraw::label( double value ) const
    calculation of the label sizes might be slow (really slow
    for rich text in Qt4), so it's necessary to cache the labels.
 
+   Labels are cached together with their size for the font
+   in a LRU cache. When labelRetention() is enabled, the cache is
+   not cleared, when a new scale division is assigned. So the labels
+   of a scrolling scale are only created and measured, when they
+   are entering the scale.
+
    \param font Font
    \param value Value
 
    \return Tick label
+   \sa setLabelCacheSize(), labelFormatKey()
 */
 const QwtText &QwtAbstractScaleDraw::tickLabel(
     const QFont &font, double value ) const
 {
-    QMap<double, QwtText>::const_iterator it = d_data->labelCache.find( value );
-    if ( it == d_data->labelCache.end() )
+    if ( !d_data->isLabelFormatValid )
     {
-        QwtText lbl = label( value );
-        lbl.setRenderFlags( 0 );
-        lbl.setLayoutAttribute( QwtText::MinimumLayout );
+        d_data->labelFormat = labelFormatKey();
+        d_data->isLabelFormatValid = true;
+    }
+
+    const LabelKey key( value, d_data->labelFormat );
+
+    const QwtText *cachedLabel = d_data->labelCache.object( key );
+    if ( cachedLabel )
+        return *cachedLabel;
 
-        ( void )lbl.textSize( font ); // initialize the internal cache
+    QwtText lbl = label( value );
+    lbl.setRenderFlags( 0 );
+    lbl.setLayoutAttribute( QwtText::MinimumLayout );
 
-        it = d_data->labelCache.insert( value, lbl );
+    ( void )lbl.textSize( font ); // initialize the internal cache
+
+    if ( d_data->labelCache.maxCost() > 0 )
+    {
+        QwtText *newLabel = new QwtText( lbl );
+        d_data->labelCache.insert( key, newLabel );
+
+        return *newLabel;
     }
 
-    return ( *it );
+    d_data->uncachedLabel = lbl;
+    return d_data->uncachedLabel;
 }
 
 /*!
    Invalidate the cache used by tickLabel()
 
-   The cache is invalidated, when a new QwtScaleDiv is set. If
-   the labels need to be changed. while the same QwtScaleDiv is set,
-   invalidateCache() needs to be called manually.
+   The cache is invalidated, when a new QwtScaleDiv is set - unless
+   labelRetention() is enabled, where it is kept as long as
+   labelFormatKey() does not change. If the labels need to be changed
+   for other reasons, invalidateCache() needs to be called manually.
+
+   \sa labelFormatKey(), setLabelRetention()
 */
 void QwtAbstractScaleDraw::invalidateCache()
 {
     d_data->labelCache.clear();
+    d_data->isLabelFormatValid = false;
+}
+
+/*!
+   \brief Set the maximum number of labels in the cache of tickLabel()
+
+   When the cache is full the least recently used label is removed.
+   The default setting is 100 labels, a size of 0 disables the cache.
+
+   \param numLabels Maximum number of cached labels
+   \sa labelCacheSize(), invalidateCache()
+*/
+void QwtAbstractScaleDraw::setLabelCacheSize( int numLabels )
+{
+    d_data->labelCache.setMaxCost( qMax( numLabels, 0 ) );
+}
+
+/*!
+   \return Maximum number of labels in the cache of tickLabel()
+   \sa setLabelCacheSize()
+*/
+int QwtAbstractScaleDraw::labelCacheSize() const
+{
+    return d_data->labelCache.maxCost();
+}
+
+/*!
+   \brief En/Disable keeping the cached labels for new scale divisions
+
+   Usually the labels of tickLabel() are cached for the current scale
+   division only. When retaining the labels, they are kept, when a new
+   scale division is assigned, so that a scrolling scale creates and
+   measures only the labels entering the scale.
+
+   This is only correct, when label() does not depend on the scale
+   division - or when labelFormatKey() is overloaded to return 
+   different keys for scale divisions with different labels.
+
+   The default setting is false.
+
+   \param on On/Off
+   \sa labelRetention(), labelFormatKey(), setLabelCacheSize()
+*/
+void QwtAbstractScaleDraw::setLabelRetention( bool on )
+{
+    d_data->labelRetention = on;
+}
+
+/*!
+   \return True, when the cached labels are kept for new scale divisions
+   \sa setLabelRetention()
+*/
+bool QwtAbstractScaleDraw::labelRetention() const
+{
+    return d_data->labelRetention;
 }
@@ -97,6 +97,12 @@ public:
 
     void invalidateCache();
 
+    void setLabelCacheSize( int );
+    int labelCacheSize() const;
+
+    void setLabelRetention( bool );
+    bool labelRetention() const;
+
 protected:
     /*!
        Draw a tick
@@ -129,6 +135,8 @@ protected:
 
     const QwtText &tickLabel( const QFont &, double value ) const;
 
+    virtual int labelFormatKey() const;
+
 private:
     Q_DISABLE_COPY(QwtAbstractScaleDraw)
 
@@ -9,6 +9,7 @@
 
 #include "qwt_clipper.h"
 #include "qwt_point_polar.h"
+#include "qwt_scratch_arena.h"
 #include <qrect.h>
 #include <string.h>
 #include <stdlib.h>
@@ -128,18 +129,25 @@ class QwtClip::PointBuffer
 {
 public:
     explicit PointBuffer( int capacity = 0 ):
+        m_arena( QwtScratchArena::instance() ),
         m_capacity( 0 ),
         m_size( 0 ),
         m_buffer( NULL )
     {
         if ( capacity > 0 )
-            reserve( capacity );
+        {
+            size_t bytes;
+            m_buffer = static_cast<Point *>( 
+                m_arena->acquireMemory( capacity * sizeof( Point ), bytes ) );
+
+            m_capacity = bytes / sizeof( Point );
+        }
     }
 
     ~PointBuffer()
     {
         if ( m_buffer )
-            ::free( m_buffer );
+            m_arena->releaseMemory( m_buffer, m_capacity * sizeof( Point ) );
     }
 
     inline void setPoints( int numPoints, const Point *points )
@@ -147,7 +155,8 @@ public:
         reserve( numPoints );
 
         m_size = numPoints;
-        ::memcpy( m_buffer, points, m_size * sizeof( Point ) );
+        if ( m_size > 0 )
+            ::memcpy( m_buffer, points, m_size * sizeof( Point ) );
     }
 
     inline void reset() 
@@ -186,16 +195,26 @@ public:
 private:
     inline void reserve( int size )
     {
+        if ( m_capacity >= size )
+            return;
+
+        const int oldCapacity = m_capacity;
+
         if ( m_capacity == 0 )
             m_capacity = 1;
 
         while ( m_capacity < size )
             m_capacity *= 2;
 
-        m_buffer = static_cast<Point *>( 
-            ::realloc( m_buffer, m_capacity * sizeof( Point ) ) );
+        size_t bytes = m_buffer ? oldCapacity * sizeof( Point ) : 0;
+
+        m_buffer = static_cast<Point *>( m_arena->resizeMemory( 
+            m_buffer, m_capacity * sizeof( Point ), bytes ) );
+
+        m_capacity = bytes / sizeof( Point );
     }
 
+    QwtScratchArena *m_arena;
     int m_capacity;
     int m_size;
     Point *m_buffer;
@@ -219,8 +238,8 @@ public:
             return polygon;
 #endif
 
-        PointBuffer<Point> points1;
-        PointBuffer<Point> points2( qMin( 256, polygon.size() ) );
+        PointBuffer<Point> points1( polygon.size() );
+        PointBuffer<Point> points2( polygon.size() );
 
         points1.setPoints( polygon.size(), polygon.data() );
 
@@ -229,9 +248,11 @@ public:
         clipEdge< TopEdge<Point, T> >( closePolygon, points1, points2 );
         clipEdge< BottomEdge<Point, T> >( closePolygon, points2, points1 );
 
-        Polygon p;
-        p.resize( points1.size() );
-        ::memcpy( p.data(), points1.data(), points1.size() * sizeof( Point ) );
+        // the result is returned to the application: no buffer of the arena
+
+        Polygon p( points1.size() );
+        if ( points1.size() > 0 )
+            ::memcpy( p.data(), points1.data(), points1.size() * sizeof( Point ) );
 
         return p;
     }
@@ -75,6 +75,7 @@ QwtCompassScaleDraw::QwtCompassScaleDraw( const QMap<double, QString> &map ):
 void QwtCompassScaleDraw::setLabelMap( const QMap<double, QString> &map )
 {
     d_labelMap = map;
+    invalidateCache();
 }
 
 
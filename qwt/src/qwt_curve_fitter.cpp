@@ -28,3 +28,47 @@ QwtCurveFitter::Mode QwtCurveFitter::mode() const
 {
     return d_mode;
 }
+
+/*!
+   Find a curve path, which has the best fit to the part of a series
+   of data points, that is inside a rectangle of interest
+
+   QwtPlotCurve passes the area, that is painted, in paint device 
+   coordinates. It can be used to fit only the visible part of the curve.
+
+   The default implementation ignores the rectangle and
+   returns fitCurvePath( points ).
+
+   \param points Series of data points
+   \param rect Rectangle of interest, an invalid rectangle
+                means the complete curve
+
+   \return Curve path
+   \sa fitCurvePath(), isRestrictingToRect()
+ */
+QPainterPath QwtCurveFitter::fitCurvePathInRect( 
+    const QPolygonF &points, const QRectF &rect ) const
+{
+    Q_UNUSED( rect )
+    return fitCurvePath( points );
+}
+
+/*!
+   \brief Check if fitCurvePathInRect() restricts the curve 
+          to the rectangle of interest
+
+   QwtPlotCurve clips the points before fitting them 
+   ( QwtPlotCurve::ClipPolygons ), unless the fitter restricts
+   the curve to the rectangle itself.
+
+   The default implementation returns false, what is correct for 
+   all fitters, that don't overload fitCurvePathInRect().
+
+   \return True, when fitCurvePathInRect() fits only the part
+           of the curve inside of the rectangle
+   \sa fitCurvePathInRect()
+ */
+bool QwtCurveFitter::isRestrictingToRect() const
+{
+    return false;
+}
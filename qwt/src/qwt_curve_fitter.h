@@ -13,6 +13,7 @@
 #include "qwt_global.h"
 #include <qpolygon.h>
 #include <qpainterpath.h>
+#include <qrect.h>
 
 /*!
   \brief Abstract base class for a curve fitter
@@ -71,6 +72,11 @@ public:
      */
     virtual QPainterPath fitCurvePath( const QPolygonF &polygon ) const = 0;
 
+    virtual QPainterPath fitCurvePathInRect( 
+        const QPolygonF &, const QRectF & ) const;
+
+    virtual bool isRestrictingToRect() const;
+
 protected:
     explicit QwtCurveFitter( Mode mode );
 
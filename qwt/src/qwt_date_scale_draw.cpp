@@ -8,6 +8,430 @@
  *****************************************************************************/
 
 #include "qwt_date_scale_draw.h"
+#include <qlocale.h>
+#include <qvector.h>
+#include <math.h>
+
+namespace
+{
+    class DateFields
+    {
+    public:
+        int year;
+        int month;
+        int day;
+        int dayOfWeek;
+
+        int hour;
+        int minute;
+        int second;
+        int msec;
+    };
+
+    /*
+      A format string, that has been parsed in advance. Only the
+      expressions, where QDateTime::toString() behaves the same for
+      all supported Qt versions, are accepted. For everything else
+      - f.e. quotes, AM/PM, time zones or week numbers - and for
+      locales without arabic digits compile() fails and the
+      labels have to be created by QwtDate::toString().
+     */
+    class DateFormatter
+    {
+    public:
+        enum TokenType
+        {
+            Literal,
+
+            Day,
+            Day2,
+            DayName,
+            LongDayName,
+
+            Month,
+            Month2,
+            MonthName,
+            LongMonthName,
+
+            Year2,
+            Year4,
+
+            Hour,
+            Hour2,
+            Minute,
+            Minute2,
+            Second,
+            Second2,
+            Millisecond3
+        };
+
+        class Token
+        {
+        public:
+            Token( TokenType type = Literal, 
+                    const QString &text = QString() ):
+                type( type ),
+                text( text )
+            {
+            }
+
+            TokenType type;
+            QString text;
+        };
+
+        DateFormatter():
+            d_isValid( false )
+        {
+        }
+
+        inline bool isCompiled( const QString &format,
+            const QLocale &locale ) const
+        {
+            return format == d_format && locale == d_locale;
+        }
+
+        inline bool isValid() const
+        {
+            return d_isValid;
+        }
+
+        void compile( const QString &format, const QLocale &locale );
+        QString toString( const DateFields & ) const;
+
+    private:
+        inline void appendLiteral( QChar c )
+        {
+            if ( d_tokens.isEmpty() || d_tokens.last().type != Literal )
+                d_tokens += Token( Literal );
+
+            d_tokens.last().text += c;
+        }
+
+        QString d_format;
+        QLocale d_locale;
+
+        bool d_isValid;
+        QVector<Token> d_tokens;
+
+        QString d_dayNames[2][8];
+        QString d_monthNames[2][13];
+    };
+}
+
+void DateFormatter::compile( const QString &format, const QLocale &locale )
+{
+    d_format = format;
+    d_locale = locale;
+    d_tokens.clear();
+
+    d_isValid = ( locale.zeroDigit() == QLatin1Char( '0' ) );
+
+    for ( int i = 0; d_isValid && i < format.size(); )
+    {
+        const QChar c = format[i];
+
+        int repeat = 1;
+        while ( i + repeat < format.size() && format[i + repeat] == c )
+            repeat++;
+
+        switch ( c.unicode() )
+        {
+            case 'd':
+            {
+                static const TokenType types[] =
+                    { Day, Day2, DayName, LongDayName };
+
+                repeat = qMin( repeat, 4 );
+                d_tokens += Token( types[repeat - 1] );
+                break;
+            }
+            case 'M':
+            {
+                static const TokenType types[] =
+                    { Month, Month2, MonthName, LongMonthName };
+
+                repeat = qMin( repeat, 4 );
+                d_tokens += Token( types[repeat - 1] );
+                break;
+            }
+            case 'y':
+            {
+                if ( repeat >= 4 )
+                {
+                    repeat = 4;
+                    d_tokens += Token( Year4 );
+                }
+                else if ( repeat >= 2 )
+                {
+                    repeat = 2;
+                    d_tokens += Token( Year2 );
+                }
+                else
+                {
+                    appendLiteral( c );
+                }
+                break;
+            }
+            case 'h':
+            {
+                repeat = qMin( repeat, 2 );
+                d_tokens += Token( repeat == 1 ? Hour : Hour2 );
+                break;
+            }
+            case 'm':
+            {
+                repeat = qMin( repeat, 2 );
+                d_tokens += Token( repeat == 1 ? Minute : Minute2 );
+                break;
+            }
+            case 's':
+            {
+                repeat = qMin( repeat, 2 );
+                d_tokens += Token( repeat == 1 ? Second : Second2 );
+                break;
+            }
+            case 'z':
+            {
+                if ( repeat >= 3 )
+                {
+                    repeat = 3;
+                    d_tokens += Token( Millisecond3 );
+                }
+                else
+                {
+                    // "z" has changed its meaning in Qt 5.x
+                    d_isValid = false;
+                }
+                break;
+            }
+            case 'H':
+            case 'A':
+            case 'a':
+            case 'P':
+            case 'p':
+            case 't':
+            case 'w':
+            case '\'':
+            {
+                d_isValid = false;
+                break;
+            }
+            default:
+            {
+                repeat = 1;
+                appendLiteral( c );
+            }
+        }
+
+        i += repeat;
+    }
+
+    if ( !d_isValid )
+    {
+        d_tokens.clear();
+        return;
+    }
+
+    for ( int i = 0; i < d_tokens.size(); i++ )
+    {
+        const TokenType type = d_tokens[i].type;
+
+        if ( type == DayName || type == LongDayName )
+        {
+            const int index = ( type == DayName ) ? 0 : 1;
+            const QLocale::FormatType formatType = 
+                ( type == DayName ) ? QLocale::ShortFormat : QLocale::LongFormat;
+
+            for ( int day = Qt::Monday; day <= Qt::Sunday; day++ )
+                d_dayNames[index][day] = locale.dayName( day, formatType );
+        }
+        else if ( type == MonthName || type == LongMonthName )
+        {
+            const int index = ( type == MonthName ) ? 0 : 1;
+            const QLocale::FormatType formatType = 
+                ( type == MonthName ) ? QLocale::ShortFormat : QLocale::LongFormat;
+
+            for ( int month = 1; month <= 12; month++ )
+                d_monthNames[index][month] = locale.monthName( month, formatType );
+        }
+    }
+}
+
+static inline void qwtAppendNumber( QString &s, int value, int digits )
+{
+    char buf[4];
+
+    int n = 0;
+    do
+    {
+        buf[n++] = '0' + value % 10;
+        value /= 10;
+    } while ( value > 0 && n < 4 );
+
+    for ( int i = n; i < digits; i++ )
+        s += QLatin1Char( '0' );
+
+    while ( n > 0 )
+        s += QLatin1Char( buf[--n] );
+}
+
+QString DateFormatter::toString( const DateFields &fields ) const
+{
+    QString s;
+    s.reserve( 2 * d_format.size() + 16 );
+
+    for ( int i = 0; i < d_tokens.size(); i++ )
+    {
+        const Token &token = d_tokens[i];
+
+        switch( token.type )
+        {
+            case Literal:
+                s += token.text;
+                break;
+
+            case Day:
+                qwtAppendNumber( s, fields.day, 1 );
+                break;
+            case Day2:
+                qwtAppendNumber( s, fields.day, 2 );
+                break;
+            case DayName:
+                s += d_dayNames[0][fields.dayOfWeek];
+                break;
+            case LongDayName:
+                s += d_dayNames[1][fields.dayOfWeek];
+                break;
+
+            case Month:
+                qwtAppendNumber( s, fields.month, 1 );
+                break;
+            case Month2:
+                qwtAppendNumber( s, fields.month, 2 );
+                break;
+            case MonthName:
+                s += d_monthNames[0][fields.month];
+                break;
+            case LongMonthName:
+                s += d_monthNames[1][fields.month];
+                break;
+
+            case Year2:
+                qwtAppendNumber( s, fields.year % 100, 2 );
+                break;
+            case Year4:
+                qwtAppendNumber( s, fields.year, 4 );
+                break;
+
+            case Hour:
+                qwtAppendNumber( s, fields.hour, 1 );
+                break;
+            case Hour2:
+                qwtAppendNumber( s, fields.hour, 2 );
+                break;
+            case Minute:
+                qwtAppendNumber( s, fields.minute, 1 );
+                break;
+            case Minute2:
+                qwtAppendNumber( s, fields.minute, 2 );
+                break;
+            case Second:
+                qwtAppendNumber( s, fields.second, 1 );
+                break;
+            case Second2:
+                qwtAppendNumber( s, fields.second, 2 );
+                break;
+            case Millisecond3:
+                qwtAppendNumber( s, fields.msec, 3 );
+                break;
+        }
+    }
+
+    return s;
+}
+
+static inline void qwtSplitTime( int msecs, DateFields &fields )
+{
+    fields.hour = msecs / 3600000;
+    fields.minute = ( msecs / 60000 ) % 60;
+    fields.second = ( msecs / 1000 ) % 60;
+    fields.msec = msecs % 1000;
+}
+
+/*
+  Calendar fields for a value in ms since the epoch, shifted by
+  a fixed offset. The same rounding as in QwtDate::toDateTime(),
+  but without creating any QDate/QTime objects. The conversion
+  of the days into a date of the proleptic gregorian calendar is
+  the "civil_from_days" algorithm of Howard Hinnant.
+ */
+static bool qwtToDateFields( double value, int utcOffset, DateFields &fields )
+{
+    const double msecsPerDay = 86400000.0;
+
+    value += utcOffset * 1000.0;
+
+    const double days = ::floor( value / msecsPerDay );
+    if ( !( days > -1e7 && days < 1e7 ) )
+        return false;
+
+    int msecs = static_cast<int>( value - days * msecsPerDay );
+    if ( msecs >= 86400000 )
+        msecs -= 86400000; // like QTime::addMSecs
+
+    const qint64 z = static_cast<qint64>( days ) + 719468;
+    const qint64 era = ( z >= 0 ? z : z - 146096 ) / 146097;
+    const int doe = static_cast<int>( z - era * 146097 );
+    const int yoe = ( doe - doe / 1460 + doe / 36524 - doe / 146096 ) / 365;
+    const int doy = doe - ( 365 * yoe + yoe / 4 - yoe / 100 );
+    const int mp = ( 5 * doy + 2 ) / 153;
+
+    fields.day = doy - ( 153 * mp + 2 ) / 5 + 1;
+    fields.month = ( mp < 10 ) ? mp + 3 : mp - 9;
+    fields.year = static_cast<int>( yoe + era * 400 ) + ( fields.month <= 2 );
+
+    // 1970-01-01 was a Thursday
+    int dayOfWeek = static_cast<int>( static_cast<qint64>( days ) % 7 );
+    if ( dayOfWeek < 0 )
+        dayOfWeek += 7;
+
+    fields.dayOfWeek = ( dayOfWeek + 3 ) % 7 + 1;
+
+    qwtSplitTime( msecs, fields );
+
+    return true;
+}
+
+static inline void qwtToDateFields( const QDateTime &dateTime, 
+    DateFields &fields )
+{
+    const QDate date = dateTime.date();
+    date.getDate( &fields.year, &fields.month, &fields.day );
+    fields.dayOfWeek = date.dayOfWeek();
+
+    const QTime time = dateTime.time();
+    fields.hour = time.hour();
+    fields.minute = time.minute();
+    fields.second = time.second();
+    fields.msec = time.msec();
+}
+
+/*
+  Years, where the precompiled formats give the same result 
+  as QDateTime::toString(). Qt versions differ for years with 
+  more or less than 4 digits, and Qt 4 uses the julian calendar
+  before 1582-10-15, while qwtToDateFields() is proleptic gregorian.
+ */
+static inline bool qwtIsFormattableYear( int year )
+{
+#if QT_VERSION >= 0x050000
+    const int minYear = 1000;
+#else
+    const int minYear = 1583;
+#endif
+
+    return year >= minYear && year <= 9999;
+}
 
 class QwtDateScaleDraw::PrivateData
 {
@@ -15,7 +439,9 @@ public:
     explicit PrivateData( Qt::TimeSpec spec ):
         timeSpec( spec ),
         utcOffset( 0 ),
-        week0Type( QwtDate::FirstThursday )
+        week0Type( QwtDate::FirstThursday ),
+        intervalType( QwtDate::Year ),
+        isIntervalTypeValid( false )
     {
         dateFormats[ QwtDate::Millisecond ] = "hh:mm:ss:zzz\nddd dd MMM yyyy";
         dateFormats[ QwtDate::Second ] = "hh:mm:ss\nddd dd MMM yyyy";
@@ -31,6 +457,13 @@ public:
     int utcOffset;
     QwtDate::Week0Type week0Type;
     QString dateFormats[ QwtDate::Year + 1 ];
+
+    // the interval type of the last scale division
+    QwtScaleDiv scaleDiv;
+    QwtDate::IntervalType intervalType;
+    bool isIntervalTypeValid;
+
+    DateFormatter formatters[ QwtDate::Year + 1 ];
 };
 
 /*!
@@ -64,6 +497,8 @@ QwtDateScaleDraw::~QwtDateScaleDraw()
 void QwtDateScaleDraw::setTimeSpec( Qt::TimeSpec timeSpec )
 {
     d_data->timeSpec = timeSpec;
+    d_data->isIntervalTypeValid = false;
+    invalidateCache();
 }
 
 /*!
@@ -88,6 +523,8 @@ Qt::TimeSpec QwtDateScaleDraw::timeSpec() const
 void QwtDateScaleDraw::setUtcOffset( int seconds )
 {
     d_data->utcOffset = seconds;
+    d_data->isIntervalTypeValid = false;
+    invalidateCache();
 }
 
 /*!
@@ -114,6 +551,7 @@ int QwtDateScaleDraw::utcOffset() const
 void QwtDateScaleDraw::setWeek0Type( QwtDate::Week0Type week0Type )
 {
     d_data->week0Type = week0Type;
+    invalidateCache();
 }
 
 /*!
@@ -140,6 +578,7 @@ void QwtDateScaleDraw::setDateFormat(
         intervalType <= QwtDate::Year )
     {
         d_data->dateFormats[ intervalType ] = format;
+        invalidateCache();
     }
 }
 
@@ -196,6 +635,11 @@ QString QwtDateScaleDraw::dateFormatOfDate( const QDateTime &dateTime,
   The value is converted to a datetime value using toDateTime()
   and converted to a plain text using QwtDate::toString().
 
+  The most common format strings are translated without
+  QDateTime::toString(): they are parsed once and the calendar
+  fields of the value are calculated directly for Qt::UTC and
+  Qt::OffsetFromUTC. The result is the same.
+
   \param value Value
   \return Label string.
 
@@ -203,13 +647,77 @@ QString QwtDateScaleDraw::dateFormatOfDate( const QDateTime &dateTime,
 */
 QwtText QwtDateScaleDraw::label( double value ) const
 {
+    const QwtDate::IntervalType intvType = intervalTypeOfScale();
+
     const QDateTime dt = toDateTime( value );
-    const QString fmt = dateFormatOfDate( 
-        dt, intervalType( scaleDiv() ) );
+    const QString fmt = dateFormatOfDate( dt, intvType );
+
+    const int index = qBound( static_cast<int>( QwtDate::Millisecond ),
+        static_cast<int>( intvType ), static_cast<int>( QwtDate::Year ) );
+
+    DateFormatter &formatter = d_data->formatters[ index ];
+
+    const QLocale locale = QLocale::system();
+    if ( !formatter.isCompiled( fmt, locale ) )
+        formatter.compile( fmt, locale );
+
+    if ( formatter.isValid() && dt.isValid() )
+    {
+        DateFields fields;
+
+        bool ok = true;
+        switch( d_data->timeSpec )
+        {
+            case Qt::UTC:
+                ok = qwtToDateFields( value, 0, fields );
+                break;
+
+            case Qt::OffsetFromUTC:
+                ok = qwtToDateFields( value, d_data->utcOffset, fields );
+                break;
+
+            default:
+                qwtToDateFields( dt, fields );
+        }
+
+        if ( ok && qwtIsFormattableYear( fields.year ) )
+            return formatter.toString( fields );
+    }
 
     return QwtDate::toString( dt, fmt, d_data->week0Type );
 }
 
+/*!
+  \return Interval type of the current scale division,
+          that is cached as long as the scale division does not change
+  \sa intervalType()
+ */
+QwtDate::IntervalType QwtDateScaleDraw::intervalTypeOfScale() const
+{
+    const QwtScaleDiv &div = scaleDiv();
+
+    if ( !d_data->isIntervalTypeValid || d_data->scaleDiv != div )
+    {
+        d_data->intervalType = intervalType( div );
+        d_data->scaleDiv = div;
+        d_data->isIntervalTypeValid = true;
+    }
+
+    return d_data->intervalType;
+}
+
+/*!
+  The format of the labels depends on the interval type
+  of the scale division.
+
+  \return Interval type of the current scale division
+  \sa intervalType(), tickLabel()
+ */
+int QwtDateScaleDraw::labelFormatKey() const
+{
+    return intervalTypeOfScale();
+}
+
 /*!
   Find the less detailed datetime unit, where no rounding
   errors happen.
@@ -78,7 +78,11 @@ protected:
     virtual QString dateFormatOfDate( const QDateTime &,
         QwtDate::IntervalType ) const;
 
+    virtual int labelFormatKey() const;
+
 private:
+    QwtDate::IntervalType intervalTypeOfScale() const;
+
     class PrivateData;
     PrivateData *d_data;
 };
@@ -765,6 +765,7 @@ QwtDateScaleEngine::~QwtDateScaleEngine()
 void QwtDateScaleEngine::setTimeSpec( Qt::TimeSpec timeSpec )
 {
     d_data->timeSpec = timeSpec;
+    invalidateCache();
 }
 
 /*!
@@ -789,6 +790,7 @@ Qt::TimeSpec QwtDateScaleEngine::timeSpec() const
 void QwtDateScaleEngine::setUtcOffset( int seconds )
 {
     d_data->utcOffset = seconds;
+    invalidateCache();
 }
 
 /*!
@@ -815,6 +817,7 @@ int QwtDateScaleEngine::utcOffset() const
 void QwtDateScaleEngine::setWeek0Type( QwtDate::Week0Type week0Type )
 {
     d_data->week0Type = week0Type;
+    invalidateCache();
 }
 
 /*!
@@ -841,6 +844,7 @@ QwtDate::Week0Type QwtDateScaleEngine::week0Type() const
 void QwtDateScaleEngine::setMaxWeeks( int weeks )
 {
     d_data->maxWeeks = qMax( weeks, 0 );
+    invalidateCache();
 }
 
 /*!
@@ -925,6 +929,12 @@ QwtDate::IntervalType QwtDateScaleEngine::intervalType(
 void QwtDateScaleEngine::autoScale( int maxNumSteps,
     double &x1, double &x2, double &stepSize ) const
 {
+    if ( lookupAutoScale( maxNumSteps, x1, x2, stepSize ) )
+        return;
+
+    const double x10 = x1;
+    const double x20 = x2;
+
     stepSize = 0.0;
 
     QwtInterval interval( x1, x2 );
@@ -976,6 +986,8 @@ void QwtDateScaleEngine::autoScale( int maxNumSteps,
         qSwap( x1, x2 );
         stepSize = -stepSize;
     }
+
+    insertAutoScale( maxNumSteps, x10, x20, x1, x2, stepSize );
 }
 
 /*!
@@ -992,6 +1004,16 @@ void QwtDateScaleEngine::autoScale( int maxNumSteps,
 QwtScaleDiv QwtDateScaleEngine::divideScale( double x1, double x2,
     int maxMajorSteps, int maxMinorSteps, double stepSize ) const
 {
+    QwtScaleDiv scaleDiv;
+    if ( lookupScaleDiv( x1, x2, maxMajorSteps, 
+        maxMinorSteps, stepSize, scaleDiv ) )
+    {
+        return scaleDiv;
+    }
+
+    const int maxMajorSteps0 = maxMajorSteps;
+    const double stepSize0 = stepSize;
+
     if ( maxMajorSteps < 1 )
         maxMajorSteps = 1;
 
@@ -1017,13 +1039,13 @@ QwtScaleDiv QwtDateScaleEngine::divideScale( double x1, double x2,
     const QwtDate::IntervalType intvType = 
         intervalType( from, to, maxMajorSteps );
 
-    QwtScaleDiv scaleDiv;
+    double effectiveStepSize = 0.0;
 
     if ( intvType == QwtDate::Millisecond )
     {
         // for milliseconds and below we can use the decimal system
-        scaleDiv = QwtLinearScaleEngine::divideScale( min, max,
-            maxMajorSteps, maxMinorSteps, stepSize );
+        scaleDiv = calculateScaleDiv( min, max,
+            maxMajorSteps, maxMinorSteps, stepSize, effectiveStepSize );
     }
     else
     {
@@ -1042,6 +1064,9 @@ QwtScaleDiv QwtDateScaleEngine::divideScale( double x1, double x2,
     if ( x1 > x2 )
         scaleDiv.invert();
 
+    insertScaleDiv( x1, x2, maxMajorSteps0, 
+        maxMinorSteps, stepSize0, scaleDiv, effectiveStepSize );
+
     return scaleDiv;
 }
 
@@ -16,6 +16,10 @@
 #include <qpixmap.h>
 #include <qpainterpath.h>
 #include <qmath.h>
+#include <qdatastream.h>
+#include <qhash.h>
+#include <qiodevice.h>
+#include <limits>
 
 static bool qwtHasScalablePen( const QPainter *painter )
 {
@@ -63,11 +67,27 @@ static QRectF qwtStrokedPathRect(
     return rect;
 }
 
+namespace
+{
+    /*
+      A path, that has been mapped for RenderPensUnscaled, together
+      with the transformations, that have been used for mapping it
+     */
+    class MappedPath
+    {
+    public:
+        QTransform transform;
+        QTransform initialTransform;
+        QPainterPath path;
+    };
+}
+
 static inline void qwtExecCommand( 
     QPainter *painter, const QwtPainterCommand &cmd, 
     QwtGraphic::RenderHints renderHints,
     const QTransform &transform,
-    const QTransform *initialTransform )
+    const QTransform *initialTransform,
+    MappedPath *mappedPath = NULL )
 {
     switch( cmd.type() )
     {
@@ -95,14 +115,34 @@ static inline void qwtExecCommand(
 
                 painter->resetTransform();
 
-                QPainterPath path = tr.map( *cmd.path() );
-                if ( initialTransform )
+                const QTransform initialTr = initialTransform 
+                    ? *initialTransform : QTransform();
+
+                if ( mappedPath && !mappedPath->path.isEmpty()
+                    && mappedPath->transform == tr 
+                    && mappedPath->initialTransform == initialTr )
                 {
-                    painter->setTransform( *initialTransform );
-                    path = initialTransform->inverted().map( path );
+                    painter->setTransform( initialTr );
+                    painter->drawPath( mappedPath->path );
+                }
+                else
+                {
+                    QPainterPath path = tr.map( *cmd.path() );
+                    if ( initialTransform )
+                    {
+                        painter->setTransform( *initialTransform );
+                        path = initialTransform->inverted().map( path );
+                    }
+
+                    painter->drawPath( path );
+
+                    if ( mappedPath )
+                    {
+                        mappedPath->transform = tr;
+                        mappedPath->initialTransform = initialTr;
+                        mappedPath->path = path;
+                    }
                 }
-
-                painter->drawPath( path );
 
                 painter->setTransform( tr );
             }
@@ -200,6 +240,473 @@ static inline void qwtExecCommand(
 
 }
 
+static inline bool qwtIsEqual( const QwtPainterCommand::StateData &s1,
+    const QwtPainterCommand::StateData &s2, QPaintEngine::DirtyFlag flag )
+{
+    switch( flag )
+    {
+        case QPaintEngine::DirtyPen:
+            return s1.pen == s2.pen;
+
+        case QPaintEngine::DirtyBrush:
+            return s1.brush == s2.brush;
+
+        case QPaintEngine::DirtyBrushOrigin:
+            return s1.brushOrigin == s2.brushOrigin;
+
+        case QPaintEngine::DirtyFont:
+            return s1.font == s2.font;
+
+        case QPaintEngine::DirtyBackground:
+            return s1.backgroundMode == s2.backgroundMode
+                && s1.backgroundBrush == s2.backgroundBrush;
+
+        case QPaintEngine::DirtyTransform:
+            return s1.transform == s2.transform;
+
+        case QPaintEngine::DirtyClipEnabled:
+            return s1.isClipEnabled == s2.isClipEnabled;
+
+        case QPaintEngine::DirtyHints:
+            return s1.renderHints == s2.renderHints;
+
+        case QPaintEngine::DirtyCompositionMode:
+            return s1.compositionMode == s2.compositionMode;
+
+        case QPaintEngine::DirtyOpacity:
+            return s1.opacity == s2.opacity;
+
+        default:
+            return false;
+    }
+}
+
+static inline void qwtCopyState( QwtPainterCommand::StateData &to,
+    const QwtPainterCommand::StateData &from, QPaintEngine::DirtyFlag flag )
+{
+    switch( flag )
+    {
+        case QPaintEngine::DirtyPen:
+            to.pen = from.pen;
+            break;
+
+        case QPaintEngine::DirtyBrush:
+            to.brush = from.brush;
+            break;
+
+        case QPaintEngine::DirtyBrushOrigin:
+            to.brushOrigin = from.brushOrigin;
+            break;
+
+        case QPaintEngine::DirtyFont:
+            to.font = from.font;
+            break;
+
+        case QPaintEngine::DirtyBackground:
+            to.backgroundMode = from.backgroundMode;
+            to.backgroundBrush = from.backgroundBrush;
+            break;
+
+        case QPaintEngine::DirtyTransform:
+            to.transform = from.transform;
+            break;
+
+        case QPaintEngine::DirtyClipEnabled:
+            to.isClipEnabled = from.isClipEnabled;
+            break;
+
+        case QPaintEngine::DirtyClipRegion:
+            to.clipRegion = from.clipRegion;
+            to.clipOperation = from.clipOperation;
+            break;
+
+        case QPaintEngine::DirtyClipPath:
+            to.clipPath = from.clipPath;
+            to.clipOperation = from.clipOperation;
+            break;
+
+        case QPaintEngine::DirtyHints:
+            to.renderHints = from.renderHints;
+            break;
+
+        case QPaintEngine::DirtyCompositionMode:
+            to.compositionMode = from.compositionMode;
+            break;
+
+        case QPaintEngine::DirtyOpacity:
+            to.opacity = from.opacity;
+            break;
+
+        default:
+            break;
+    }
+}
+
+namespace
+{
+    /*
+      Keeps track of the painter state during a replay, so that
+      state changes, that don't change anything, can be removed
+     */
+    class StateTracker
+    {
+    public:
+        StateTracker():
+            d_known( 0 )
+        {
+        }
+
+        /*
+          Returns the flags of a state change without the
+          attributes, that are already set. As the state of the
+          painter is unknown before the replay, the first change of 
+          each attribute is always kept.
+         */
+        QPaintEngine::DirtyFlags apply( 
+            const QwtPainterCommand::StateData &data )
+        {
+            static const QPaintEngine::DirtyFlag flags[] =
+            {
+                QPaintEngine::DirtyPen,
+                QPaintEngine::DirtyBrush,
+                QPaintEngine::DirtyBrushOrigin,
+                QPaintEngine::DirtyFont,
+                QPaintEngine::DirtyBackground,
+                QPaintEngine::DirtyTransform,
+                QPaintEngine::DirtyClipEnabled,
+                QPaintEngine::DirtyClipRegion,
+                QPaintEngine::DirtyClipPath,
+                QPaintEngine::DirtyHints,
+                QPaintEngine::DirtyCompositionMode,
+                QPaintEngine::DirtyOpacity
+            };
+
+            QPaintEngine::DirtyFlags effectiveFlags;
+
+            for ( uint i = 0; i < sizeof( flags ) / sizeof( flags[0] ); i++ )
+            {
+                const QPaintEngine::DirtyFlag flag = flags[i];
+                if ( !( data.flags & flag ) )
+                    continue;
+
+                if ( ( d_known & flag ) && qwtIsEqual( d_state, data, flag ) )
+                    continue;
+
+                qwtCopyState( d_state, data, flag );
+                effectiveFlags |= flag;
+
+                if ( flag == QPaintEngine::DirtyClipRegion
+                    || flag == QPaintEngine::DirtyClipPath )
+                {
+                    // setting a clip implicitly enables clipping
+                    d_known &= ~QPaintEngine::DirtyClipEnabled;
+                }
+                else
+                {
+                    d_known |= flag;
+                }
+            }
+
+            return effectiveFlags;
+        }
+
+        inline bool isKnown( QPaintEngine::DirtyFlag flag ) const
+        {
+            return d_known & flag;
+        }
+
+        inline const QwtPainterCommand::StateData &state() const
+        {
+            return d_state;
+        }
+
+    private:
+        QPaintEngine::DirtyFlags d_known;
+        QwtPainterCommand::StateData d_state;
+    };
+}
+
+/*
+  A gradient in object bounding mode depends on the bounding
+  rectangle of the path, that changes, when paths are merged.
+ */
+static inline bool qwtIsObjectRelative( const QBrush &brush )
+{
+    const QGradient *gradient = brush.gradient();
+    if ( gradient == NULL )
+        return false;
+
+#if QT_VERSION >= 0x050c00
+    if ( gradient->coordinateMode() == QGradient::ObjectMode )
+        return true;
+#endif
+
+    return gradient->coordinateMode() == QGradient::ObjectBoundingMode;
+}
+
+/*
+  Paths can be merged, when painting them in one operation has
+  the same result as painting them one after the other. This is the case
+  for opaque pens and brushes, when the paths don't overlap.
+
+  Whether the paths overlap is decided in the coordinates of the
+  recording. This is only valid for pens, that are scaled together
+  with the paths. Cosmetic pens and pens of graphics, that are rendered
+  with RenderPensUnscaled, have a width in device pixels and might 
+  overlap, when the graphic is rendered scaled down.
+ */
+static bool qwtIsMergeable( const StateTracker &tracker,
+    QwtGraphic::RenderHints renderHints )
+{
+    if ( !( tracker.isKnown( QPaintEngine::DirtyPen )
+        && tracker.isKnown( QPaintEngine::DirtyBrush ) ) )
+    {
+        return false;
+    }
+
+    const QwtPainterCommand::StateData &state = tracker.state();
+
+    if ( tracker.isKnown( QPaintEngine::DirtyCompositionMode ) 
+        && state.compositionMode != QPainter::CompositionMode_SourceOver )
+    {
+        return false;
+    }
+
+    if ( tracker.isKnown( QPaintEngine::DirtyOpacity ) 
+        && state.opacity < 1.0 )
+    {
+        return false;
+    }
+
+    const QPen &pen = state.pen;
+    if ( pen.style() != Qt::NoPen )
+    {
+        if ( pen.style() != Qt::SolidLine || !pen.brush().isOpaque() )
+            return false;
+
+        if ( pen.isCosmetic() 
+            || renderHints.testFlag( QwtGraphic::RenderPensUnscaled ) )
+        {
+            return false;
+        }
+
+        if ( qwtIsObjectRelative( pen.brush() ) )
+            return false;
+    }
+
+    const QBrush &brush = state.brush;
+    if ( brush.style() != Qt::NoBrush )
+    {
+        if ( !brush.isOpaque() || qwtIsObjectRelative( brush ) )
+            return false;
+    }
+
+    return true;
+}
+
+static inline QRectF qwtMergeRect( 
+    const QPainterPath &path, const QPen &pen )
+{
+    // the outline and the antialiased pixels around it
+    double off = 1.0;
+    if ( pen.style() != Qt::NoPen )
+        off += qMax( pen.widthF(), qreal( 1.0 ) );
+
+    return path.controlPointRect().adjusted( -off, -off, off, off );
+}
+
+static inline bool qwtHasClipping( QPaintEngine::DirtyFlags flags )
+{
+    return flags & ( QPaintEngine::DirtyClipEnabled 
+        | QPaintEngine::DirtyClipRegion | QPaintEngine::DirtyClipPath );
+}
+
+#ifndef QT_NO_DATASTREAM
+
+// 'QwtG'
+static const quint32 qwtGraphicMagic = 0x51777447;
+static const quint16 qwtGraphicVersion = 1;
+
+static void qwtWriteState( QDataStream &stream, 
+    const QwtPainterCommand::StateData &data, QPaintEngine::DirtyFlags flags )
+{
+    stream << qint32( flags );
+
+    if ( flags & QPaintEngine::DirtyPen ) 
+        stream << data.pen;
+
+    if ( flags & QPaintEngine::DirtyBrush ) 
+        stream << data.brush;
+
+    if ( flags & QPaintEngine::DirtyBrushOrigin ) 
+        stream << data.brushOrigin;
+
+    if ( flags & QPaintEngine::DirtyFont ) 
+        stream << data.font;
+
+    if ( flags & QPaintEngine::DirtyBackground ) 
+        stream << qint8( data.backgroundMode ) << data.backgroundBrush;
+
+    if ( flags & QPaintEngine::DirtyTransform ) 
+        stream << data.transform;
+
+    if ( flags & QPaintEngine::DirtyClipEnabled ) 
+        stream << data.isClipEnabled;
+
+    if ( flags & QPaintEngine::DirtyClipRegion ) 
+        stream << qint8( data.clipOperation ) << data.clipRegion;
+
+    if ( flags & QPaintEngine::DirtyClipPath ) 
+        stream << qint8( data.clipOperation ) << data.clipPath;
+
+    if ( flags & QPaintEngine::DirtyHints ) 
+        stream << qint32( data.renderHints );
+
+    if ( flags & QPaintEngine::DirtyCompositionMode ) 
+        stream << qint32( data.compositionMode );
+
+    if ( flags & QPaintEngine::DirtyOpacity ) 
+        stream << double( data.opacity );
+}
+
+static void qwtReadState( QDataStream &stream, 
+    QwtPainterCommand::StateData &data )
+{
+    qint32 flags;
+    stream >> flags;
+
+    data.flags = QPaintEngine::DirtyFlags( flags );
+
+    if ( data.flags & QPaintEngine::DirtyPen ) 
+        stream >> data.pen;
+
+    if ( data.flags & QPaintEngine::DirtyBrush ) 
+        stream >> data.brush;
+
+    if ( data.flags & QPaintEngine::DirtyBrushOrigin ) 
+        stream >> data.brushOrigin;
+
+    if ( data.flags & QPaintEngine::DirtyFont ) 
+        stream >> data.font;
+
+    if ( data.flags & QPaintEngine::DirtyBackground ) 
+    {
+        qint8 mode;
+        stream >> mode >> data.backgroundBrush;
+
+        data.backgroundMode = static_cast<Qt::BGMode>( mode );
+    }
+
+    if ( data.flags & QPaintEngine::DirtyTransform ) 
+        stream >> data.transform;
+
+    if ( data.flags & QPaintEngine::DirtyClipEnabled ) 
+        stream >> data.isClipEnabled;
+
+    if ( data.flags & QPaintEngine::DirtyClipRegion ) 
+    {
+        qint8 operation;
+        stream >> operation >> data.clipRegion;
+
+        data.clipOperation = static_cast<Qt::ClipOperation>( operation );
+    }
+
+    if ( data.flags & QPaintEngine::DirtyClipPath ) 
+    {
+        qint8 operation;
+        stream >> operation >> data.clipPath;
+
+        data.clipOperation = static_cast<Qt::ClipOperation>( operation );
+    }
+
+    if ( data.flags & QPaintEngine::DirtyHints ) 
+    {
+        qint32 hints;
+        stream >> hints;
+
+        data.renderHints = QPainter::RenderHints( hints );
+    }
+
+    if ( data.flags & QPaintEngine::DirtyCompositionMode ) 
+    {
+        qint32 mode;
+        stream >> mode;
+
+        data.compositionMode = static_cast<QPainter::CompositionMode>( mode );
+    }
+
+    if ( data.flags & QPaintEngine::DirtyOpacity ) 
+    {
+        double opacity;
+        stream >> opacity;
+
+        data.opacity = opacity;
+    }
+}
+
+/*
+  Check a count read from the stream against the number of bytes, that
+  are left. minItemSize is the minimum number of bytes of one item.
+ */
+static bool qwtIsValidCount( const QDataStream &stream,
+    quint32 count, int minItemSize )
+{
+    if ( stream.status() != QDataStream::Ok )
+        return false;
+
+    if ( count > quint32( std::numeric_limits<int>::max() / minItemSize ) )
+        return false;
+
+    const QIODevice *device = stream.device();
+    if ( device && !device->isSequential() )
+        return qint64( count ) * minItemSize <= device->bytesAvailable();
+
+    // for sequential devices we can't know the number of bytes left
+    return true;
+}
+
+template <typename T>
+static bool qwtReadVector( QDataStream &stream,
+    QVector<T> &values, int minItemSize )
+{
+    // like operator>>( QDataStream &, QVector<T> & ), but without
+    // allocating memory for counts, that can't be in the stream
+
+    quint32 count;
+    stream >> count;
+
+    if ( !qwtIsValidCount( stream, count, minItemSize ) )
+        return false;
+
+    values.resize( count );
+
+    T *v = values.data();
+    for ( quint32 i = 0; i < count; i++ )
+        stream >> v[i];
+
+    return stream.status() == QDataStream::Ok;
+}
+
+#endif
+
+/*
+  Rendering a cached raster has the same result as replaying the 
+  commands, when the target is at a pixel position of a raster device
+ */
+static inline bool qwtIsPixelAligned( 
+    const QPainter *painter, const QPointF &pos )
+{
+    if ( painter->paintEngine()->type() != QPaintEngine::Raster )
+        return false;
+
+    const QTransform transform = painter->transform();
+    if ( transform.type() > QTransform::TxTranslate )
+        return false;
+
+    const QPointF p = transform.map( pos );
+    return ( p.x() == qRound( p.x() ) ) && ( p.y() == qRound( p.y() ) );
+}
+
 class QwtGraphic::PathInfo
 {
 public:
@@ -308,6 +815,18 @@ public:
         return sy;
     }
 
+#ifndef QT_NO_DATASTREAM
+    inline void save( QDataStream &stream ) const
+    {
+        stream << d_pointRect << d_boundingRect << d_scalablePen;
+    }
+
+    inline void load( QDataStream &stream )
+    {
+        stream >> d_pointRect >> d_boundingRect >> d_scalablePen;
+    }
+#endif
+
 private:
     QRectF d_pointRect;
     QRectF d_boundingRect;
@@ -320,7 +839,11 @@ public:
     PrivateData():
         boundingRect( 0.0, 0.0, -1.0, -1.0 ),
         pointRect( 0.0, 0.0, -1.0, -1.0 ),
-        initialTransform( NULL )
+        initialTransform( NULL ),
+        isOptimized( false ),
+        hasCompositionModes( false ),
+        cachedRatio( 1.0 ),
+        cachedAspectRatioMode( Qt::IgnoreAspectRatio )
     {
     }
 
@@ -333,6 +856,25 @@ public:
 
     QwtGraphic::RenderHints renderHints;
     QTransform *initialTransform;
+
+    inline void invalidateCache()
+    {
+        isOptimized = false;
+        mappedPaths.clear();
+        cachedImage = QImage();
+    }
+
+    bool isOptimized;
+    bool hasCompositionModes;
+
+    // caches of optimized graphics
+    QVector<MappedPath> mappedPaths;
+
+    QImage cachedImage;
+    QSizeF cachedSize;
+    qreal cachedRatio;
+    Qt::AspectRatioMode cachedAspectRatioMode;
+    QPainter::RenderHints cachedHints;
 };
 
 /*!
@@ -389,6 +931,7 @@ void QwtGraphic::reset()
 {
     d_data->commands.clear();
     d_data->pathInfos.clear();
+    d_data->invalidateCache();
 
     d_data->boundingRect = QRectF( 0.0, 0.0, -1.0, -1.0 );
     d_data->pointRect = QRectF( 0.0, 0.0, -1.0, -1.0 );
@@ -428,6 +971,8 @@ void QwtGraphic::setRenderHint( RenderHint hint, bool on )
         d_data->renderHints |= hint;
     else
         d_data->renderHints &= ~hint;
+
+    d_data->cachedImage = QImage();
 }
 
 /*!
@@ -572,10 +1117,15 @@ void QwtGraphic::render( QPainter *painter ) const
 
     painter->save();
 
+    MappedPath *mappedPaths = NULL;
+    if ( d_data->mappedPaths.size() == numCommands )
+        mappedPaths = d_data->mappedPaths.data();
+
     for ( int i = 0; i < numCommands; i++ )
     {
         qwtExecCommand( painter, commands[i], 
-            d_data->renderHints, transform, d_data->initialTransform );
+            d_data->renderHints, transform, d_data->initialTransform,
+            mappedPaths ? mappedPaths + i : NULL );
     }
 
     painter->restore();
@@ -613,6 +1163,56 @@ void QwtGraphic::render( QPainter *painter, const QRectF &rect,
     if ( isEmpty() || rect.isEmpty() )
         return;
 
+    if ( d_data->isOptimized && !d_data->hasCompositionModes
+        && qwtIsPixelAligned( painter, rect.topLeft() ) )
+    {
+        // replaying the raster of a previous render operation
+
+        qreal ratio = 1.0;
+#if QT_VERSION >= 0x050100
+        ratio = painter->device()->devicePixelRatio();
+#endif
+
+        if ( d_data->cachedImage.isNull() 
+            || d_data->cachedSize != rect.size()
+            || d_data->cachedRatio != ratio 
+            || d_data->cachedAspectRatioMode != aspectRatioMode 
+            || d_data->cachedHints != painter->renderHints() )
+        {
+            const QSize imageSize( qCeil( rect.width() * ratio ),
+                qCeil( rect.height() * ratio ) );
+
+            QImage image( imageSize, QImage::Format_ARGB32_Premultiplied );
+            image.fill( 0 );
+#if QT_VERSION >= 0x050100
+            image.setDevicePixelRatio( ratio );
+#endif
+
+            QPainter imagePainter( &image );
+            imagePainter.setRenderHints( painter->renderHints() );
+
+            renderScaled( &imagePainter, 
+                QRectF( QPointF( 0.0, 0.0 ), rect.size() ), aspectRatioMode );
+
+            imagePainter.end();
+
+            d_data->cachedImage = image;
+            d_data->cachedSize = rect.size();
+            d_data->cachedRatio = ratio;
+            d_data->cachedAspectRatioMode = aspectRatioMode;
+            d_data->cachedHints = painter->renderHints();
+        }
+
+        painter->drawImage( rect.topLeft(), d_data->cachedImage );
+        return;
+    }
+
+    renderScaled( painter, rect, aspectRatioMode );
+}
+
+void QwtGraphic::renderScaled( QPainter *painter, const QRectF &rect, 
+    Qt::AspectRatioMode aspectRatioMode ) const
+{
     double sx = 1.0; 
     double sy = 1.0;
 
@@ -864,6 +1464,7 @@ void QwtGraphic::drawPath( const QPainterPath &path )
     if ( painter == NULL )
         return;
 
+    d_data->invalidateCache();
     d_data->commands += QwtPainterCommand( path );
 
     if ( !path.isEmpty() )
@@ -903,6 +1504,7 @@ void QwtGraphic::drawPixmap( const QRectF &rect,
     if ( painter == NULL )
         return;
 
+    d_data->invalidateCache();
     d_data->commands += QwtPainterCommand( rect, pixmap, subRect );
 
     const QRectF r = painter->transform().mapRect( rect );
@@ -927,6 +1529,7 @@ void QwtGraphic::drawImage( const QRectF &rect, const QImage &image,
     if ( painter == NULL )
         return;
 
+    d_data->invalidateCache();
     d_data->commands += QwtPainterCommand( rect, image, subRect, flags );
 
     const QRectF r = painter->transform().mapRect( rect );
@@ -943,6 +1546,7 @@ void QwtGraphic::drawImage( const QRectF &rect, const QImage &image,
  */
 void QwtGraphic::updateState( const QPaintEngineState &state)
 {
+    d_data->invalidateCache();
     d_data->commands += QwtPainterCommand( state );
 }
 
@@ -973,6 +1577,120 @@ void QwtGraphic::updateControlPointRect( const QRectF &rect )
         d_data->pointRect |= rect;
 }
 
+/*!
+  \brief Optimize the recorded commands for being replayed
+
+  - state changes without any effect are removed and consecutive 
+    state changes are joined
+  - consecutive paths, that are painted with the same opaque pen and
+    brush and that don't overlap, are joined to one path. Paths with
+    cosmetic pens, pens of a graphic with RenderPensUnscaled and
+    gradients relative to the bounding rectangle of the path are
+    never joined.
+  - paths, that are mapped for RenderPensUnscaled, are cached, as long
+    as the transformation of the painter doesn't change
+  - when rendering the graphic to a pixel position of a raster device
+    with render( QPainter *, const QRectF &, Qt::AspectRatioMode ),
+    the raster of the graphic is cached for the size of the
+    target rectangle and the device pixel ratio of the device
+
+  The optimization is lost, when recording further commands. 
+  As the caches are modified in the const render methods, 
+  an optimized graphic should not be rendered from different
+  threads - use copies instead.
+
+  \sa render(), RenderPensUnscaled
+ */
+void QwtGraphic::optimize()
+{
+    const int numCommands = d_data->commands.size();
+    const QwtPainterCommand *commands = d_data->commands.constData();
+
+    QVector<QwtPainterCommand> optimized;
+    optimized.reserve( numCommands );
+
+    StateTracker tracker;
+
+    bool hasCompositionModes = false;
+    QRectF mergeRect;
+
+    for ( int i = 0; i < numCommands; i++ )
+    {
+        const QwtPainterCommand &cmd = commands[i];
+        QwtPainterCommand *last = optimized.isEmpty() ? NULL : &optimized.last();
+
+        if ( cmd.type() == QwtPainterCommand::State )
+        {
+            QwtPainterCommand::StateData data = *cmd.stateData();
+
+            data.flags = tracker.apply( data );
+            if ( data.flags == 0 )
+                continue;
+
+            if ( ( data.flags & QPaintEngine::DirtyCompositionMode )
+                && data.compositionMode != QPainter::CompositionMode_SourceOver )
+            {
+                hasCompositionModes = true;
+            }
+
+            if ( last && last->type() == QwtPainterCommand::State 
+                && !qwtHasClipping( data.flags ) 
+                && !qwtHasClipping( last->stateData()->flags ) )
+            {
+                // the attributes don't depend on each other
+
+                QwtPainterCommand::StateData *lastData = last->stateData();
+
+                for ( int flag = QPaintEngine::DirtyPen;
+                    flag <= QPaintEngine::DirtyOpacity; flag <<= 1 )
+                {
+                    if ( data.flags & flag )
+                    {
+                        qwtCopyState( *lastData, data, 
+                            static_cast<QPaintEngine::DirtyFlag>( flag ) );
+                    }
+                }
+
+                lastData->flags |= data.flags;
+            }
+            else
+            {
+                optimized += QwtPainterCommand( data );
+            }
+        }
+        else if ( cmd.type() == QwtPainterCommand::Path )
+        {
+            const QRectF rect = qwtMergeRect( 
+                *cmd.path(), tracker.state().pen );
+
+            if ( last && last->type() == QwtPainterCommand::Path
+                && qwtIsMergeable( tracker, d_data->renderHints ) 
+                && last->path()->fillRule() == cmd.path()->fillRule()
+                && !mergeRect.intersects( rect ) )
+            {
+                last->path()->addPath( *cmd.path() );
+                mergeRect |= rect;
+            }
+            else
+            {
+                optimized += cmd;
+                mergeRect = rect;
+            }
+        }
+        else
+        {
+            optimized += cmd;
+        }
+    }
+
+    d_data->invalidateCache();
+
+    d_data->commands = optimized;
+    d_data->hasCompositionModes = hasCompositionModes;
+    d_data->mappedPaths.resize( optimized.size() );
+    d_data->isOptimized = true;
+}
+
 /*!
   \return List of recorded paint commands
   \sa setCommands()
@@ -1007,3 +1725,435 @@ void QwtGraphic::setCommands( QVector< QwtPainterCommand > &commands )
 
     painter.end();
 }
+
+#ifndef QT_NO_DATASTREAM
+
+/*!
+  \brief Write the graphic to a stream
+
+  Identical state changes are stored only once and referenced by the
+  commands, state changes without any effect are dropped. The elements
+  of all paths are stored in one flat array.
+
+  \param stream Data stream
+  \sa load()
+ */
+void QwtGraphic::save( QDataStream &stream ) const
+{
+    const int numCommands = d_data->commands.size();
+    const QwtPainterCommand *commands = d_data->commands.constData();
+
+    QList<QByteArray> states;
+    QHash<QByteArray, int> stateIndexes;
+    QVector<int> stateRefs( numCommands, -1 );
+
+    QByteArray fillRules;
+    QVector<quint32> elementCounts;
+    QByteArray elementTypes;
+    QVector<double> coordinates;
+
+    StateTracker tracker;
+
+    for ( int i = 0; i < numCommands; i++ )
+    {
+        const QwtPainterCommand &cmd = commands[i];
+
+        if ( cmd.type() == QwtPainterCommand::State )
+        {
+            const QwtPainterCommand::StateData *data = cmd.stateData();
+
+            const QPaintEngine::DirtyFlags flags = tracker.apply( *data );
+            if ( flags == 0 )
+                continue;
+
+            QByteArray record;
+
+            QDataStream recordStream( &record, QIODevice::WriteOnly );
+            recordStream.setVersion( stream.version() );
+            qwtWriteState( recordStream, *data, flags );
+
+            int index = stateIndexes.value( record, -1 );
+            if ( index < 0 )
+            {
+                index = states.size();
+
+                states += record;
+                stateIndexes.insert( record, index );
+            }
+
+            stateRefs[i] = index;
+        }
+        else if ( cmd.type() == QwtPainterCommand::Path )
+        {
+            const QPainterPath &path = *cmd.path();
+
+            const int numElements = path.elementCount();
+
+            fillRules += char( path.fillRule() );
+            elementCounts += quint32( numElements );
+
+            for ( int j = 0; j < numElements; j++ )
+            {
+                const QPainterPath::Element element = path.elementAt( j );
+
+                elementTypes += char( element.type );
+                coordinates += element.x;
+                coordinates += element.y;
+            }
+        }
+    }
+
+    stream << qwtGraphicMagic << qwtGraphicVersion;
+
+    stream << d_data->defaultSize << qint32( d_data->renderHints )
+        << d_data->boundingRect << d_data->pointRect;
+
+    stream << quint32( states.size() );
+    for ( int i = 0; i < states.size(); i++ )
+        stream.writeRawData( states[i].constData(), states[i].size() );
+
+    stream << fillRules << elementCounts << elementTypes << coordinates;
+
+    stream << quint32( d_data->pathInfos.size() );
+    for ( int i = 0; i < d_data->pathInfos.size(); i++ )
+        d_data->pathInfos[i].save( stream );
+
+    quint32 numStoredCommands = 0;
+    for ( int i = 0; i < numCommands; i++ )
+    {
+        if ( commands[i].type() != QwtPainterCommand::State 
+            || stateRefs[i] >= 0 )
+        {
+            numStoredCommands++;
+        }
+    }
+
+    stream << numStoredCommands;
+
+    for ( int i = 0; i < numCommands; i++ )
+    {
+        const QwtPainterCommand &cmd = commands[i];
+
+        switch( cmd.type() )
+        {
+            case QwtPainterCommand::Path:
+            {
+                stream << qint8( cmd.type() );
+                break;
+            }
+            case QwtPainterCommand::Pixmap:
+            {
+                const QwtPainterCommand::PixmapData *data = cmd.pixmapData();
+
+                stream << qint8( cmd.type() );
+                stream << data->rect << data->pixmap << data->subRect;
+                break;
+            }
+            case QwtPainterCommand::Image:
+            {
+                const QwtPainterCommand::ImageData *data = cmd.imageData();
+
+                stream << qint8( cmd.type() );
+                stream << data->rect << data->image << data->subRect
+                    << qint32( data->flags );
+                break;
+            }
+            case QwtPainterCommand::State:
+            {
+                if ( stateRefs[i] >= 0 )
+                {
+                    stream << qint8( cmd.type() );
+                    stream << quint32( stateRefs[i] );
+                }
+                break;
+            }
+            default:
+            {
+                stream << qint8( QwtPainterCommand::Invalid );
+            }
+        }
+    }
+}
+
+/*!
+  \brief Read a graphic from a stream
+
+  The commands are restored without replaying them, so that loading
+  is much faster than setCommands().
+
+  All counts and sizes are checked against the number of bytes left
+  in the stream, before any memory is allocated for them - for 
+  sequential devices, where this number is unknown, against
+  the range of an int.
+
+  \param stream Data stream
+  \return true, when the graphic could be read. Otherwise the
+          graphic is reset and the status of the stream is set
+          to QDataStream::ReadCorruptData, unless it already
+          indicated an error.
+
+  \sa save()
+ */
+bool QwtGraphic::load( QDataStream &stream )
+{
+    reset();
+
+    if ( stream.status() != QDataStream::Ok )
+        return false;
+
+    quint32 magic;
+    quint16 version;
+
+    stream >> magic >> version;
+    if ( magic != qwtGraphicMagic || version != qwtGraphicVersion )
+    {
+        stream.setStatus( QDataStream::ReadCorruptData );
+        return false;
+    }
+
+    // the minimum number of bytes of the stored items
+    const int minStateSize = 4; // flags
+    const int minPathInfoSize = 2 * 4 * 4 + 1; // 2 rectangles + bool
+    const int minCommandSize = 1; // type
+
+    QSizeF defaultSize;
+    qint32 renderHints;
+    QRectF boundingRect;
+    QRectF pointRect;
+
+    stream >> defaultSize >> renderHints >> boundingRect >> pointRect;
+
+    quint32 numStates;
+    stream >> numStates;
+
+    bool ok = qwtIsValidCount( stream, numStates, minStateSize );
+
+    QVector<QwtPainterCommand::StateData> states;
+    if ( ok )
+        states.reserve( numStates );
+
+    for ( quint32 i = 0; ok && i < numStates; i++ )
+    {
+        QwtPainterCommand::StateData data;
+        qwtReadState( stream, data );
+
+        states += data;
+        ok = ( stream.status() == QDataStream::Ok );
+    }
+
+    QByteArray fillRules;
+    QVector<quint32> elementCounts;
+    QByteArray elementTypes;
+    QVector<double> coordinates;
+
+    if ( ok )
+    {
+        stream >> fillRules;
+        ok = qwtReadVector( stream, elementCounts, 4 );
+    }
+
+    if ( ok )
+    {
+        stream >> elementTypes;
+        ok = qwtReadVector( stream, coordinates, 4 );
+    }
+
+    ok = ok && ( fillRules.size() == elementCounts.size() )
+        && ( 2 * elementTypes.size() == coordinates.size() );
+
+    quint32 numPathInfos = 0;
+    if ( ok )
+    {
+        stream >> numPathInfos;
+        ok = qwtIsValidCount( stream, numPathInfos, minPathInfoSize );
+    }
+
+    QVector<PathInfo> pathInfos;
+    if ( ok )
+        pathInfos.reserve( numPathInfos );
+
+    for ( quint32 i = 0; ok && i < numPathInfos; i++ )
+    {
+        PathInfo info;
+        info.load( stream );
+
+        pathInfos += info;
+        ok = ( stream.status() == QDataStream::Ok );
+    }
+
+    quint32 numCommands = 0;
+    if ( ok )
+    {
+        stream >> numCommands;
+        ok = qwtIsValidCount( stream, numCommands, minCommandSize );
+    }
+
+    QVector<QwtPainterCommand> commands;
+    if ( ok )
+        commands.reserve( numCommands );
+
+    int pathIndex = 0;
+    int elementIndex = 0;
+
+    for ( quint32 i = 0; ok && i < numCommands; i++ )
+    {
+        qint8 type;
+        stream >> type;
+
+        switch( type )
+        {
+            case QwtPainterCommand::Path:
+            {
+                if ( pathIndex >= elementCounts.size() )
+                {
+                    ok = false;
+                    break;
+                }
+
+                const quint32 count = elementCounts[pathIndex];
+                if ( count > quint32( elementTypes.size() - elementIndex ) )
+                {
+                    ok = false;
+                    break;
+                }
+
+                const int fillRule = fillRules[pathIndex];
+                if ( fillRule != Qt::OddEvenFill && fillRule != Qt::WindingFill )
+                {
+                    ok = false;
+                    break;
+                }
+
+                const int numElements = static_cast<int>( count );
+
+                QPainterPath path;
+                path.setFillRule( static_cast<Qt::FillRule>( fillRule ) );
+
+                const char *types = elementTypes.constData() + elementIndex;
+                const double *values = coordinates.constData() + 2 * elementIndex;
+
+                for ( int j = 0; j < numElements; j++ )
+                {
+                    const double *v = values + 2 * j;
+
+                    switch( types[j] )
+                    {
+                        case QPainterPath::MoveToElement:
+                            path.moveTo( v[0], v[1] );
+                            break;
+
+                        case QPainterPath::LineToElement:
+                            path.lineTo( v[0], v[1] );
+                            break;
+
+                        case QPainterPath::CurveToElement:
+                        {
+                            if ( j + 2 < numElements )
+                            {
+                                path.cubicTo( v[0], v[1], 
+                                    v[2], v[3], v[4], v[5] );
+                            }
+                            j += 2;
+                            break;
+                        }
+                        default:
+                            break;
+                    }
+                }
+
+                commands += QwtPainterCommand( path );
+
+                pathIndex++;
+                elementIndex += numElements;
+
+                break;
+            }
+            case QwtPainterCommand::Pixmap:
+            {
+                QRectF rect, subRect;
+                QPixmap pixmap;
+
+                stream >> rect >> pixmap >> subRect;
+                commands += QwtPainterCommand( rect, pixmap, subRect );
+
+                break;
+            }
+            case QwtPainterCommand::Image:
+            {
+                QRectF rect, subRect;
+                QImage image;
+                qint32 flags;
+
+                stream >> rect >> image >> subRect >> flags;
+                commands += QwtPainterCommand( rect, image, subRect,
+                    Qt::ImageConversionFlags( flags ) );
+
+                break;
+            }
+            case QwtPainterCommand::State:
+            {
+                quint32 index;
+                stream >> index;
+
+                if ( index >= quint32( states.size() ) )
+                {
+                    ok = false;
+                    break;
+                }
+
+                commands += QwtPainterCommand( states[index] );
+                break;
+            }
+            default:
+            {
+                commands += QwtPainterCommand();
+            }
+        }
+
+        if ( stream.status() != QDataStream::Ok )
+            ok = false;
+    }
+
+    if ( !ok )
+    {
+        stream.setStatus( QDataStream::ReadCorruptData );
+        return false;
+    }
+
+    d_data->commands = commands;
+    d_data->pathInfos = pathInfos;
+    d_data->defaultSize = defaultSize;
+    d_data->renderHints = RenderHints( renderHints );
+    d_data->boundingRect = boundingRect;
+    d_data->pointRect = pointRect;
+
+    return true;
+}
+
+/*!
+  \brief Write a graphic to a stream
+  \param stream Data stream
+  \param graphic Graphic
+  \return Stream
+  \sa QwtGraphic::save()
+ */
+QDataStream &operator<<( QDataStream &stream, const QwtGraphic &graphic )
+{
+    graphic.save( stream );
+    return stream;
+}
+
+/*!
+  \brief Read a graphic from a stream
+  \param stream Data stream
+  \param graphic Graphic
+  \return Stream
+  \sa QwtGraphic::load()
+ */
+QDataStream &operator>>( QDataStream &stream, QwtGraphic &graphic )
+{
+    graphic.load( stream );
+    return stream;
+}
+
+#endif
@@ -17,6 +17,7 @@
 #include <qpixmap.h>
 
 class QwtPainterCommand;
+class QDataStream;
 
 /*!
     \brief A paint device for scalable graphics
@@ -69,6 +70,12 @@ class QwtPainterCommand;
     scaling with a fixed aspect ratio always needs to be calculated from the 
     control point rectangle.
 
+    A graphic can be stored in a compact binary format ( save(), load() ),
+    where identical state changes are stored only once, state changes
+    without effect are removed and all paths are stored in one flat
+    array of coordinates. Loading a graphic restores the commands
+    without replaying them.
+
     \sa QwtPainterCommand
  */
 class QWT_EXPORT QwtGraphic: public QwtNullPaintDevice
@@ -147,6 +154,13 @@ public:
     void setRenderHint( RenderHint, bool on = true );
     bool testRenderHint( RenderHint ) const;
 
+    void optimize();
+
+#ifndef QT_NO_DATASTREAM
+    void save( QDataStream & ) const;
+    bool load( QDataStream & );
+#endif
+
 protected:
     virtual QSize sizeMetrics() const;
 
@@ -161,6 +175,8 @@ protected:
     virtual void updateState( const QPaintEngineState &state );
 
 private:
+    void renderScaled( QPainter *, const QRectF &, Qt::AspectRatioMode ) const;
+
     void updateBoundingRect( const QRectF & );
     void updateControlPointRect( const QRectF & );
 
@@ -173,4 +189,9 @@ private:
 Q_DECLARE_OPERATORS_FOR_FLAGS( QwtGraphic::RenderHints )
 Q_DECLARE_METATYPE( QwtGraphic )
 
+#ifndef QT_NO_DATASTREAM
+QWT_EXPORT QDataStream &operator<<( QDataStream &, const QwtGraphic & );
+QWT_EXPORT QDataStream &operator>>( QDataStream &, QwtGraphic & );
+#endif
+
 #endif
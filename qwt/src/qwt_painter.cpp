@@ -27,11 +27,23 @@
 #include <qpaintengine.h>
 #include <qapplication.h>
 #include <qdesktopwidget.h>
+#include <qthreadstorage.h>
+#include <qlist.h>
+#include <qpair.h>
 
 #if QT_VERSION >= 0x050000
 #include <qwindow.h>
 #endif
 
+#if QT_VERSION >= 0x040700
+#define QWT_TEXT_CACHE 1
+#endif
+
+#if QWT_TEXT_CACHE
+#include <qstatictext.h>
+#include <qcache.h>
+#endif
+
 #if QT_VERSION < 0x050000 
 
 #ifdef Q_WS_X11
@@ -42,6 +54,7 @@
 
 bool QwtPainter::d_polylineSplitting = true;
 bool QwtPainter::d_roundingAlignment = true;
+int QwtPainter::d_textCacheSize = 1000;
 
 static inline bool qwtIsRasterPaintEngineBuggy()
 {
@@ -220,6 +233,129 @@ static inline void qwtUnscaleFont( QPainter *painter )
     }
 }
 
+#if QWT_TEXT_CACHE
+
+namespace
+{
+    class TextLayout
+    {
+    public:
+        QStaticText staticText;
+        QSizeF size;
+    };
+
+    typedef QCache<QString, TextLayout> TextCache;
+}
+
+static TextCache *qwtTextCache( int maxSize )
+{
+    // each thread has its own cache, so that we don't need to lock
+    static QThreadStorage<TextCache *> caches;
+
+    if ( !caches.hasLocalData() )
+        caches.setLocalData( new TextCache( maxSize ) );
+
+    TextCache *cache = caches.localData();
+    if ( cache->maxCost() != maxSize )
+        cache->setMaxCost( maxSize );
+
+    return cache;
+}
+
+static inline bool qwtIsCacheable( const QString &text, int flags )
+{
+    const int alignments = Qt::AlignLeft | Qt::AlignRight | Qt::AlignHCenter
+        | Qt::AlignTop | Qt::AlignBottom | Qt::AlignVCenter;
+
+    if ( flags & ~( alignments | Qt::TextDontClip | Qt::TextSingleLine ) )
+        return false;
+
+    if ( text.isEmpty() )
+        return false;
+
+    // control characters need the formatting of QPainter::drawText
+
+    const QChar *chars = text.unicode();
+    for ( int i = 0; i < text.length(); i++ )
+    {
+        if ( chars[i].unicode() < 0x20 || chars[i] == QChar::LineSeparator )
+            return false;
+    }
+
+    return true;
+}
+
+static bool qwtDrawCachedText( QPainter *painter, 
+    const QRectF &rect, int flags, const QString &text )
+{
+    const int cacheSize = QwtPainter::textCacheSize();
+
+    if ( cacheSize <= 0 
+        || painter->paintEngine()->type() != QPaintEngine::Raster
+        || painter->layoutDirection() == Qt::RightToLeft
+        || !qwtIsCacheable( text, flags ) )
+    {
+        return false;
+    }
+
+    const QFont &font = painter->font();
+    const QPaintDevice *device = painter->device();
+
+    QString key = font.key();
+    key += QLatin1Char( '/' );
+    key += QString::number( device->logicalDpiX() );
+    key += QLatin1Char( '/' );
+    key += QString::number( device->logicalDpiY() );
+    key += QLatin1Char( '/' );
+    key += text;
+
+    TextCache *cache = qwtTextCache( cacheSize );
+
+    TextLayout *layout = cache->object( key );
+    if ( layout == NULL )
+    {
+        layout = new TextLayout();
+
+        layout->staticText.setText( text );
+        layout->staticText.setTextFormat( Qt::PlainText );
+        layout->staticText.prepare( painter->transform(), font );
+
+        // the same size as it is calculated inside of QPainter::drawText
+        const QFontMetricsF fm( font, const_cast<QPaintDevice *>( device ) );
+        layout->size = fm.boundingRect( 
+            QRectF( 0, 0, QWIDGETSIZE_MAX, QWIDGETSIZE_MAX ), 0, text ).size();
+
+        cache->insert( key, layout );
+    }
+
+    const QSizeF &size = layout->size;
+
+    if ( !( flags & Qt::TextDontClip ) )
+    {
+        // QPainter::drawText would clip the text
+        if ( size.width() > rect.width() || size.height() > rect.height() )
+            return false;
+    }
+
+    double x = rect.left();
+    if ( flags & Qt::AlignRight )
+        x = rect.right() - size.width();
+    else if ( flags & Qt::AlignHCenter )
+        x = rect.left() + 0.5 * ( rect.width() - size.width() );
+
+    double y = rect.top();
+    if ( flags & Qt::AlignBottom )
+        y = rect.bottom() - size.height();
+    else if ( flags & Qt::AlignVCenter )
+        y = rect.top() + 0.5 * ( rect.height() - size.height() );
+
+    painter->drawStaticText( QPointF( x, y ), layout->staticText );
+
+    return true;
+}
+
+#endif
+
 /*!
   Check is the application is running with the X11 graphics system
   that has some special capabilities that can be used for incremental
@@ -285,6 +421,148 @@ bool QwtPainter::isAligning( QPainter *painter )
     return true;
 }
 
+typedef QList<const QPainter *> QwtPainterList;
+
+static QwtPainterList *qwtDecimatingPainters()
+{
+    // painters are used in one thread only, so we don't need to lock
+    static QThreadStorage<QwtPainterList *> painters;
+
+    if ( !painters.hasLocalData() )
+        painters.setLocalData( new QwtPainterList() );
+
+    return painters.localData();
+}
+
+/*!
+  \brief En/Disable the decimation of curves for a painter
+
+  When decimating, plot items with many points reduce them to the
+  resolution of the paint device - also on paint engines with
+  floating point coordinates ( PDF, SVG ), where they usually
+  store each point. QwtPainter stores this state only, the 
+  decimation itself is done in the painting code ( f.e. QwtPlotCurve ).
+
+  The state is bound to the painter and the calling thread and doesn't
+  affect any other painter. Each call enabling the decimation has to be
+  balanced by a call disabling it, before the painter is deleted.
+
+  \param painter Painter
+  \param on On/Off
+
+  \sa isDecimating(), QwtPlotRenderer::DecimatePoints
+*/
+void QwtPainter::setDecimating( const QPainter *painter, bool on )
+{
+    if ( painter == NULL )
+        return;
+
+    QwtPainterList *painters = qwtDecimatingPainters();
+
+    if ( on )
+    {
+        painters->append( painter );
+    }
+    else
+    {
+        const int index = painters->lastIndexOf( painter );
+        if ( index >= 0 )
+            painters->removeAt( index );
+    }
+}
+
+/*!
+  \param painter Painter
+  \return True, when the decimation is enabled for painter
+  \sa setDecimating()
+*/
+bool QwtPainter::isDecimating( const QPainter *painter )
+{
+    if ( painter == NULL )
+        return false;
+
+    return qwtDecimatingPainters()->contains( painter );
+}
+
+typedef QList< QPair<const QPainter *, int> > QwtPainterThresholdList;
+
+static QwtPainterThresholdList *qwtRasterThresholds()
+{
+    // painters are used in one thread only, so we don't need to lock
+    static QThreadStorage<QwtPainterThresholdList *> thresholds;
+
+    if ( !thresholds.hasLocalData() )
+        thresholds.setLocalData( new QwtPainterThresholdList() );
+
+    return thresholds.localData();
+}
+
+/*!
+  \brief Request to rasterize dense plot items for a painter
+
+  Plot items with more points than numPoints render themselves to an 
+  image in the resolution of the paint device, that is painted 
+  instead of the points. This is useful for vector documents 
+  ( PDF, SVG ), where millions of points would end up in the document.
+  QwtPainter stores this setting only, the rasterization itself is 
+  done in the painting code ( f.e. QwtPlotCurve ).
+
+  Like setDecimating() the setting is bound to the painter and
+  the calling thread. Each call with numPoints >= 0 has to be balanced
+  by a call with numPoints < 0, that restores the previous setting.
+
+  \param painter Painter
+  \param numPoints Number of points, from where on items are rasterized.
+                   A negative value removes the most recent setting.
+
+  \sa rasterThreshold(), QwtPlotRenderer::RasterizeDenseItems
+*/
+void QwtPainter::setRasterThreshold( const QPainter *painter, int numPoints )
+{
+    if ( painter == NULL )
+        return;
+
+    QwtPainterThresholdList *thresholds = qwtRasterThresholds();
+
+    if ( numPoints >= 0 )
+    {
+        thresholds->append( qMakePair( painter, numPoints ) );
+    }
+    else
+    {
+        for ( int i = thresholds->size() - 1; i >= 0; i-- )
+        {
+            if ( thresholds->at( i ).first == painter )
+            {
+                thresholds->removeAt( i );
+                break;
+            }
+        }
+    }
+}
+
+/*!
+  \param painter Painter
+  \return Number of points, from where on plot items are rasterized,
+          or -1, when rasterizing is not requested for painter
+
+  \sa setRasterThreshold()
+*/
+int QwtPainter::rasterThreshold( const QPainter *painter )
+{
+    if ( painter == NULL )
+        return -1;
+
+    const QwtPainterThresholdList *thresholds = qwtRasterThresholds();
+    for ( int i = thresholds->size() - 1; i >= 0; i-- )
+    {
+        if ( thresholds->at( i ).first == painter )
+            return thresholds->at( i ).second;
+    }
+
+    return -1;
+}
+
 /*!
   Enable whether coordinates should be rounded, before they are painted
   to a paint engine that floors to integer values. For other paint engines
@@ -301,6 +579,27 @@ void QwtPainter::setRoundingAlignment( bool enable )
     d_roundingAlignment = enable;
 }
 
+/*!
+  \brief Set the size of the text cache
+
+  QwtPainter::drawText() caches the layout of single line texts,
+  that are painted to raster devices. For repeated paint operations -
+  f.e. the tick labels of a scale - the text doesn't need to be
+  shaped again. Each thread has its own cache, where the least 
+  recently used texts are removed, when the cache is full.
+
+  The default setting is 1000 texts.
+
+  \param numTexts Maximum number of texts in each cache, 
+                  0 disables caching
+
+  \sa textCacheSize()
+*/
+void QwtPainter::setTextCacheSize( int numTexts )
+{
+    d_textCacheSize = qMax( numTexts, 0 );
+}
+
 /*!
   \brief En/Disable line splitting for the raster paint engine
 
@@ -450,13 +749,32 @@ void QwtPainter::drawText( QPainter *painter,
     drawText( painter, QRectF( x, y, w, h ), flags, text );
 }
 
-//! Wrapper for QPainter::drawText()
+/*!
+  \brief Wrapper for QPainter::drawText()
+
+  On raster devices single line texts are laid out only once
+  and replayed from a cache ( QStaticText ) for further calls.
+
+  \param painter Painter
+  \param rect Rectangle, where to align the text
+  \param flags Alignments/Text flags, see QPainter::drawText()
+  \param text Text to be rendered
+
+  \sa setTextCacheSize()
+ */
 void QwtPainter::drawText( QPainter *painter, const QRectF &rect,
         int flags, const QString &text )
 {
     painter->save();
     qwtUnscaleFont( painter );
+
+#if QWT_TEXT_CACHE
+    if ( !qwtDrawCachedText( painter, rect, flags, text ) )
+        painter->drawText( rect, flags, text );
+#else
     painter->drawText( rect, flags, text );
+#endif
+
     painter->restore();
 }
 
@@ -541,6 +859,98 @@ void QwtPainter::drawLine( QPainter *painter,
     painter->drawLine( p1, p2 );
 }
 
+/*!
+  Wrapper for QPainter::drawLines()
+
+  Drawing many lines with one call is significantly faster than
+  drawing them one by one.
+
+  \param painter Painter
+  \param lines Array of lines
+  \param lineCount Number of lines
+*/
+void QwtPainter::drawLines( QPainter *painter, 
+    const QLineF *lines, int lineCount )
+{
+    if ( lineCount <= 0 )
+        return;
+
+    QRectF clipRect;
+    const bool deviceClipping = qwtIsClippingNeeded( painter, clipRect );
+
+    if ( deviceClipping )
+    {
+        // lines, that are not completely inside, are clipped one by one
+
+        int from = 0;
+        for ( int i = 0; i < lineCount; i++ )
+        {
+            const QLineF &line = lines[i];
+            if ( !( clipRect.contains( line.p1() ) 
+                && clipRect.contains( line.p2() ) ) )
+            {
+                if ( i > from )
+                    painter->drawLines( lines + from, i - from );
+
+                drawLine( painter, line );
+                from = i + 1;
+            }
+        }
+
+        if ( lineCount > from )
+            painter->drawLines( lines + from, lineCount - from );
+
+        return;
+    }
+
+    painter->drawLines( lines, lineCount );
+}
+
+/*!
+  Wrapper for QPainter::drawRects()
+
+  Drawing many rectangles with one call is significantly faster than
+  drawing them one by one.
+
+  \param painter Painter
+  \param rects Array of rectangles
+  \param rectCount Number of rectangles
+*/
+void QwtPainter::drawRects( QPainter *painter, 
+    const QRectF *rects, int rectCount )
+{
+    if ( rectCount <= 0 )
+        return;
+
+    QRectF clipRect;
+    const bool deviceClipping = qwtIsClippingNeeded( painter, clipRect );
+
+    if ( deviceClipping )
+    {
+        // rectangles, that are not completely inside, are clipped one by one
+
+        int from = 0;
+        for ( int i = 0; i < rectCount; i++ )
+        {
+            if ( !clipRect.contains( rects[i] ) )
+            {
+                if ( i > from )
+                    painter->drawRects( rects + from, i - from );
+
+                drawRect( painter, rects[i] );
+                from = i + 1;
+            }
+        }
+
+        if ( rectCount > from )
+            painter->drawRects( rects + from, rectCount - from );
+
+        return;
+    }
+
+    painter->drawRects( rects, rectCount );
+}
+
 //! Wrapper for QPainter::drawPolygon()
 void QwtPainter::drawPolygon( QPainter *painter, const QPolygonF &polygon )
 {
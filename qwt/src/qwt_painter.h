@@ -46,6 +46,9 @@ public:
     static bool roundingAlignment();
     static bool roundingAlignment(QPainter *);
 
+    static void setTextCacheSize( int );
+    static int textCacheSize();
+
     static void drawText( QPainter *, double x, double y, const QString & );
     static void drawText( QPainter *, const QPointF &, const QString & );
     static void drawText( QPainter *, double x, double y, double w, double h,
@@ -68,6 +71,8 @@ public:
     static void drawLine( QPainter *, double x1, double y1, double x2, double y2 );
     static void drawLine( QPainter *, const QPointF &p1, const QPointF &p2 );
     static void drawLine( QPainter *, const QLineF & );
+    static void drawLines( QPainter *, const QLineF *, int lineCount );
+    static void drawRects( QPainter *, const QRectF *, int rectCount );
 
     static void drawPolygon( QPainter *, const QPolygonF & );
     static void drawPolyline( QPainter *, const QPolygonF & );
@@ -111,6 +116,12 @@ public:
     static bool isAligning( QPainter *painter );
     static bool isX11GraphicsSystem();
 
+    static void setDecimating( const QPainter *, bool on );
+    static bool isDecimating( const QPainter * );
+
+    static void setRasterThreshold( const QPainter *, int numPoints );
+    static int rasterThreshold( const QPainter * );
+
     static void fillPixmap( const QWidget *, 
         QPixmap &, const QPoint &offset = QPoint() );
 
@@ -123,6 +134,7 @@ public:
 private:
     static bool d_polylineSplitting;
     static bool d_roundingAlignment;
+    static int d_textCacheSize;
 };
 
 //!  Wrapper for QPainter::drawPoint()
@@ -178,6 +190,15 @@ inline bool QwtPainter::roundingAlignment()
     return d_roundingAlignment;
 }
 
+/*!
+  \return Maximum number of texts, that are cached for each thread
+  \sa setTextCacheSize()
+*/
+inline int QwtPainter::textCacheSize()
+{
+    return d_textCacheSize;
+}
+
 /*!
   \return roundingAlignment() && isAligning(painter);
   \param painter Painter
@@ -103,6 +103,7 @@ public:
             Qt::ImageConversionFlags );
 
     explicit QwtPainterCommand( const QPaintEngineState & );
+    explicit QwtPainterCommand( const StateData & );
 
     ~QwtPainterCommand();
 
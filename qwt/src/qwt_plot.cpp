@@ -19,6 +19,9 @@
 #include <qmath.h>
 #include <qpainter.h>
 #include <qpointer.h>
+#include <qvector.h>
+#include <qvarlengtharray.h>
+#include <qhash.h>
 #include <qpaintengine.h>
 #include <qapplication.h>
 #include <qevent.h>
@@ -91,6 +94,195 @@ static void qwtSetTabOrder(
     }
 }
 
+/*
+   An item of the culling index together with its position
+   in the z ordered item list of the plot
+ */
+class QwtCullingEntry
+{
+public:
+    double min;
+    double max;
+
+    QwtPlotItem *item;
+    int order;
+};
+
+class QwtLessOrderThan
+{
+public:
+    inline bool operator()( 
+        const QwtCullingEntry &e1, const QwtCullingEntry &e2 ) const
+    {
+        return e1.order < e2.order;
+    }
+};
+
+typedef QVarLengthArray<QwtCullingEntry, 64> QwtCullingCandidates;
+
+/*
+   The extent of an item, when it has been inserted into the index.
+   As long as it doesn't change the index remains valid.
+ */
+class QwtCullingState
+{
+public:
+    int xAxis;
+    QRectF rect;
+    double margin;
+};
+
+/*
+   A static interval tree over the x extents of all items with
+   QwtPlotItem::ViewportCulling enabled. The entries are sorted by their
+   lower bound and organized as an implicit balanced binary tree, where
+   each node knows the maximum upper bound of its subtree.
+   Finding all items intersecting an interval is O(log n + k).
+ */
+class QwtItemIntervalTree
+{
+public:
+    QwtItemIntervalTree():
+        d_maxMargin( 0.0 )
+    {
+    }
+
+    void clear()
+    {
+        d_entries.clear();
+        d_maxEnd.clear();
+        d_maxMargin = 0.0;
+    }
+
+    void insert( QwtPlotItem *item, int order,
+        const QRectF &rect, double margin )
+    {
+        d_maxMargin = qMax( d_maxMargin, margin );
+
+        QwtCullingEntry entry;
+        entry.min = rect.left();
+        entry.max = rect.right();
+        entry.item = item;
+        entry.order = order;
+
+        d_entries += entry;
+    }
+
+    void build()
+    {
+        qSort( d_entries.begin(), d_entries.end(), LessMinThan() );
+
+        d_maxEnd.resize( d_entries.size() );
+        if ( !d_entries.isEmpty() )
+            buildNode( 0, d_entries.size() - 1 );
+    }
+
+    double maxMargin() const
+    {
+        return d_maxMargin;
+    }
+
+    bool isEmpty() const
+    {
+        return d_entries.isEmpty();
+    }
+
+    void query( double min, double max,
+        QwtCullingCandidates &candidates ) const
+    {
+        if ( !d_entries.isEmpty() )
+            queryNode( 0, d_entries.size() - 1, min, max, candidates );
+    }
+
+private:
+    class LessMinThan
+    {
+    public:
+        inline bool operator()( 
+            const QwtCullingEntry &e1, const QwtCullingEntry &e2 ) const
+        {
+            return e1.min < e2.min;
+        }
+    };
+
+    double buildNode( int from, int to )
+    {
+        const int mid = ( from + to ) / 2;
+
+        double maxEnd = d_entries[mid].max;
+        if ( from < mid )
+            maxEnd = qMax( maxEnd, buildNode( from, mid - 1 ) );
+        if ( mid < to )
+            maxEnd = qMax( maxEnd, buildNode( mid + 1, to ) );
+
+        d_maxEnd[mid] = maxEnd;
+        return maxEnd;
+    }
+
+    void queryNode( int from, int to, double min, double max,
+        QwtCullingCandidates &candidates ) const
+    {
+        if ( from > to )
+            return;
+
+        const int mid = ( from + to ) / 2;
+        if ( d_maxEnd[mid] < min )
+        {
+            // all intervals of the subtree end before min
+            return;
+        }
+
+        queryNode( from, mid - 1, min, max, candidates );
+
+        const QwtCullingEntry &entry = d_entries[mid];
+        if ( entry.min <= max )
+        {
+            if ( entry.max >= min )
+                candidates.append( entry );
+
+            queryNode( mid + 1, to, min, max, candidates );
+        }
+    }
+
+    QVector<QwtCullingEntry> d_entries;
+    QVector<double> d_maxEnd;
+    double d_maxMargin;
+};
+
+static bool qwtIsCulled( const QwtPlotItem *item, 
+    const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+    const QRectF &canvasRect )
+{
+    const QRectF rect = item->cullingRect();
+    const double margin = item->cullingMargin();
+
+    if ( rect.width() >= 0.0 )
+    {
+        const double x1 = xMap.transform( rect.left() );
+        const double x2 = xMap.transform( rect.right() );
+
+        if ( qMax( x1, x2 ) + margin < canvasRect.left()
+            || qMin( x1, x2 ) - margin > canvasRect.right() )
+        {
+            return true;
+        }
+    }
+
+    if ( rect.height() >= 0.0 )
+    {
+        const double y1 = yMap.transform( rect.top() );
+        const double y2 = yMap.transform( rect.bottom() );
+
+        if ( qMax( y1, y2 ) + margin < canvasRect.top()
+            || qMin( y1, y2 ) - margin > canvasRect.bottom() )
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 class QwtPlot::PrivateData
 {
 public:
@@ -101,6 +293,15 @@ public:
     QwtPlotLayout *layout;
 
     bool autoReplot;
+
+    // items with QwtPlotItem::ViewportCulling and an x extent
+    mutable QwtItemIntervalTree cullingIndex[QwtPlot::axisCnt];
+
+    // all other items in z order
+    mutable QVector<QwtCullingEntry> unculledItems;
+
+    mutable QHash<const QwtPlotItem *, QwtCullingState> cullingStates;
+    mutable bool isCullingIndexDirty;
 };
 
 /*!
@@ -145,6 +346,7 @@ void QwtPlot::initPlot( const QwtText &title )
 
     d_data->layout = new QwtPlotLayout;
     d_data->autoReplot = false;
+    d_data->isCullingIndexDirty = true;
 
     // title
     d_data->titleLabel = new QwtTextLabel( this );
@@ -571,6 +773,40 @@ void QwtPlot::replot()
     setAutoReplot( doAutoReplot );
 }
 
+/*!
+  \brief Redraw the plot after the scales have been scrolled
+
+  Like replot(), but when the canvas is a QwtPlotCanvas with the
+  QwtPlotCanvas::ScrollBackingStore attribute, the content of the
+  canvas is scrolled and only the newly exposed area is painted -
+  as long as the scales have been shifted by full pixels and
+  no item has been changed.
+
+  \sa replot(), QwtPlotCanvas::replotScrolled(), QwtPlotPanner
+*/
+void QwtPlot::replotScrolled()
+{
+    QwtPlotCanvas *plotCanvas = 
+        qobject_cast<QwtPlotCanvas *>( d_data->canvas );
+
+    if ( plotCanvas == NULL || 
+        !plotCanvas->testPaintAttribute( QwtPlotCanvas::ScrollBackingStore ) )
+    {
+        replot();
+        return;
+    }
+
+    bool doAutoReplot = autoReplot();
+    setAutoReplot( false );
+
+    updateAxes();
+    QApplication::sendPostedEvents( this, QEvent::LayoutRequest );
+
+    plotCanvas->replotScrolled();
+
+    setAutoReplot( doAutoReplot );
+}
+
 /*!
   \brief Adjust plot content to its current size.
   \sa resizeEvent()
@@ -757,26 +993,195 @@ void QwtPlot::drawCanvas( QPainter *painter )
 void QwtPlot::drawItems( QPainter *painter, const QRectF &canvasRect,
         const QwtScaleMap maps[axisCnt] ) const
 {
+    updateCullingIndex();
+
+    // items with QwtPlotItem::ViewportCulling, that might be visible
+
+    QwtCullingCandidates candidates;
+
+    for ( int axisId = xBottom; axisId <= xTop; axisId++ )
+    {
+        const QwtItemIntervalTree &index = d_data->cullingIndex[axisId];
+        if ( index.isEmpty() )
+            continue;
+
+        const QwtScaleMap &map = maps[axisId];
+        const double margin = index.maxMargin();
+
+        const double v1 = map.invTransform( canvasRect.left() - margin );
+        const double v2 = map.invTransform( canvasRect.right() + margin );
+
+        index.query( qMin( v1, v2 ), qMax( v1, v2 ), candidates );
+    }
+
+    QwtCullingEntry *candidate = candidates.data();
+    QwtCullingEntry *candidatesEnd = candidate + candidates.size();
+
+    qSort( candidate, candidatesEnd, QwtLessOrderThan() );
+
+    const QwtCullingEntry *unculled = d_data->unculledItems.constData();
+    const QwtCullingEntry *unculledEnd = 
+        unculled + d_data->unculledItems.size();
+
+    // merging both lists restores the z order 
+
+    while ( unculled != unculledEnd || candidate != candidatesEnd )
+    {
+        const QwtPlotItem *item;
+
+        if ( candidate == candidatesEnd || ( unculled != unculledEnd 
+            && unculled->order < candidate->order ) )
+        {
+            item = ( unculled++ )->item;
+        }
+        else
+        {
+            item = ( candidate++ )->item;
+        }
+
+        if ( !item->isVisible() )
+            continue;
+
+        if ( item->testItemAttribute( QwtPlotItem::ViewportCulling ) &&
+            qwtIsCulled( item, maps[item->xAxis()],
+                maps[item->yAxis()], canvasRect ) )
+        {
+            continue;
+        }
+
+        painter->save();
+
+        painter->setRenderHint( QPainter::Antialiasing,
+            item->testRenderHint( QwtPlotItem::RenderAntialiased ) );
+        painter->setRenderHint( QPainter::HighQualityAntialiasing,
+            item->testRenderHint( QwtPlotItem::RenderAntialiased ) );
+
+        item->draw( painter,
+            maps[item->xAxis()], maps[item->yAxis()],
+            canvasRect );
+
+        painter->restore();
+    }
+}
+
+/*!
+  \brief Rebuild the index for culling items, when it is invalid
+
+  The x extents of all items with the QwtPlotItem::ViewportCulling
+  attribute are organized in an interval tree, all other
+  items are kept in a list in z order.
+
+  \sa drawItems(), QwtPlotItem::cullingRect()
+*/
+void QwtPlot::updateCullingIndex() const
+{
+    if ( !d_data->isCullingIndexDirty )
+        return;
+
+    QwtItemIntervalTree *index = d_data->cullingIndex;
+    for ( int axisId = 0; axisId < axisCnt; axisId++ )
+        index[axisId].clear();
+
+    d_data->unculledItems.clear();
+    d_data->cullingStates.clear();
+
     const QwtPlotItemList& itmList = itemList();
-    for ( QwtPlotItemIterator it = itmList.begin();
-        it != itmList.end(); ++it )
+    for ( int i = 0; i < itmList.size(); i++ )
     {
-        QwtPlotItem *item = *it;
-        if ( item && item->isVisible() )
+        QwtPlotItem *item = itmList[i];
+
+        if ( item->testItemAttribute( QwtPlotItem::ViewportCulling ) )
         {
-            painter->save();
+            QwtCullingState state;
+            state.xAxis = item->xAxis();
+            state.rect = item->cullingRect();
+            state.margin = item->cullingMargin();
+
+            d_data->cullingStates.insert( item, state );
 
-            painter->setRenderHint( QPainter::Antialiasing,
-                item->testRenderHint( QwtPlotItem::RenderAntialiased ) );
-            painter->setRenderHint( QPainter::HighQualityAntialiasing,
-                item->testRenderHint( QwtPlotItem::RenderAntialiased ) );
+            if ( state.rect.width() >= 0.0 )
+            {
+                index[state.xAxis].insert( item, i, 
+                    state.rect, state.margin );
 
-            item->draw( painter,
-                maps[item->xAxis()], maps[item->yAxis()],
-                canvasRect );
+                continue;
+            }
 
-            painter->restore();
+            // no x extent: can't be culled horizontally
         }
+
+        QwtCullingEntry entry;
+        entry.min = entry.max = 0.0;
+        entry.item = item;
+        entry.order = i;
+
+        d_data->unculledItems += entry;
+    }
+
+    for ( int axisId = 0; axisId < axisCnt; axisId++ )
+        index[axisId].build();
+
+    d_data->isCullingIndexDirty = false;
+}
+
+/*!
+  Invalidate the index used for culling items, that are
+  outside of the visible area.
+
+  \sa updateCullingIndex(), QwtPlotItem::itemChanged()
+ */
+void QwtPlot::invalidateCullingIndex()
+{
+    d_data->isCullingIndexDirty = true;
+}
+
+/*!
+  The content of the canvas can't be scrolled anymore, 
+  when an item has been changed.
+
+  \sa replotScrolled(), QwtPlotItem::itemChanged()
+ */
+void QwtPlot::invalidateScrolling()
+{
+    QwtPlotCanvas *plotCanvas = 
+        qobject_cast<QwtPlotCanvas *>( d_data->canvas );
+
+    if ( plotCanvas )
+        plotCanvas->invalidateScrollMaps();
+}
+
+/*!
+  Invalidate the index used for culling items, when the extent
+  of an item with the QwtPlotItem::ViewportCulling attribute has changed.
+  Changes of other items don't affect the index.
+
+  \param item Item, that has been changed
+  \sa invalidateCullingIndex(), QwtPlotItem::itemChanged()
+ */
+void QwtPlot::updateCullingState( const QwtPlotItem *item )
+{
+    if ( d_data->isCullingIndexDirty )
+        return;
+
+    const bool doCull = 
+        item->testItemAttribute( QwtPlotItem::ViewportCulling );
+
+    QHash<const QwtPlotItem *, QwtCullingState>::const_iterator it =
+        d_data->cullingStates.constFind( item );
+
+    if ( it == d_data->cullingStates.constEnd() )
+    {
+        if ( doCull )
+            d_data->isCullingIndexDirty = true;
+
+        return;
+    }
+
+    if ( !doCull || it->xAxis != item->xAxis()
+        || it->margin != item->cullingMargin()
+        || it->rect != item->cullingRect() )
+    {
+        d_data->isCullingIndexDirty = true;
     }
 }
 
@@ -1102,6 +1507,9 @@ void QwtPlot::attachItem( QwtPlotItem *plotItem, bool on )
     else 
         removeItem( plotItem );
 
+    invalidateCullingIndex();
+    invalidateScrolling();
+
     Q_EMIT itemAttached( plotItem, on );
 
     if ( plotItem->testItemAttribute( QwtPlotItem::Legend ) )
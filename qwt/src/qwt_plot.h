@@ -281,6 +281,7 @@ Q_SIGNALS:
 
 public Q_SLOTS:
     virtual void replot();
+    void replotScrolled();
     void autoRefresh();
 
 protected:
@@ -295,6 +296,10 @@ private Q_SLOTS:
 private:
     friend class QwtPlotItem;
     void attachItem( QwtPlotItem *, bool );
+    void invalidateCullingIndex();
+    void updateCullingState( const QwtPlotItem * );
+    void updateCullingIndex() const;
+    void invalidateScrolling();
 
     void initAxesData();
     void deleteAxesData();
@@ -0,0 +1,766 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#include "qwt_plot_batch_renderer.h"
+#include "qwt_plot.h"
+#include "qwt_graphic.h"
+#include "qwt_text.h"
+#include <qpainter.h>
+#include <qimage.h>
+#include <qimagewriter.h>
+#include <qfileinfo.h>
+#include <qprinter.h>
+#include <qfile.h>
+#include <qdatastream.h>
+#include <qvector.h>
+#include <qlist.h>
+#include <qthread.h>
+#include <qfuture.h>
+#include <qtconcurrentrun.h>
+
+#ifndef QWT_NO_SVG
+#ifdef QT_SVG_LIB
+#if QT_VERSION >= 0x040500
+#define QWT_FORMAT_SVG 1
+#endif
+#endif
+#endif
+
+#ifndef QT_NO_PRINTER
+#define QWT_FORMAT_PDF 1
+#endif
+
+#ifndef QT_NO_PDF
+#if QT_VERSION >= 0x050300
+
+#ifndef QWT_FORMAT_PDF
+#define QWT_FORMAT_PDF 1
+#endif
+
+#define QWT_PDF_WRITER 1
+
+#endif
+#endif
+
+#ifndef QT_NO_PRINTER
+#if QT_VERSION < 0x050000
+#define QWT_FORMAT_POSTSCRIPT 1
+#endif
+#endif
+
+#if QWT_FORMAT_SVG
+#include <qsvggenerator.h>
+#endif
+
+#if QWT_PDF_WRITER
+#include <qpdfwriter.h>
+#endif
+
+// the graphic is recorded in points
+static const double qwtGraphicResolution = 72.0;
+
+namespace
+{
+    class Document
+    {
+    public:
+        QwtGraphic graphic;
+
+        QString fileName;
+        QString format;
+        QString title;
+
+        QSizeF sizeMM;
+        int resolution;
+    };
+}
+
+static inline QSizeF qwtDocumentSize( const QSizeF &sizeMM, double resolution )
+{
+    const double mmToInch = 1.0 / 25.4;
+    return sizeMM * mmToInch * resolution;
+}
+
+static void qwtRenderGraphic( QPainter *painter,
+    const QwtGraphic &graphic, int resolution )
+{
+    const double scaleFactor = resolution / qwtGraphicResolution;
+
+    painter->scale( scaleFactor, scaleFactor );
+    graphic.render( painter );
+}
+
+static bool qwtIsVectorFormat( const QString &format )
+{
+    const QString fmt = format.toLower();
+    return fmt == "pdf" || fmt == "ps" || fmt == "svg";
+}
+
+#if !defined(QT_NO_QFUTURE)
+
+static bool qwtCanRenderConcurrently( const QString &format )
+{
+    const QString fmt = format.toLower();
+
+    if ( fmt == "ps" )
+        return false;
+
+#if !QWT_PDF_WRITER
+    if ( fmt == "pdf" )
+        return false;
+#endif
+
+    return true;
+}
+
+#endif
+
+/*
+  Writing the document needs no plot widget and no font -
+  it can be done in any thread
+ */
+static bool qwtWriteDocument( const Document &document )
+{
+    const QSizeF size = qwtDocumentSize( 
+        document.sizeMM, document.resolution );
+
+    const QRectF documentRect( 0.0, 0.0, size.width(), size.height() );
+
+    const QString fmt = document.format.toLower();
+    if ( fmt == "pdf" )
+    {
+#if QWT_FORMAT_PDF
+
+#if QWT_PDF_WRITER
+        QPdfWriter pdfWriter( document.fileName );
+        pdfWriter.setPageSizeMM( document.sizeMM );
+        pdfWriter.setTitle( document.title );
+        pdfWriter.setPageMargins( QMarginsF() );
+        pdfWriter.setResolution( document.resolution ); 
+        
+        QPainter painter( &pdfWriter );
+        qwtRenderGraphic( &painter, document.graphic, document.resolution );
+#else
+        QPrinter printer;
+        printer.setOutputFormat( QPrinter::PdfFormat );
+        printer.setColorMode( QPrinter::Color );
+        printer.setFullPage( true );
+        printer.setPaperSize( document.sizeMM, QPrinter::Millimeter );
+        printer.setDocName( document.title );
+        printer.setOutputFileName( document.fileName );
+        printer.setResolution( document.resolution );
+
+        QPainter painter( &printer );
+        qwtRenderGraphic( &painter, document.graphic, document.resolution );
+#endif
+        return true;
+#endif
+    }
+    else if ( fmt == "ps" )
+    {
+#if QWT_FORMAT_POSTSCRIPT
+        QPrinter printer;
+        printer.setOutputFormat( QPrinter::PostScriptFormat );
+        printer.setColorMode( QPrinter::Color );
+        printer.setFullPage( true );
+        printer.setPaperSize( document.sizeMM, QPrinter::Millimeter );
+        printer.setDocName( document.title );
+        printer.setOutputFileName( document.fileName );
+        printer.setResolution( document.resolution );
+
+        QPainter painter( &printer );
+        qwtRenderGraphic( &painter, document.graphic, document.resolution );
+
+        return true;
+#endif
+    }
+    else if ( fmt == "svg" )
+    {
+#if QWT_FORMAT_SVG
+        QSvgGenerator generator;
+        generator.setTitle( document.title );
+        generator.setFileName( document.fileName );
+        generator.setResolution( document.resolution );
+        generator.setViewBox( documentRect );
+
+        QPainter painter( &generator );
+        qwtRenderGraphic( &painter, document.graphic, document.resolution );
+
+        return true;
+#endif
+    }
+    else
+    {
+        if ( QImageWriter::supportedImageFormats().indexOf(
+            document.format.toLatin1() ) >= 0 )
+        {
+            const QRect imageRect = documentRect.toRect();
+            const int dotsPerMeter = 
+                qRound( document.resolution * 1000.0 / 25.4 );
+
+            QImage image( imageRect.size(), QImage::Format_ARGB32 );
+            image.setDotsPerMeterX( dotsPerMeter );
+            image.setDotsPerMeterY( dotsPerMeter );
+            image.fill( QColor( Qt::white ).rgb() );
+
+            QPainter painter( &image );
+            qwtRenderGraphic( &painter, document.graphic, document.resolution );
+            painter.end();
+
+            return image.save( document.fileName, document.format.toLatin1() );
+        }
+    }
+
+    return false;
+}
+
+/*
+  A baseline TIFF ( uncompressed RGB ) writer, that accepts the image 
+  strip by strip, so that the complete image is never in memory
+ */
+class QwtTiffStripWriter
+{
+public:
+    QwtTiffStripWriter( const QString &fileName ):
+        d_file( fileName ),
+        d_width( 0 ),
+        d_height( 0 ),
+        d_rowsPerStrip( 0 ),
+        d_resolution( 0 )
+    {
+        d_stream.setByteOrder( QDataStream::LittleEndian );
+    }
+
+    bool open( const QSize &size, int rowsPerStrip, int resolution )
+    {
+        // classic TIFF files are limited to 4GB
+        const quint64 numBytes = quint64( size.width() ) * size.height() * 3;
+        if ( numBytes > Q_UINT64_C( 0xfff00000 ) )
+            return false;
+
+        if ( !d_file.open( QIODevice::WriteOnly | QIODevice::Truncate ) )
+            return false;
+
+        d_width = size.width();
+        d_height = size.height();
+        d_rowsPerStrip = rowsPerStrip;
+        d_resolution = resolution;
+
+        d_stream.setDevice( &d_file );
+
+        // header, the offset of the directory is patched in close()
+        d_stream << quint8( 'I' ) << quint8( 'I' ) 
+            << quint16( 42 ) << quint32( 0 );
+
+        return true;
+    }
+
+    void writeStrip( const QImage &strip )
+    {
+        QByteArray row( 3 * d_width, 0 );
+
+        d_offsets += quint32( d_file.pos() );
+        d_byteCounts += quint32( strip.height() * row.size() );
+
+        for ( int y = 0; y < strip.height(); y++ )
+        {
+            const QRgb *pixels = reinterpret_cast<const QRgb *>( 
+                strip.constScanLine( y ) );
+
+            char *bytes = row.data();
+            for ( int x = 0; x < d_width; x++ )
+            {
+                *bytes++ = char( qRed( pixels[x] ) );
+                *bytes++ = char( qGreen( pixels[x] ) );
+                *bytes++ = char( qBlue( pixels[x] ) );
+            }
+
+            d_stream.writeRawData( row.constData(), row.size() );
+        }
+    }
+
+    bool close()
+    {
+        if ( d_file.pos() % 2 )
+            d_stream << quint8( 0 );
+
+        const int numStrips = d_offsets.size();
+        const int numEntries = 13;
+
+        const quint32 ifdOffset = quint32( d_file.pos() );
+
+        // data, that doesn't fit into the entries follows the directory
+        quint32 dataOffset = ifdOffset + 2 + numEntries * 12 + 4;
+
+        const quint32 bitsOffset = dataOffset;
+        dataOffset += 3 * 2;
+
+        quint32 offsetsOffset = d_offsets[0];
+        quint32 byteCountsOffset = d_byteCounts[0];
+        if ( numStrips > 1 )
+        {
+            offsetsOffset = dataOffset;
+            dataOffset += 4 * numStrips;
+
+            byteCountsOffset = dataOffset;
+            dataOffset += 4 * numStrips;
+        }
+
+        const quint32 resolutionOffset = dataOffset;
+
+        d_stream << quint16( numEntries );
+
+        writeEntry( 256, 4, 1, d_width ); // ImageWidth
+        writeEntry( 257, 4, 1, d_height ); // ImageLength
+        writeEntry( 258, 3, 3, bitsOffset ); // BitsPerSample
+        writeEntry( 259, 3, 1, 1 ); // Compression: none
+        writeEntry( 262, 3, 1, 2 ); // PhotometricInterpretation: RGB
+        writeEntry( 273, 4, numStrips, offsetsOffset ); // StripOffsets
+        writeEntry( 277, 3, 1, 3 ); // SamplesPerPixel
+        writeEntry( 278, 4, 1, d_rowsPerStrip ); // RowsPerStrip
+        writeEntry( 279, 4, numStrips, byteCountsOffset ); // StripByteCounts
+        writeEntry( 282, 5, 1, resolutionOffset ); // XResolution
+        writeEntry( 283, 5, 1, resolutionOffset ); // YResolution
+        writeEntry( 284, 3, 1, 1 ); // PlanarConfiguration: chunky
+        writeEntry( 296, 3, 1, 2 ); // ResolutionUnit: inch
+
+        d_stream << quint32( 0 ); // no further directory
+
+        d_stream << quint16( 8 ) << quint16( 8 ) << quint16( 8 );
+
+        if ( numStrips > 1 )
+        {
+            for ( int i = 0; i < numStrips; i++ )
+                d_stream << d_offsets[i];
+
+            for ( int i = 0; i < numStrips; i++ )
+                d_stream << d_byteCounts[i];
+        }
+
+        d_stream << quint32( d_resolution ) << quint32( 1 );
+
+        d_file.seek( 4 );
+        d_stream << ifdOffset;
+
+        d_file.close();
+
+        return d_stream.status() == QDataStream::Ok;
+    }
+
+private:
+    void writeEntry( quint16 tag, quint16 type, 
+        quint32 count, quint32 value )
+    {
+        d_stream << tag << type << count;
+
+        if ( type == 3 && count == 1 )
+        {
+            // values are left justified
+            d_stream << quint16( value ) << quint16( 0 );
+        }
+        else
+        {
+            d_stream << value;
+        }
+    }
+
+    QFile d_file;
+    QDataStream d_stream;
+
+    int d_width;
+    int d_height;
+    int d_rowsPerStrip;
+    int d_resolution;
+
+    QVector<quint32> d_offsets;
+    QVector<quint32> d_byteCounts;
+};
+
+static QImage qwtRenderStrip( const QwtGraphic &graphic, 
+    int resolution, int width, int y, int height )
+{
+    QImage image( width, height, QImage::Format_RGB32 );
+    image.fill( QColor( Qt::white ).rgb() );
+
+    QPainter painter( &image );
+    painter.translate( 0.0, -y );
+
+    qwtRenderGraphic( &painter, graphic, resolution );
+
+    painter.end();
+
+    return image;
+}
+
+class QwtPlotBatchRenderer::PrivateData
+{
+public:
+    PrivateData():
+        ok( true ),
+        maxPendingDocuments( 2 * qMax( QThread::idealThreadCount(), 1 ) )
+    {
+    }
+
+#if !defined(QT_NO_QFUTURE)
+    void pruneFinished()
+    {
+        for ( int i = futures.size() - 1; i >= 0; i-- )
+        {
+            if ( futures[i].isFinished() )
+            {
+                if ( !futures[i].result() )
+                    ok = false;
+
+                futures.removeAt( i );
+            }
+        }
+    }
+
+    void waitForOldest()
+    {
+        if ( !futures.isEmpty() )
+        {
+            if ( !futures.takeFirst().result() )
+                ok = false;
+        }
+    }
+#endif
+
+    bool ok;
+    int maxPendingDocuments;
+
+#if !defined(QT_NO_QFUTURE)
+    QList< QFuture<bool> > futures;
+#endif
+};
+
+/*! 
+   Constructor
+   \param parent Parent object
+*/
+QwtPlotBatchRenderer::QwtPlotBatchRenderer( QObject *parent ):
+    QwtPlotRenderer( parent )
+{
+    d_data = new PrivateData;
+}
+
+/*!
+  Destructor
+
+  The destructor blocks until all pending documents have been written
+  \sa waitForFinished()
+ */
+QwtPlotBatchRenderer::~QwtPlotBatchRenderer()
+{
+    waitForFinished();
+    delete d_data;
+}
+
+/*!
+  \brief Render a plot into a graphic
+
+  The layout is calculated for a document of the given size - like
+  it is done in renderDocument() - and all components of the plot,
+  that are not discarded, are painted into a QwtGraphic. 
+  The coordinates of the graphic are in points ( 1/72 inch ).
+
+  \note A QwtGraphic is no vector device, so that the vectorFlags()
+        are not applied. enqueueDocument() renders vector documents
+        with vector flags without a graphic in the calling thread.
+
+  \param plot Plot widget
+  \param sizeMM Size of the document in millimeters.
+
+  \return Recorded graphic, that can be replayed in any thread
+  \sa enqueueDocument(), render()
+*/
+QwtGraphic QwtPlotBatchRenderer::toGraphic( 
+    QwtPlot *plot, const QSizeF &sizeMM ) const
+{
+    QwtGraphic graphic;
+
+    if ( plot == NULL || sizeMM.isEmpty() )
+        return graphic;
+
+    const QSizeF size = qwtDocumentSize( sizeMM, qwtGraphicResolution );
+
+    graphic.setDefaultSize( size );
+
+    QPainter painter( &graphic );
+    render( plot, &painter, QRectF( 0.0, 0.0, size.width(), size.height() ) );
+    painter.end();
+
+    return graphic;
+}
+
+/*!
+  \brief Queue a plot for being exported to a file
+
+  The format is derived from the suffix of the file name.
+
+  \param plot Plot widget
+  \param fileName Path of the file, where the document will be stored
+  \param sizeMM Size for the document in millimeters.
+  \param resolution Resolution in dots per Inch (dpi)
+
+  \sa renderDocument(), waitForFinished()
+*/
+void QwtPlotBatchRenderer::enqueueDocument( QwtPlot *plot, 
+    const QString &fileName, const QSizeF &sizeMM, int resolution )
+{
+    enqueueDocument( plot, fileName,
+        QFileInfo( fileName ).suffix(), sizeMM, resolution );
+}
+
+/*!
+  \brief Queue a plot for being exported to a file
+
+  The plot is painted into a graphic ( toGraphic() ) immediately, 
+  so that it can be modified for the next document, when this
+  method returns. The document itself is generated in a worker thread.
+
+  Vector documents ( PDF, PostScript, SVG ) with vectorFlags() are
+  rendered by renderDocument() in the calling thread, as the flags
+  can't be applied to a graphic.
+
+  \param plot Plot widget
+  \param fileName Path of the file, where the document will be stored
+  \param format Format for the document - see 
+                QwtPlotRenderer::renderDocument()
+  \param sizeMM Size for the document in millimeters.
+  \param resolution Resolution in dots per Inch (dpi)
+
+  \sa renderDocument(), waitForFinished()
+*/
+void QwtPlotBatchRenderer::enqueueDocument( QwtPlot *plot,
+    const QString &fileName, const QString &format,
+    const QSizeF &sizeMM, int resolution )
+{
+    if ( plot == NULL || sizeMM.isEmpty() || resolution <= 0 )
+        return;
+
+    if ( vectorFlags() != DefaultVector && qwtIsVectorFormat( format ) )
+    {
+        /*
+          The vector flags depend on the type of the target device,
+          that is unknown, when recording a graphic
+         */
+        renderDocument( plot, fileName, format, sizeMM, resolution );
+        return;
+    }
+
+    QString title = plot->title().text();
+    if ( title.isEmpty() )
+        title = "Plot Document";
+
+    enqueueDocument( toGraphic( plot, sizeMM ), 
+        fileName, format, sizeMM, resolution, title );
+}
+
+/*!
+  \brief Queue a graphic for being exported to a file
+
+  The graphic is expected in points ( 1/72 inch ) like it is
+  returned from toGraphic().
+
+  When maxPendingDocuments() documents are pending, the call blocks
+  until the oldest of them has been written.
+
+  \param graphic Graphic
+  \param fileName Path of the file, where the document will be stored
+  \param format Format for the document - see 
+                QwtPlotRenderer::renderDocument()
+  \param sizeMM Size for the document in millimeters.
+  \param resolution Resolution in dots per Inch (dpi)
+  \param title Title of the document
+
+  \sa toGraphic(), waitForFinished(), setMaxPendingDocuments()
+*/
+void QwtPlotBatchRenderer::enqueueDocument( const QwtGraphic &graphic,
+    const QString &fileName, const QString &format,
+    const QSizeF &sizeMM, int resolution, const QString &title )
+{
+    if ( sizeMM.isEmpty() || resolution <= 0 )
+        return;
+
+    Document document;
+    document.graphic = graphic;
+    document.fileName = fileName;
+    document.format = format;
+    document.title = title;
+    document.sizeMM = sizeMM;
+    document.resolution = resolution;
+
+#if !defined(QT_NO_QFUTURE)
+    if ( qwtCanRenderConcurrently( format ) )
+    {
+        d_data->pruneFinished();
+
+        // each pending document holds its graphic in memory
+        while ( d_data->futures.size() >= d_data->maxPendingDocuments )
+            d_data->waitForOldest();
+
+        d_data->futures += QtConcurrent::run( &qwtWriteDocument, document );
+        return;
+    }
+#endif
+
+    if ( !qwtWriteDocument( document ) )
+        d_data->ok = false;
+}
+
+/*!
+  \brief Set the maximum number of documents, that are written concurrently
+
+  Each pending document holds its graphic in memory. When the limit is
+  reached, enqueueDocument() blocks until the oldest pending document
+  has been written, so that the memory doesn't grow, when documents
+  are queued faster than they can be written.
+
+  The default setting is twice QThread::idealThreadCount().
+
+  \param numDocuments Maximum number of pending documents
+  \sa maxPendingDocuments(), pendingDocuments()
+ */
+void QwtPlotBatchRenderer::setMaxPendingDocuments( int numDocuments )
+{
+    d_data->maxPendingDocuments = qMax( numDocuments, 1 );
+}
+
+/*!
+  \return Maximum number of documents, that are written concurrently
+  \sa setMaxPendingDocuments(), pendingDocuments()
+ */
+int QwtPlotBatchRenderer::maxPendingDocuments() const
+{
+    return d_data->maxPendingDocuments;
+}
+
+/*!
+  \return Number of documents, that have been queued, but are
+          not written yet
+  \sa maxPendingDocuments()
+ */
+int QwtPlotBatchRenderer::pendingDocuments() const
+{
+    int count = 0;
+
+#if !defined(QT_NO_QFUTURE)
+    for ( int i = 0; i < d_data->futures.size(); i++ )
+    {
+        if ( !d_data->futures[i].isFinished() )
+            count++;
+    }
+#endif
+
+    return count;
+}
+
+/*!
+  \brief Block until all queued documents have been written
+
+  \return true, when all documents, that have been queued since the
+          last call of waitForFinished(), could be written
+ */
+bool QwtPlotBatchRenderer::waitForFinished()
+{
+    bool ok = d_data->ok;
+
+#if !defined(QT_NO_QFUTURE)
+    for ( int i = 0; i < d_data->futures.size(); i++ )
+    {
+        d_data->futures[i].waitForFinished();
+        if ( !d_data->futures[i].result() )
+            ok = false;
+    }
+
+    d_data->futures.clear();
+#endif
+
+    d_data->ok = true;
+
+    return ok;
+}
+
+/*!
+  \brief Render a plot to a huge image in strips
+
+  Poster size images ( f.e. 40000x20000 pixels ) might exceed the 
+  available memory, when being allocated as one QImage. 
+  renderTiledImage() paints the plot into a graphic ( toGraphic() )
+  and replays it to horizontal strips, that are rendered in parallel
+  and written to the file in order. The peak memory is one strip
+  for each thread.
+
+  The image is written as uncompressed TIFF, what is the only
+  format, that can be written strip by strip without encoding
+  the complete image at once.
+
+  \param plot Plot widget
+  \param fileName Path of the file, where the image will be stored
+  \param size Size of the image in pixels
+  \param resolution Resolution in dots per Inch (dpi)
+  \param stripHeight Number of rows, that are rendered at once
+
+  \return true, when the image could be written
+  \sa toGraphic(), QwtPlotRenderer::renderDocument()
+*/
+bool QwtPlotBatchRenderer::renderTiledImage( QwtPlot *plot, 
+    const QString &fileName, const QSize &size, 
+    int resolution, int stripHeight )
+{
+    if ( plot == NULL || size.isEmpty() || resolution <= 0 )
+        return false;
+
+    stripHeight = qBound( 1, stripHeight, size.height() );
+
+    const QSizeF sizeMM = QSizeF( size ) * 25.4 / resolution;
+    const QwtGraphic graphic = toGraphic( plot, sizeMM );
+
+    QwtTiffStripWriter writer( fileName );
+    if ( !writer.open( size, stripHeight, resolution ) )
+        return false;
+
+    const int numStrips = ( size.height() - 1 ) / stripHeight + 1;
+
+    int numThreads = 1;
+#if !defined(QT_NO_QFUTURE)
+    numThreads = qMax( QThread::idealThreadCount(), 1 );
+#endif
+
+    for ( int strip = 0; strip < numStrips; strip += numThreads )
+    {
+        const int n = qMin( numThreads, numStrips - strip );
+
+#if !defined(QT_NO_QFUTURE)
+        QList< QFuture<QImage> > futures;
+        for ( int i = 0; i < n - 1; i++ )
+        {
+            const int y = ( strip + i ) * stripHeight;
+
+            futures += QtConcurrent::run( &qwtRenderStrip, graphic, 
+                resolution, size.width(), y, stripHeight );
+        }
+#endif
+
+        const int y = ( strip + n - 1 ) * stripHeight;
+
+        const QImage lastStrip = qwtRenderStrip( graphic, resolution, 
+            size.width(), y, qMin( stripHeight, size.height() - y ) );
+
+#if !defined(QT_NO_QFUTURE)
+        for ( int i = 0; i < futures.size(); i++ )
+            writer.writeStrip( futures[i].result() );
+#endif
+
+        writer.writeStrip( lastStrip );
+    }
+
+    return writer.close();
+}
@@ -0,0 +1,111 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#ifndef QWT_PLOT_BATCH_RENDERER_H
+#define QWT_PLOT_BATCH_RENDERER_H
+
+#include "qwt_global.h"
+#include "qwt_plot_renderer.h"
+
+class QwtGraphic;
+
+/*!
+  \brief Renderer for exporting many plots to documents in the background
+
+  QwtPlotRenderer::renderDocument() does all the work on the calling 
+  thread: calculating the layout, painting the items, rasterizing
+  the paths and glyphs and finally encoding the document.
+  For applications exporting thousands of charts - f.e. nightly 
+  generated reports - the GUI thread is blocked for a long time, 
+  while all other cores are idle.
+
+  QwtPlotBatchRenderer splits the export into 2 steps:
+
+  - The layout is calculated and the plot is painted into a 
+    QwtGraphic. Texts are converted into paths, so that 
+    no font is needed later. This step has to be done in the thread
+    of the plot widget, but it is cheap compared to the second step.
+
+  - The graphic is replayed to the target document ( image, PDF, SVG ),
+    that is encoded and written to disk. This step runs in a
+    thread of QThreadPool::globalInstance(), so that many documents 
+    are generated concurrently.
+
+  The number of documents, that are written at the same time, is
+  limited by maxPendingDocuments(). When the limit is reached,
+  enqueueDocument() blocks until the oldest document has been written.
+
+  As the plot is not needed after the first step, the same plot
+  widget can be reused for the next chart immediately. QwtPlotLayout
+  keeps the results of its recent calculations, so that the layout is
+  not calculated again for charts of the same size, when titles, fonts
+  and the extents of the scales are the same.
+
+  \code
+QwtPlotBatchRenderer renderer;
+
+for ( int i = 0; i < reports.size(); i++ )
+{
+    updatePlot( plot, reports[i] );
+    renderer.enqueueDocument( plot, reports[i].fileName, QSizeF( 300, 200 ) );
+}
+
+renderer.waitForFinished();
+  \endcode
+
+  Documents can also be generated from a QwtGraphic directly, that 
+  might have been created without any plot widget in any thread - 
+  f.e. by painting plot items with QwtPlotItem::draw().
+
+  For images, that are too large for being allocated at once,
+  renderTiledImage() renders and writes the image in strips.
+
+  \note Postscript and PDF documents without QPdfWriter ( Qt < 5.3 )
+        need a QPrinter, that is not supported in worker threads.
+        These documents are generated in the calling thread.
+
+  \sa QwtPlotRenderer::renderDocument()
+*/
+class QWT_EXPORT QwtPlotBatchRenderer: public QwtPlotRenderer
+{
+    Q_OBJECT
+
+public:
+    explicit QwtPlotBatchRenderer( QObject * = NULL );
+    virtual ~QwtPlotBatchRenderer();
+
+    QwtGraphic toGraphic( QwtPlot *, const QSizeF &sizeMM ) const;
+
+    void enqueueDocument( QwtPlot *, const QString &fileName,
+        const QSizeF &sizeMM, int resolution = 85 );
+
+    void enqueueDocument( QwtPlot *,
+        const QString &fileName, const QString &format,
+        const QSizeF &sizeMM, int resolution = 85 );
+
+    void enqueueDocument( const QwtGraphic &,
+        const QString &fileName, const QString &format,
+        const QSizeF &sizeMM, int resolution = 85,
+        const QString &title = QString() );
+
+    void setMaxPendingDocuments( int numDocuments );
+    int maxPendingDocuments() const;
+
+    int pendingDocuments() const;
+    bool waitForFinished();
+
+    bool renderTiledImage( QwtPlot *, const QString &fileName,
+        const QSize &size, int resolution = 85, int stripHeight = 256 );
+
+private:
+    class PrivateData;
+    PrivateData *d_data;
+};
+
+#endif
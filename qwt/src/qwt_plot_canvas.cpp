@@ -11,6 +11,7 @@
 #include "qwt_painter.h"
 #include "qwt_math.h"
 #include "qwt_plot.h"
+#include "qwt_scale_map.h"
 
 #ifndef QWT_NO_OPENGL
 
@@ -51,6 +52,45 @@ typedef QGLWidget QwtPlotCanvasSurfaceGL;
 #include <qpaintengine.h>
 #include <qevent.h>
 
+static bool qwtScrollOffset( const QwtScaleMap &oldMap,
+    const QwtScaleMap &newMap, double &offset )
+{
+    if ( oldMap.p1() != newMap.p1() || oldMap.p2() != newMap.p2() )
+        return false;
+
+    // the new scale interval needs to be the old one shifted
+    // by the same distance in paint device coordinates
+
+    const double d1 = oldMap.transform( newMap.s1() ) - oldMap.p1();
+    const double d2 = oldMap.transform( newMap.s2() ) - oldMap.p2();
+
+    const double pm = 0.5 * ( newMap.p1() + newMap.p2() );
+    const double dm = oldMap.transform( newMap.invTransform( pm ) ) - pm;
+
+    const double tolerance = 1e-3;
+    if ( !( qAbs( d2 - d1 ) < tolerance && qAbs( dm - d1 ) < tolerance ) )
+        return false;
+
+    offset = -d1;
+    return true;
+}
+
+static bool qwtHasCanvasAlignedItems( const QwtPlot *plot )
+{
+    const QwtPlotItemList &items = plot->itemList();
+    for ( QwtPlotItemIterator it = items.begin(); it != items.end(); ++it )
+    {
+        const QwtPlotItem *item = *it;
+        if ( item->isVisible() 
+            && item->testItemAttribute( QwtPlotItem::CanvasAligned ) )
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 class QwtPlotCanvas::PrivateData
 {
 public:
@@ -59,7 +99,8 @@ public:
 #ifndef QWT_NO_OPENGL
         surfaceGL( NULL ),
 #endif
-        backingStore( NULL )
+        backingStore( NULL ),
+        hasScrollMaps( false )
     {
     }
 
@@ -79,6 +120,10 @@ public:
 #endif
 
     QPixmap *backingStore;
+
+    // maps, that correspond to the content of the backing store
+    QwtScaleMap scrollMaps[QwtPlot::axisCnt];
+    bool hasScrollMaps;
 };
 
 /*! 
@@ -265,6 +310,9 @@ void QwtPlotCanvas::paintEvent( QPaintEvent *event )
                 if ( frameWidth() > 0 )
                     drawBorder( &p );
             }
+
+            if ( testPaintAttribute( ScrollBackingStore ) )
+                updateScrollMaps();
         }
 
         painter.drawPixmap( 0, 0, *d_data->backingStore );
@@ -359,7 +407,7 @@ void QwtPlotCanvas::resizeEvent( QResizeEvent *event )
 
 /*!
    Invalidate the paint cache and repaint the canvas
-   \sa invalidatePaintCache()
+   \sa invalidatePaintCache(), replotScrolled()
 */
 void QwtPlotCanvas::replot()
 {
@@ -371,6 +419,167 @@ void QwtPlotCanvas::replot()
         update( contentsRect() );
 }
 
+/*!
+   Repaint the canvas after the scales have been scrolled
+
+   When ScrollBackingStore is enabled, the scale maps have been shifted 
+   by full pixels and no item has been changed since the backing store 
+   has been painted, the content of the backing store is shifted and only
+   the newly exposed area is painted. Otherwise the canvas is
+   replotted completely.
+
+   \sa replot(), ScrollBackingStore, QwtPlot::replotScrolled()
+*/
+void QwtPlotCanvas::replotScrolled()
+{
+    bool isScrolled = false;
+    if ( testPaintAttribute( QwtPlotCanvas::ScrollBackingStore ) )
+        isScrolled = scrollBackingStore();
+
+    if ( !isScrolled )
+        invalidateBackingStore();
+
+    if ( testPaintAttribute( QwtPlotCanvas::ImmediatePaint ) )
+        repaint( contentsRect() );
+    else
+        update( contentsRect() );
+}
+
+/*!
+  Remember the maps of the content of the backing store
+  \sa ScrollBackingStore
+ */
+void QwtPlotCanvas::updateScrollMaps()
+{
+    const QwtPlot *plot = qobject_cast<const QwtPlot *>( parent() );
+    if ( plot )
+    {
+        for ( int axisId = 0; axisId < QwtPlot::axisCnt; axisId++ )
+            d_data->scrollMaps[axisId] = plot->canvasMap( axisId );
+    }
+
+    d_data->hasScrollMaps = ( plot != NULL );
+}
+
+/*!
+  Forget the maps of the content of the backing store, so that
+  the next replotScrolled() repaints the complete canvas.
+
+  \sa QwtPlotItem::itemChanged()
+ */
+void QwtPlotCanvas::invalidateScrollMaps()
+{
+    d_data->hasScrollMaps = false;
+}
+
+/*!
+  Scroll the backing store according to the difference between
+  the current scale maps and those of the content of the backing store.
+
+  \return true, when the backing store could be scrolled
+  \sa ScrollBackingStore
+ */
+bool QwtPlotCanvas::scrollBackingStore()
+{
+    QwtPlot *plot = qobject_cast<QwtPlot *>( parent() );
+
+    QPixmap *bs = d_data->backingStore;
+
+    if ( plot == NULL || bs == NULL || bs->isNull() 
+        || !d_data->hasScrollMaps )
+    {
+        return false;
+    }
+
+    if ( testAttribute( Qt::WA_StyledBackground ) || borderRadius() > 0.0
+        || testPaintAttribute( QwtPlotCanvas::OpenGLBuffer ) )
+    {
+        return false;
+    }
+
+    if ( QwtPainter::devicePixelRatio( bs ) != 1.0 || bs->size() != size() )
+        return false;
+
+    if ( qwtHasCanvasAlignedItems( plot ) )
+        return false;
+
+    const QRect cr = contentsRect();
+
+    int delta[2] = { 0, 0 }; // x, y
+    bool hasDelta[2] = { false, false };
+
+    QwtScaleMap maps[QwtPlot::axisCnt];
+    for ( int axisId = 0; axisId < QwtPlot::axisCnt; axisId++ )
+    {
+        maps[axisId] = plot->canvasMap( axisId );
+
+        // axes without items don't need to be in sync
+
+        if ( plot->axisItemList( axisId ).isEmpty() )
+            continue;
+
+        double offset = 0.0;
+        if ( !qwtScrollOffset( d_data->scrollMaps[axisId], 
+            maps[axisId], offset ) )
+        {
+            return false;
+        }
+
+        // the content can be reused for shifts by full pixels only
+
+        const int d = qRound( offset );
+        if ( qAbs( offset - d ) > 1e-3 )
+            return false;
+
+        const int index = 
+            ( axisId == QwtPlot::xBottom || axisId == QwtPlot::xTop ) ? 0 : 1;
+
+        if ( hasDelta[index] && delta[index] != d )
+            return false;
+
+        delta[index] = d;
+        hasDelta[index] = true;
+    }
+
+    const int dx = delta[0];
+    const int dy = delta[1];
+
+    if ( dx == 0 && dy == 0 )
+    {
+        // nothing has been scrolled: something else must have changed
+        return false;
+    }
+
+    if ( qAbs( dx ) >= cr.width() || qAbs( dy ) >= cr.height() )
+        return false;
+
+    QRegion exposed;
+    bs->scroll( dx, dy, cr, &exposed );
+
+    exposed &= cr;
+
+    QPainter painter( bs );
+
+    const QVector<QRect> rects = exposed.rects();
+    for ( int i = 0; i < rects.size(); i++ )
+    {
+        const QRect &r = rects[i];
+
+        QPixmap pm( r.size() );
+        QwtPainter::fillPixmap( this, pm, r.topLeft() );
+
+        painter.drawPixmap( r.topLeft(), pm );
+    }
+
+    painter.setClipRegion( exposed );
+    plot->drawItems( &painter, cr, maps );
+
+    for ( int axisId = 0; axisId < QwtPlot::axisCnt; axisId++ )
+        d_data->scrollMaps[axisId] = maps[axisId];
+
+    return true;
+}
+
 /*!
    Calculate the painter path for a styled or rounded border
 
@@ -119,7 +119,35 @@ public:
 
           \sa QwtPlotOpenGLCanvas, QwtPlotGLCanvas
          */
-        OpenGLBuffer = 16
+        OpenGLBuffer = 16,
+
+        /*!
+          \brief Reuse the backing store, when the scales have been scrolled
+
+          When the scale intervals of the previous and the current replot 
+          differ by a shift of full pixels only - like for a strip chart,
+          where the x axis scrolls a few pixels per frame - replotScrolled()
+          scrolls the content of the backing store and paints the 
+          newly exposed strip only. replot() always repaints the
+          complete canvas.
+
+          Changing or attaching items ( QwtPlotItem::itemChanged() )
+          results in a complete repaint. When the application modifies
+          the data of an item without notifying the item, it has
+          to guarantee, that the content of the area, that had been 
+          visible before, doesn't change.
+
+          Scrolling is done for canvases without styled backgrounds
+          and rounded borders, when the device pixel ratio is 1 and 
+          no items are attached, that are aligned to the canvas 
+          ( QwtPlotItem::CanvasAligned, f.e. QwtPlotTextLabel, 
+          QwtPlotLegendItem ). Otherwise the complete canvas is repainted.
+
+          \note ScrollBackingStore has no effect without BackingStore
+          \sa replotScrolled(), QwtPlot::replotScrolled(), 
+              QwtPlotPanner, backingStore()
+         */
+        ScrollBackingStore = 32
     };
 
     //! Paint attributes
@@ -140,6 +168,7 @@ public:
 
 public Q_SLOTS:
     void replot();
+    void replotScrolled();
 
 protected:
     virtual void paintEvent( QPaintEvent * );
@@ -150,6 +179,12 @@ protected:
 private:
     QImage toImageFBO( const QSize &size );
 
+    friend class QwtPlot;
+
+    bool scrollBackingStore();
+    void updateScrollMaps();
+    void invalidateScrollMaps();
+
     class PrivateData;
     PrivateData *d_data;
 };
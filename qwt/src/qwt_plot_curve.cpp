@@ -17,8 +17,10 @@
 #include "qwt_spline_curve_fitter.h"
 #include "qwt_symbol.h"
 #include "qwt_point_mapper.h"
+#include "qwt_scratch_arena.h"
 #include <qpainter.h>
 #include <qpixmap.h>
+#include <qimage.h>
 #include <qalgorithms.h>
 #include <qmath.h>
 
@@ -38,6 +40,323 @@ static inline QRectF qwtIntersectedClipRect( const QRectF &rect, QPainter *paint
     return clipRect;
 }
 
+/*
+  Replace each run of more than 4 points on the same vertical
+  ( or horizontal ) line by its first point, the extreme points
+  and its last point. The other points are hidden by the lines 
+  between the extreme points.
+ */
+static int qwtMergeRuns( QPointF *points, int numPoints, 
+    Qt::Orientation orientation )
+{
+    const bool vertical = ( orientation == Qt::Vertical );
+
+    int numMerged = 0;
+
+    int i = 0;
+    while ( i < numPoints )
+    {
+        const double value = vertical ? points[i].x() : points[i].y();
+
+        int j = i;
+        while ( j + 1 < numPoints )
+        {
+            const QPointF &p = points[j + 1];
+            if ( ( vertical ? p.x() : p.y() ) != value )
+                break;
+
+            j++;
+        }
+
+        if ( j - i < 4 )
+        {
+            for ( int k = i; k <= j; k++ )
+                points[numMerged++] = points[k];
+        }
+        else
+        {
+            int iMin = i;
+            int iMax = i;
+
+            for ( int k = i + 1; k <= j; k++ )
+            {
+                const double v = vertical ? points[k].y() : points[k].x();
+
+                if ( v < ( vertical ? points[iMin].y() : points[iMin].x() ) )
+                    iMin = k;
+
+                if ( v > ( vertical ? points[iMax].y() : points[iMax].x() ) )
+                    iMax = k;
+            }
+
+            const QPointF first = points[i];
+            const QPointF p1 = points[qMin( iMin, iMax )];
+            const QPointF p2 = points[qMax( iMin, iMax )];
+            const QPointF last = points[j];
+
+            points[numMerged++] = first;
+            points[numMerged++] = p1;
+            points[numMerged++] = p2;
+            points[numMerged++] = last;
+        }
+
+        i = j + 1;
+    }
+
+    return numMerged;
+}
+
+static inline double qwtPosition( const QPointF &p, bool transposed )
+{
+    return transposed ? p.y() : p.x();
+}
+
+static inline double qwtValue( const QPointF &p, bool transposed )
+{
+    return transposed ? p.x() : p.y();
+}
+
+static bool qwtIsMonotonic( const QPointF *points, int numPoints, bool transposed )
+{
+    int direction = 0;
+
+    for ( int i = 1; i < numPoints; i++ )
+    {
+        const double d = qwtPosition( points[i], transposed ) 
+            - qwtPosition( points[i-1], transposed );
+
+        if ( d > 0.0 )
+        {
+            if ( direction < 0 )
+                return false;
+
+            direction = 1;
+        }
+        else if ( d < 0.0 )
+        {
+            if ( direction > 0 )
+                return false;
+
+            direction = -1;
+        }
+    }
+
+    return true;
+}
+
+static int qwtNumPointsInside( const QPointF *points, int numPoints, 
+    bool transposed, double min, double max )
+{
+    int count = 0;
+
+    for ( int i = 0; i < numPoints; i++ )
+    {
+        const double pos = qwtPosition( points[i], transposed );
+        if ( pos >= min && pos <= max )
+            count++;
+    }
+
+    return count;
+}
+
+/*
+  Fill the area between a monotonic polyline and the baseline
+  by one rectangle for each pixel column ( or row ), spanning 
+  the envelope of the polyline and the baseline in this column.
+
+  For a non antialiased raster device this is approximately the
+  area the closed polygon would cover: each column is filled over
+  the full range of the segments passing it, while the rasterizer
+  samples at the pixel centres. But it avoids the expensive
+  rasterisation of polygons with millions of points.
+  With antialiasing the edges would be different and the
+  polygon has to be painted.
+
+  The rectangles are clipped to clipRect in both directions - like
+  the polygon for ClipPolygons - so that no huge coordinates are
+  passed to the raster paint engine.
+ */
+static bool qwtFillEnvelope( QPainter *painter, const QRectF &clipRect,
+    const QPolygonF &polygon, Qt::Orientation orientation )
+{
+    // the polygon has already been closed by closePolyline
+
+    const int numPoints = polygon.size() - 2;
+    const QPointF *points = polygon.constData();
+
+    const bool transposed = ( orientation == Qt::Horizontal );
+    const double baseline = qwtValue( polygon.last(), transposed );
+
+    const double pos1 = qwtPosition( points[0], transposed );
+    const double pos2 = qwtPosition( points[numPoints - 1], transposed );
+
+    const double clipMin = transposed ? clipRect.top() : clipRect.left();
+    const double clipMax = transposed ? clipRect.bottom() : clipRect.right();
+
+    const double clipValueMin = transposed ? clipRect.left() : clipRect.top();
+    const double clipValueMax = transposed ? clipRect.right() : clipRect.bottom();
+
+    const int from = qMax( qFloor( qMin( pos1, pos2 ) ), qFloor( clipMin ) );
+    const int to = qMin( qFloor( qMax( pos1, pos2 ) ), qCeil( clipMax ) );
+
+    const int numColumns = to - from + 1;
+
+    /*
+      With less than 2 points per column the polygon is cheap
+      to rasterize.
+     */
+
+    if ( numColumns <= 0 || numPoints < 2 * numColumns )
+        return false;
+
+    // only the points inside of the clip rectangle are painted
+
+    const int numVisible = qwtNumPointsInside( points, numPoints, 
+        transposed, from, to + 1 );
+
+    if ( numVisible < 2 * numColumns )
+        return false;
+
+    if ( !qwtIsMonotonic( points, numPoints, transposed ) )
+        return false;
+
+    QwtScratchArena *arena = QwtScratchArena::instance();
+
+    size_t envelopeCapacity = 0;
+    double *envelope = static_cast<double *>( arena->acquireMemory(
+        2 * numColumns * sizeof( double ), envelopeCapacity ) );
+
+    double *minValues = envelope;
+    double *maxValues = envelope + numColumns;
+
+    for ( int i = 0; i < numColumns; i++ )
+    {
+        minValues[i] = maxValues[i] = baseline;
+    }
+
+    for ( int i = 1; i < numPoints; i++ )
+    {
+        double p1 = qwtPosition( points[i-1], transposed );
+        double v1 = qwtValue( points[i-1], transposed );
+        double p2 = qwtPosition( points[i], transposed );
+        double v2 = qwtValue( points[i], transposed );
+
+        if ( p1 > p2 )
+        {
+            qSwap( p1, p2 );
+            qSwap( v1, v2 );
+        }
+
+        const int c1 = qMax( qFloor( p1 ), from );
+        const int c2 = qMin( qFloor( p2 ), to );
+
+        for ( int c = c1; c <= c2; c++ )
+        {
+            // the part of the segment inside of the column
+
+            double va = v1;
+            double vb = v2;
+
+            if ( p2 > p1 )
+            {
+                const double m = ( v2 - v1 ) / ( p2 - p1 );
+
+                if ( c > p1 )
+                    va = v1 + m * ( c - p1 );
+
+                if ( c + 1 < p2 )
+                    vb = v1 + m * ( c + 1 - p1 );
+            }
+
+            const int index = c - from;
+
+            minValues[index] = qMin( minValues[index], qMin( va, vb ) );
+            maxValues[index] = qMax( maxValues[index], qMax( va, vb ) );
+        }
+    }
+
+    size_t rectsCapacity = 0;
+    QRectF *rects = static_cast<QRectF *>( arena->acquireMemory(
+        numColumns * sizeof( QRectF ), rectsCapacity ) );
+
+    int numRects = 0;
+
+    for ( int i = 0; i < numColumns; i++ )
+    {
+        minValues[i] = qBound( clipValueMin, minValues[i], clipValueMax );
+        maxValues[i] = qBound( clipValueMin, maxValues[i], clipValueMax );
+    }
+
+    for ( int i = 0; i < numColumns; )
+    {
+        // neighboured columns with the same envelope are joined
+
+        int j = i + 1;
+        while ( j < numColumns && minValues[j] == minValues[i] 
+            && maxValues[j] == maxValues[i] )
+        {
+            j++;
+        }
+
+        if ( maxValues[i] > minValues[i] )
+        {
+            const double pos = from + i;
+            const double length = j - i;
+            const double size = maxValues[i] - minValues[i];
+
+            if ( transposed )
+                rects[numRects++] = QRectF( minValues[i], pos, size, length );
+            else
+                rects[numRects++] = QRectF( pos, minValues[i], length, size );
+        }
+
+        i = j;
+    }
+
+    QwtPainter::drawRects( painter, rects, numRects );
+
+    arena->releaseMemory( rects, rectsCapacity );
+    arena->releaseMemory( envelope, envelopeCapacity );
+
+    return true;
+}
+
+/*
+  Map the points into the coordinates of the paint device, where 
+  the mapper can round and weed them out - and translate the result
+  back into the coordinate system of the painter.
+ */
+static QPolygonF qwtToDevicePolygonF( const QTransform &transform,
+    const QwtPointMapper &mapper, const QwtScaleMap &xMap, 
+    const QwtScaleMap &yMap, const QwtSeriesData<QPointF> *series, 
+    int from, int to )
+{
+    const double sx = transform.m11();
+    const double sy = transform.m22();
+    const double dx = transform.dx();
+    const double dy = transform.dy();
+
+    QwtScaleMap deviceXMap = xMap;
+    deviceXMap.setPaintInterval( 
+        sx * xMap.p1() + dx, sx * xMap.p2() + dx );
+
+    QwtScaleMap deviceYMap = yMap;
+    deviceYMap.setPaintInterval( 
+        sy * yMap.p1() + dy, sy * yMap.p2() + dy );
+
+    QPolygonF polyline = mapper.toPolygonF( 
+        deviceXMap, deviceYMap, series, from, to );
+
+    QPointF *points = polyline.data();
+    for ( int i = 0; i < polyline.size(); i++ )
+    {
+        points[i].rx() = ( points[i].x() - dx ) / sx;
+        points[i].ry() = ( points[i].y() - dy ) / sy;
+    }
+
+    return polyline;
+}
+
 static void qwtUpdateLegendIconSize( QwtPlotCurve *curve )
 {
     if ( curve->symbol() && 
@@ -359,6 +678,10 @@ const QBrush& QwtPlotCurve::brush() const
   \param to Index of the last point to be painted. If to < 0 the
          curve will be painted to its last point.
 
+  \note When the curve has more points than requested by
+        QwtPainter::rasterThreshold() for the painter, it is
+        painted by drawRasterized().
+
   \sa drawCurve(), drawSymbols(),
 */
 void QwtPlotCurve::drawSeries( QPainter *painter,
@@ -375,6 +698,13 @@ void QwtPlotCurve::drawSeries( QPainter *painter,
 
     if ( qwtVerifyRange( numSamples, from, to ) > 0 )
     {
+        const int rasterThreshold = QwtPainter::rasterThreshold( painter );
+        if ( rasterThreshold >= 0 && numSamples > size_t( rasterThreshold ) )
+        {
+            drawRasterized( painter, xMap, yMap, canvasRect, from, to );
+            return;
+        }
+
         painter->save();
         painter->setPen( d_data->pen );
 
@@ -398,6 +728,52 @@ void QwtPlotCurve::drawSeries( QPainter *painter,
     }
 }
 
+/*!
+  \brief Draw an interval of the curve to an image
+
+  The image has the resolution of the paint device and is painted
+  instead of the points, what is requested for dense curves on vector 
+  devices by QwtPainter::setRasterThreshold().
+
+  \param painter Painter
+  \param xMap Maps x-values into pixel coordinates.
+  \param yMap Maps y-values into pixel coordinates.
+  \param canvasRect Contents rectangle of the canvas
+  \param from Index of the first point to be painted
+  \param to Index of the last point to be painted
+
+  \sa drawSeries(), QwtPlotRenderer::RasterizeDenseItems
+*/
+void QwtPlotCurve::drawRasterized( QPainter *painter,
+    const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+    const QRectF &canvasRect, int from, int to ) const
+{
+    const QTransform transform = painter->transform();
+
+    const QRect imageRect = transform.mapRect( canvasRect ).toAlignedRect();
+    if ( imageRect.isEmpty() )
+        return;
+
+    QImage image( imageRect.size(), QImage::Format_ARGB32_Premultiplied );
+    image.fill( 0 );
+
+    QPainter imagePainter( &image );
+    imagePainter.setRenderHints( painter->renderHints() );
+    imagePainter.translate( -imageRect.topLeft() );
+    imagePainter.setTransform( transform, true );
+    imagePainter.setClipRect( canvasRect );
+
+    // the image painter is not registered, so we don't end up here again
+    drawSeries( &imagePainter, xMap, yMap, canvasRect, from, to );
+
+    imagePainter.end();
+
+    painter->save();
+    painter->resetTransform();
+    painter->drawImage( imageRect.topLeft(), image );
+    painter->restore();
+}
+
 /*!
   \brief Draw the line part (without symbols) of a curve interval.
   \param painter Painter
@@ -469,7 +845,7 @@ void QwtPlotCurve::drawLines( QPainter *painter,
             && ( d_data->brush.color().alpha() > 0 );
 
     QRectF clipRect;
-    if ( d_data->paintAttributes & ClipPolygons )
+    if ( ( d_data->paintAttributes & ClipPolygons ) || doFit )
     {
         clipRect = qwtIntersectedClipRect( canvasRect, painter );
 
@@ -496,6 +872,16 @@ void QwtPlotCurve::drawLines( QPainter *painter,
     }
 #endif
 
+    /*
+      On devices with floating point coordinates ( PDF, SVG ) the 
+      points are reduced in the resolution of the device, when
+      the painter asks for it ( QwtPlotRenderer::DecimatePoints ).
+     */
+    const bool doDecimate = !doFit && !doAlign && !doIntegers
+        && QwtPainter::isDecimating( painter )
+        && painter->transform().isInvertible()
+        && !painter->transform().isRotating();
+
     QwtPointMapper mapper;
 
     if ( doAlign )
@@ -504,13 +890,23 @@ void QwtPlotCurve::drawLines( QPainter *painter,
         mapper.setFlag( QwtPointMapper::WeedOutIntermediatePoints, 
             testPaintAttribute( FilterPointsAggressive ) );
     }
+    else if ( doDecimate )
+    {
+        mapper.setFlag( QwtPointMapper::RoundPoints, true );
+        mapper.setFlag( QwtPointMapper::WeedOutIntermediatePoints, true );
+    }
 
-    mapper.setFlag( QwtPointMapper::WeedOutPoints, 
+    mapper.setFlag( QwtPointMapper::WeedOutPoints, doDecimate ||
         testPaintAttribute( FilterPoints ) || 
         testPaintAttribute( FilterPointsAggressive ) );
 
     mapper.setBoundingRect( canvasRect );
 
+    // all polygons of the mapper are passed back to the arena below
+    mapper.setFlag( QwtPointMapper::ScratchBuffers, true );
+
+    QwtScratchArena *arena = QwtScratchArena::instance();
+
     if ( doIntegers )
     {
         QPolygon polyline = mapper.toPolygon( 
@@ -518,15 +914,58 @@ void QwtPlotCurve::drawLines( QPainter *painter,
 
         if ( testPaintAttribute( ClipPolygons ) )
         {
-            polyline = QwtClipper::clipPolygon( 
+            const QPolygon clipped = QwtClipper::clipPolygon( 
                 clipRect.toAlignedRect(), polyline, false );
+
+            arena->release( polyline );
+            polyline = clipped;
         }
 
         QwtPainter::drawPolyline( painter, polyline );
+        arena->release( polyline );
+    }
+    else if ( !doFit && testPaintAttribute( ClipPolygons ) 
+        && !mapper.testFlag( QwtPointMapper::WeedOutIntermediatePoints ) )
+    {
+        // mapping, clipping and weeding in one pass into
+        // a buffer, that is reused for each paint operation
+
+        QPolygonF polyline;
+        arena->acquire( to - from + 1, polyline );
+
+        mapper.toPolylineF( xMap, yMap, data(), from, to, 
+            clipRect, polyline );
+
+        if ( doFill )
+        {
+            // 2 extra points for closing the polygon
+            QPolygonF filled;
+            arena->acquire( polyline.size() + 2, filled );
+
+            filled.resize( polyline.size() );
+            qCopy( polyline.constBegin(), polyline.constEnd(), filled.begin() );
+
+            fillCurve( painter, xMap, yMap, canvasRect, filled );
+            arena->release( filled );
+        }
+
+        if ( !doFill || painter->pen().style() != Qt::NoPen )
+            QwtPainter::drawPolyline( painter, polyline );
+
+        arena->release( polyline );
     }
     else
     {
-        QPolygonF polyline = mapper.toPolygonF( xMap, yMap, data(), from, to );
+        QPolygonF polyline;
+        if ( doDecimate )
+        {
+            polyline = qwtToDevicePolygonF( painter->transform(),
+                mapper, xMap, yMap, data(), from, to );
+        }
+        else
+        {
+            polyline = mapper.toPolygonF( xMap, yMap, data(), from, to );
+        }
 
         if ( doFill )
         {
@@ -560,18 +999,29 @@ void QwtPlotCurve::drawLines( QPainter *painter,
         }
         else
         {
-            if ( testPaintAttribute( ClipPolygons ) )
+            const bool fitPath = doFit && 
+                ( d_data->curveFitter->mode() == QwtCurveFitter::Path );
+
+            const bool fitInRect = fitPath &&
+                d_data->curveFitter->isRestrictingToRect();
+
+            if ( testPaintAttribute( ClipPolygons ) && !fitInRect )
             {
+                // Fitters, that restrict the curve to the rect of interest, 
+                // don't need the clipping, that would distort the curve
+                // at the borders
+
                 polyline = QwtClipper::clipPolygonF(
                     clipRect, polyline, false );
             }
 
             if ( doFit )
             {
-                if ( d_data->curveFitter->mode() == QwtCurveFitter::Path )
+                if ( fitPath )
                 {
                     const QPainterPath curvePath = 
-                        d_data->curveFitter->fitCurvePath( polyline );
+                        d_data->curveFitter->fitCurvePathInRect( 
+                            polyline, clipRect );
 
                     painter->drawPath( curvePath );
                 }
@@ -586,6 +1036,8 @@ void QwtPlotCurve::drawLines( QPainter *painter,
                 QwtPainter::drawPolyline( painter, polyline );
             }
         }
+
+        arena->release( polyline );
     }
 }
 
@@ -622,6 +1074,16 @@ void QwtPlotCurve::drawSticks( QPainter *painter,
 
     const QwtSeriesData<QPointF> *series = data();
 
+    // all sticks are collected and painted with one call
+
+    QwtScratchArena *arena = QwtScratchArena::instance();
+
+    size_t capacity = 0;
+    QLineF *lines = static_cast<QLineF *>( arena->acquireMemory( 
+        ( to - from + 1 ) * sizeof( QLineF ), capacity ) );
+
+    int numLines = 0;
+
     for ( int i = from; i <= to; i++ )
     {
         const QPointF sample = series->sample( i );
@@ -633,12 +1095,40 @@ void QwtPlotCurve::drawSticks( QPainter *painter,
             yi = qRound( yi );
         }
 
+        if ( doAlign && numLines > 0 )
+        {
+            /*
+              When zoomed out many sticks are in the same pixel 
+              row/column. As all of them include the baseline
+              they can be merged into one line.
+             */
+
+            QLineF &line = lines[numLines - 1];
+
+            if ( o == Qt::Horizontal && line.y1() == yi )
+            {
+                line.setLine( qMin( qMin( line.x1(), line.x2() ), xi ), yi,
+                    qMax( qMax( line.x1(), line.x2() ), xi ), yi );
+                continue;
+            }
+
+            if ( o == Qt::Vertical && line.x1() == xi )
+            {
+                line.setLine( xi, qMin( qMin( line.y1(), line.y2() ), yi ),
+                    xi, qMax( qMax( line.y1(), line.y2() ), yi ) );
+                continue;
+            }
+        }
+
         if ( o == Qt::Horizontal )
-            QwtPainter::drawLine( painter, x0, yi, xi, yi );
+            lines[numLines++] = QLineF( x0, yi, xi, yi );
         else
-            QwtPainter::drawLine( painter, xi, y0, xi, yi );
+            lines[numLines++] = QLineF( xi, y0, xi, yi );
     }
 
+    QwtPainter::drawLines( painter, lines, numLines );
+    arena->releaseMemory( lines, capacity );
+
     painter->restore();
 }
 
@@ -672,6 +1162,7 @@ void QwtPlotCurve::drawDots( QPainter *painter,
     QwtPointMapper mapper;
     mapper.setBoundingRect( canvasRect );
     mapper.setFlag( QwtPointMapper::RoundPoints, doAlign );
+    mapper.setFlag( QwtPointMapper::ScratchBuffers, true );
 
     if ( d_data->paintAttributes & FilterPoints )
     {
@@ -691,6 +1182,8 @@ void QwtPlotCurve::drawDots( QPainter *painter,
 
         QwtPainter::drawPoints( painter, points );
         fillCurve( painter, xMap, yMap, canvasRect, points );
+
+        QwtScratchArena::instance()->release( points );
     }
     else if ( d_data->paintAttributes & ImageBuffer )
     {
@@ -725,17 +1218,19 @@ void QwtPlotCurve::drawDots( QPainter *painter,
     {
         if ( doAlign )
         {
-            const QPolygon points = mapper.toPoints(
+            QPolygon points = mapper.toPoints(
                 xMap, yMap, data(), from, to ); 
 
             QwtPainter::drawPoints( painter, points );
+            QwtScratchArena::instance()->release( points );
         }
         else
         {
-            const QPolygonF points = mapper.toPointsF( 
+            QPolygonF points = mapper.toPointsF( 
                 xMap, yMap, data(), from, to );
 
             QwtPainter::drawPoints( painter, points );
+            QwtScratchArena::instance()->release( points );
         }
     }
 }
@@ -761,7 +1256,11 @@ void QwtPlotCurve::drawSteps( QPainter *painter,
 {
     const bool doAlign = QwtPainter::roundingAlignment( painter );
 
-    QPolygonF polygon( 2 * ( to - from ) + 1 );
+    QwtScratchArena *arena = QwtScratchArena::instance();
+
+    QPolygonF polygon;
+    arena->acquire( 2 * ( to - from ) + 1, polygon );
+
     QPointF *points = polygon.data();
 
     bool inverted = orientation() == Qt::Vertical;
@@ -803,6 +1302,16 @@ void QwtPlotCurve::drawSteps( QPainter *painter,
         points[ip].ry() = yi;
     }
 
+    if ( doAlign )
+    {
+        // merging the steps, that are in the same pixel row/column
+
+        int numPoints = qwtMergeRuns( points, polygon.size(), Qt::Vertical );
+        numPoints = qwtMergeRuns( points, numPoints, Qt::Horizontal );
+
+        polygon.resize( numPoints );
+    }
+
     if ( d_data->paintAttributes & ClipPolygons )
     {
         QRectF clipRect = qwtIntersectedClipRect( canvasRect, painter );
@@ -810,10 +1319,11 @@ void QwtPlotCurve::drawSteps( QPainter *painter,
         const qreal pw = qMax( qreal( 1.0 ), painter->pen().widthF());
         clipRect = clipRect.adjusted(-pw, -pw, pw, pw);
 
-        const QPolygonF clipped = QwtClipper::clipPolygonF( 
+        QPolygonF clipped = QwtClipper::clipPolygonF( 
             clipRect, polygon, false );
 
         QwtPainter::drawPolyline( painter, clipped );
+        arena->release( clipped );
     }
     else
     {
@@ -822,6 +1332,8 @@ void QwtPlotCurve::drawSteps( QPainter *painter,
 
     if ( d_data->brush.style() != Qt::NoBrush )
         fillCurve( painter, xMap, yMap, canvasRect, polygon );
+
+    arena->release( polygon );
 }
 
 
@@ -901,6 +1413,12 @@ QwtCurveFitter *QwtPlotCurve::curveFitter() const
   \param canvasRect Contents rectangle of the canvas
   \param polygon Polygon - will be modified !
 
+  On raster devices without scaling and antialiasing, a polygon with 
+  more than 2 visible points per pixel column and monotonic x coordinates ( y for Qt::Horizontal
+  orientation ) is filled column by column with rectangles spanning 
+  the envelope of the curve and the baseline. This is significantly
+  faster than rasterizing a polygon with millions of points.
+
   \sa setBrush(), setBaseline(), setStyle()
 */
 void QwtPlotCurve::fillCurve( QPainter *painter,
@@ -918,18 +1436,38 @@ void QwtPlotCurve::fillCurve( QPainter *painter,
     if ( !brush.color().isValid() )
         brush.setColor( d_data->pen.color() );
 
-    if ( d_data->paintAttributes & ClipPolygons )
+    painter->save();
+
+    painter->setPen( Qt::NoPen );
+    painter->setBrush( brush );
+
+    bool isFilled = false;
+
+    if ( painter->paintEngine() 
+        && painter->paintEngine()->type() == QPaintEngine::Raster
+        && !painter->testRenderHint( QPainter::Antialiasing )
+        && QwtPainter::roundingAlignment( painter ) )
     {
+        // fast path for non antialiased raster devices without scaling
+
         const QRectF clipRect = qwtIntersectedClipRect( canvasRect, painter );
-        polygon = QwtClipper::clipPolygonF( clipRect, polygon, true );
+        isFilled = qwtFillEnvelope( painter, clipRect, polygon, orientation() );
     }
 
-    painter->save();
+    if ( !isFilled )
+    {
+        if ( d_data->paintAttributes & ClipPolygons )
+        {
+            const QRectF clipRect = qwtIntersectedClipRect( canvasRect, painter );
+            const QPolygonF clipped = 
+                QwtClipper::clipPolygonF( clipRect, polygon, true );
 
-    painter->setPen( Qt::NoPen );
-    painter->setBrush( brush );
+            QwtScratchArena::instance()->release( polygon );
+            polygon = clipped;
+        }
 
-    QwtPainter::drawPolygon( painter, polygon );
+        QwtPainter::drawPolygon( painter, polygon );
+    }
 
     painter->restore();
 }
@@ -1002,6 +1540,7 @@ void QwtPlotCurve::drawSymbols( QPainter *painter, const QwtSymbol &symbol,
         QwtPainter::roundingAlignment( painter ) );
     mapper.setFlag( QwtPointMapper::WeedOutPoints, 
         testPaintAttribute( QwtPlotCurve::FilterPoints ) );
+    mapper.setFlag( QwtPointMapper::ScratchBuffers, true );
 
     const QRectF clipRect = qwtIntersectedClipRect( canvasRect, painter );
     mapper.setBoundingRect( clipRect );
@@ -1012,11 +1551,13 @@ void QwtPlotCurve::drawSymbols( QPainter *painter, const QwtSymbol &symbol,
     {
         const int n = qMin( chunkSize, to - i + 1 );
 
-        const QPolygonF points = mapper.toPointsF( xMap, yMap,
+        QPolygonF points = mapper.toPointsF( xMap, yMap,
             data(), i, i + n - 1 );
 
         if ( points.size() > 0 )
             symbol.drawSymbols( painter, points );
+
+        QwtScratchArena::instance()->release( points );
     }
 }
 
@@ -1072,7 +1613,7 @@ int QwtPlotCurve::closestPoint( const QPoint &pos, double *dist ) const
     if ( plot() == NULL || numSamples <= 0 )
         return -1;
 
-    const QwtSeriesData<QPointF> *series = data();
+    const QwtPointColumns columns( data() );
 
     const QwtScaleMap xMap = plot()->canvasMap( xAxis() );
     const QwtScaleMap yMap = plot()->canvasMap( yAxis() );
@@ -1082,7 +1623,7 @@ int QwtPlotCurve::closestPoint( const QPoint &pos, double *dist ) const
 
     for ( uint i = 0; i < numSamples; i++ )
     {
-        const QPointF sample = series->sample( i );
+        const QPointF sample = columns.sample( i );
 
         const double cx = xMap.transform( sample.x() ) - pos.x();
         const double cy = yMap.transform( sample.y() ) - pos.y();
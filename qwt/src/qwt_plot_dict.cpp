@@ -8,55 +8,146 @@
  *****************************************************************************/
 
 #include "qwt_plot_dict.h"
+#include <qmap.h>
+#include <qhash.h>
 
 class QwtPlotDict::PrivateData
 {
 public:
-
-    class ItemList: public QList<QwtPlotItem *>
+    /*
+      Items with the same z value are ordered by the sequence
+      of their insertion, what makes the key unique and allows
+      to find an item in O(log n) - even when thousands of
+      items share the same z value.
+     */
+    class ItemKey
     {
     public:
-        void insertItem( QwtPlotItem *item )
+        ItemKey():
+            z( 0.0 ),
+            sequence( 0 )
         {
-            if ( item == NULL )
-                return;
-
-            QList<QwtPlotItem *>::iterator it =
-                qUpperBound( begin(), end(), item, LessZThan() );
-            insert( it, item );
         }
 
-        void removeItem( QwtPlotItem *item )
+        ItemKey( double zValue, quint64 seq ):
+            z( zValue ),
+            sequence( seq )
         {
-            if ( item == NULL )
-                return;
-
-            QList<QwtPlotItem *>::iterator it =
-                qLowerBound( begin(), end(), item, LessZThan() );
-
-            for ( ; it != end(); ++it )
-            {
-                if ( item == *it )
-                {
-                    erase( it );
-                    break;
-                }
-            }
         }
-    private:
-        class LessZThan
+
+        inline bool operator<( const ItemKey &other ) const
         {
-        public:
-            inline bool operator()( const QwtPlotItem *item1,
-                const QwtPlotItem *item2 ) const
-            {
-                return item1->z() < item2->z();
-            }
-        };
+            if ( z != other.z )
+                return z < other.z;
+
+            return sequence < other.sequence;
+        }
+
+        double z;
+        quint64 sequence;
     };
 
-    ItemList itemList;
+    typedef QMap<ItemKey, QwtPlotItem *> ItemMap;
+
+    // what has been indexed, when the item was inserted
+    class ItemEntry
+    {
+    public:
+        ItemKey key;
+        int rtti;
+        int xAxis;
+        int yAxis;
+    };
+
+    PrivateData():
+        autoDelete( true ),
+        sequence( 0 ),
+        isDirty( false )
+    {
+    }
+
+    void insertItem( QwtPlotItem *item )
+    {
+        if ( item == NULL || entries.contains( item ) )
+            return;
+
+        ItemEntry entry;
+        entry.key = ItemKey( item->z(), sequence++ );
+        entry.rtti = item->rtti();
+        entry.xAxis = item->xAxis();
+        entry.yAxis = item->yAxis();
+
+        zIndex.insert( entry.key, item );
+        rttiIndex[ entry.rtti ].insert( entry.key, item );
+        axisIndex[ entry.xAxis ].insert( entry.key, item );
+        axisIndex[ entry.yAxis ].insert( entry.key, item );
+
+        entries.insert( item, entry );
+
+        isDirty = true;
+    }
+
+    void removeItem( QwtPlotItem *item )
+    {
+        if ( item == NULL )
+            return;
+
+        // The item might be in its destructor, where rtti(),
+        // z() ... can't be used. So we remove it by the 
+        // values, that have been indexed on insertion.
+
+        QHash<const QwtPlotItem *, ItemEntry>::iterator it =
+            entries.find( item );
+        if ( it == entries.end() )
+            return;
+
+        const ItemEntry entry = it.value();
+        entries.erase( it );
+
+        zIndex.remove( entry.key );
+        removeFromIndex( rttiIndex, entry.rtti, entry.key );
+        removeFromIndex( axisIndex, entry.xAxis, entry.key );
+        removeFromIndex( axisIndex, entry.yAxis, entry.key );
+
+        isDirty = true;
+    }
+
+    const QwtPlotItemList &sortedList() const
+    {
+        if ( isDirty )
+        {
+            itemList = zIndex.values();
+            isDirty = false;
+        }
+
+        return itemList;
+    }
+
     bool autoDelete;
+
+    ItemMap zIndex;
+    QHash<int, ItemMap> rttiIndex;
+    QHash<int, ItemMap> axisIndex;
+    QHash<const QwtPlotItem *, ItemEntry> entries;
+
+    quint64 sequence;
+
+private:
+    static void removeFromIndex( QHash<int, ItemMap> &index,
+        int id, const ItemKey &key )
+    {
+        QHash<int, ItemMap>::iterator it = index.find( id );
+        if ( it != index.end() )
+        {
+            it.value().remove( key );
+            if ( it.value().isEmpty() )
+                index.erase( it );
+        }
+    }
+
+    // flattened zIndex, rebuilt lazily after modifications
+    mutable QwtPlotItemList itemList;
+    mutable bool isDirty;
 };
 
 /*!
@@ -68,7 +159,6 @@ public:
 QwtPlotDict::QwtPlotDict()
 {
     d_data = new QwtPlotDict::PrivateData;
-    d_data->autoDelete = true;
 }
 
 /*!
@@ -113,7 +203,7 @@ bool QwtPlotDict::autoDelete() const
  */
 void QwtPlotDict::insertItem( QwtPlotItem *item )
 {
-    d_data->itemList.insertItem( item );
+    d_data->insertItem( item );
 }
 
 /*!
@@ -124,7 +214,27 @@ void QwtPlotDict::insertItem( QwtPlotItem *item )
  */
 void QwtPlotDict::removeItem( QwtPlotItem *item )
 {
-    d_data->itemList.removeItem( item );
+    d_data->removeItem( item );
+}
+
+/*!
+  \brief Update the position of an item in the dictionary
+
+  Needs to be called, when the z value or the axes
+  of an attached item have been changed. In opposite to
+  removing and inserting the item again, it doesn't trigger
+  any legend or attach notifications.
+
+  \param item PlotItem
+  \sa QwtPlotItem::setZ(), QwtPlotItem::setAxes()
+ */
+void QwtPlotDict::reindexItem( QwtPlotItem *item )
+{
+    if ( item && d_data->entries.contains( item ) )
+    {
+        d_data->removeItem( item );
+        d_data->insertItem( item );
+    }
 }
 
 /*!
@@ -136,20 +246,16 @@ void QwtPlotDict::removeItem( QwtPlotItem *item )
 */
 void QwtPlotDict::detachItems( int rtti, bool autoDelete )
 {
-    PrivateData::ItemList list = d_data->itemList;
-    QwtPlotItemIterator it = list.begin();
-    while ( it != list.end() )
+    // a copy, as detaching modifies the dictionary
+    const QwtPlotItemList list = itemList( rtti );
+
+    for ( QwtPlotItemIterator it = list.begin(); it != list.end(); ++it )
     {
         QwtPlotItem *item = *it;
 
-        ++it; // increment before removing item from the list
-
-        if ( rtti == QwtPlotItem::Rtti_PlotItem || item->rtti() == rtti )
-        {
-            item->attach( NULL );
-            if ( autoDelete )
-                delete item;
-        }
+        item->attach( NULL );
+        if ( autoDelete )
+            delete item;
     }
 }
 
@@ -164,7 +270,7 @@ void QwtPlotDict::detachItems( int rtti, bool autoDelete )
 */
 const QwtPlotItemList &QwtPlotDict::itemList() const
 {
-    return d_data->itemList;
+    return d_data->sortedList();
 }
 
 /*!
@@ -175,16 +281,43 @@ const QwtPlotItemList &QwtPlotDict::itemList() const
 QwtPlotItemList QwtPlotDict::itemList( int rtti ) const
 {
     if ( rtti == QwtPlotItem::Rtti_PlotItem )
-        return d_data->itemList;
+        return d_data->sortedList();
 
-    QwtPlotItemList items;
+    return d_data->rttiIndex.value( rtti ).values();
+}
 
-    PrivateData::ItemList list = d_data->itemList;
-    for ( QwtPlotItemIterator it = list.begin(); it != list.end(); ++it )
+/*!
+  \return List of all attached plot items of a specific type,
+          that are assigned to an axis.
+
+  \param axisId Axis, see QwtPlot::Axis
+  \param rtti See QwtPlotItem::RttiValues. In case of 
+              QwtPlotItem::Rtti_PlotItem all items of the axis
+              are returned.
+
+  \sa QwtPlotItem::xAxis(), QwtPlotItem::yAxis()
+*/
+QwtPlotItemList QwtPlotDict::axisItemList( int axisId, int rtti ) const
+{
+    const PrivateData::ItemMap map = d_data->axisIndex.value( axisId );
+    if ( rtti == QwtPlotItem::Rtti_PlotItem )
+        return map.values();
+
+    const PrivateData::ItemMap rttiMap = d_data->rttiIndex.value( rtti );
+
+    // iterate over the smaller index
+
+    const PrivateData::ItemMap &m1 = 
+        ( map.size() < rttiMap.size() ) ? map : rttiMap;
+    const PrivateData::ItemMap &m2 = 
+        ( map.size() < rttiMap.size() ) ? rttiMap : map;
+
+    QwtPlotItemList items;
+    for ( PrivateData::ItemMap::const_iterator it = m1.constBegin();
+        it != m1.constEnd(); ++it )
     {
-        QwtPlotItem *item = *it;
-        if ( item->rtti() == rtti )
-            items += item;
+        if ( m2.contains( it.key() ) )
+            items += it.value();
     }
 
     return items;
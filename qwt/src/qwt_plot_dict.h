@@ -24,6 +24,10 @@ typedef QList<QwtPlotItem *>::ConstIterator QwtPlotItemIterator;
   \brief A dictionary for plot items
 
   QwtPlotDict organizes plot items in increasing z-order.
+  Beside the z-order the items are indexed by their type and axes,
+  so that attaching, detaching, reordering or filtering items
+  scales to plots with many thousands of items.
+
   If autoDelete() is enabled, all attached items will be deleted
   in the destructor of the dictionary.
   QwtPlotDict can be used to get access to all QwtPlotItem items - or all
@@ -43,12 +47,16 @@ public:
     const QwtPlotItemList& itemList() const;
     QwtPlotItemList itemList( int rtti ) const;
 
+    QwtPlotItemList axisItemList( int axisId, 
+        int rtti = QwtPlotItem::Rtti_PlotItem ) const;
+
     void detachItems( int rtti = QwtPlotItem::Rtti_PlotItem,
         bool autoDelete = true );
 
 protected:
     void insertItem( QwtPlotItem * );
     void removeItem( QwtPlotItem * );
+    void reindexItem( QwtPlotItem * );
 
 private:
     class PrivateData;
@@ -12,6 +12,7 @@
 #include "qwt_painter.h"
 #include "qwt_column_symbol.h"
 #include "qwt_scale_map.h"
+#include "qwt_scratch_arena.h"
 #include <qstring.h>
 #include <qpainter.h>
 
@@ -39,7 +40,8 @@ public:
     PrivateData():
         baseline( 0.0 ),
         style( Columns ),
-        symbol( NULL )
+        symbol( NULL ),
+        paintAttributes( 0 )
     {
     }
 
@@ -54,6 +56,7 @@ public:
     QBrush brush;
     QwtPlotHistogram::HistogramStyle style;
     const QwtColumnSymbol *symbol;
+    QwtPlotHistogram::PaintAttributes paintAttributes;
 };
 
 /*!
@@ -94,6 +97,30 @@ void QwtPlotHistogram::init()
     setZ( 20.0 );
 }
 
+/*!
+  Specify an attribute how to draw the histogram
+
+  \param attribute Paint attribute
+  \param on On/Off
+  \sa testPaintAttribute()
+*/
+void QwtPlotHistogram::setPaintAttribute( PaintAttribute attribute, bool on )
+{
+    if ( on )
+        d_data->paintAttributes |= attribute;
+    else
+        d_data->paintAttributes &= ~attribute;
+}
+
+/*!
+    \return True, when attribute is enabled
+    \sa setPaintAttribute()
+*/
+bool QwtPlotHistogram::testPaintAttribute( PaintAttribute attribute ) const
+{
+    return ( d_data->paintAttributes & attribute );
+}
+
 /*!
   Set the histogram's drawing style
 
@@ -453,7 +480,7 @@ void QwtPlotHistogram::drawOutline( QPainter *painter,
   \param to Index of the last sample to be painted. If to < 0 the
          histogram will be painted to its last point.
 
-  \sa setStyle(), style(), setSymbol(), drawColumn()
+  \sa setStyle(), style(), setSymbol(), drawColumn(), BatchColumns
 */
 void QwtPlotHistogram::drawColumns( QPainter *painter,
     const QwtScaleMap &xMap, const QwtScaleMap &yMap,
@@ -464,6 +491,65 @@ void QwtPlotHistogram::drawColumns( QPainter *painter,
 
     const QwtSeriesData<QwtIntervalSample> *series = data();
 
+    const bool hasSymbol = d_data->symbol &&
+        ( d_data->symbol->style() != QwtColumnSymbol::NoStyle );
+
+    if ( testPaintAttribute( BatchColumns ) && !hasSymbol )
+    {
+        const bool doAlign = QwtPainter::roundingAlignment( painter );
+
+        QwtScratchArena *arena = QwtScratchArena::instance();
+
+        size_t capacity = 0;
+        QRectF *rects = static_cast<QRectF *>( arena->acquireMemory(
+            ( to - from + 1 ) * sizeof( QRectF ), capacity ) );
+
+        int numRects = 0;
+
+        for ( int i = from; i <= to; i++ )
+        {
+            const QwtIntervalSample sample = series->sample( i );
+            if ( sample.interval.isNull() )
+                continue;
+
+            QRectF r = columnRect( sample, xMap, yMap ).toRect();
+            if ( doAlign )
+            {
+                r.setLeft( qRound( r.left() ) );
+                r.setRight( qRound( r.right() ) );
+                r.setTop( qRound( r.top() ) );
+                r.setBottom( qRound( r.bottom() ) );
+
+                if ( numRects > 0 )
+                {
+                    /*
+                      When zoomed out many columns are in the same
+                      pixel column/row. As all of them include the baseline 
+                      they can be merged into one rectangle.
+                     */
+                    QRectF &last = rects[numRects - 1];
+
+                    const bool mergeable = ( orientation() == Qt::Vertical )
+                        ? ( last.left() == r.left() && last.right() == r.right() )
+                        : ( last.top() == r.top() && last.bottom() == r.bottom() );
+
+                    if ( mergeable )
+                    {
+                        last = last.united( r );
+                        continue;
+                    }
+                }
+            }
+
+            rects[numRects++] = r;
+        }
+
+        QwtPainter::drawRects( painter, rects, numRects );
+        arena->releaseMemory( rects, capacity );
+
+        return;
+    }
+
     for ( int i = from; i <= to; i++ )
     {
         const QwtIntervalSample sample = series->sample( i );
@@ -498,6 +584,16 @@ void QwtPlotHistogram::drawLines( QPainter *painter,
 
     const QwtSeriesData<QwtIntervalSample> *series = data();
 
+    // all lines are collected and painted with one call
+
+    QwtScratchArena *arena = QwtScratchArena::instance();
+
+    size_t capacity = 0;
+    QLineF *lines = static_cast<QLineF *>( arena->acquireMemory(
+        ( to - from + 1 ) * sizeof( QLineF ), capacity ) );
+
+    int numLines = 0;
+
     for ( int i = from; i <= to; i++ )
     {
         const QwtIntervalSample sample = series->sample( i );
@@ -518,31 +614,34 @@ void QwtPlotHistogram::drawLines( QPainter *painter,
             {
                 case QwtColumnRect::LeftToRight:
                 {
-                    QwtPainter::drawLine( painter,
-                        r.topRight(), r.bottomRight() );
+                    lines[numLines++] = 
+                        QLineF( r.topRight(), r.bottomRight() );
                     break;
                 }
                 case QwtColumnRect::RightToLeft:
                 {
-                    QwtPainter::drawLine( painter,
-                        r.topLeft(), r.bottomLeft() );
+                    lines[numLines++] = 
+                        QLineF( r.topLeft(), r.bottomLeft() );
                     break;
                 }
                 case QwtColumnRect::TopToBottom:
                 {
-                    QwtPainter::drawLine( painter,
-                        r.bottomRight(), r.bottomLeft() );
+                    lines[numLines++] = 
+                        QLineF( r.bottomRight(), r.bottomLeft() );
                     break;
                 }
                 case QwtColumnRect::BottomToTop:
                 {
-                    QwtPainter::drawLine( painter,
-                        r.topRight(), r.topLeft() );
+                    lines[numLines++] = 
+                        QLineF( r.topRight(), r.topLeft() );
                     break;
                 }
             }
         }
     }
+
+    QwtPainter::drawLines( painter, lines, numLines );
+    arena->releaseMemory( lines, capacity );
 }
 
 //! Internal, used by the Outline style.
@@ -76,12 +76,37 @@ public:
         UserStyle = 100
     };
 
+    /*!
+        Attributes to modify the drawing algorithm.
+        \sa setPaintAttribute(), testPaintAttribute()
+    */
+    enum PaintAttribute
+    {
+        /*!
+          In Columns style all columns are collected and painted
+          with one call of QPainter::drawRects(). When the coordinates
+          are aligned to integers, columns in the same pixel column 
+          ( or row ) are merged.
+
+          As drawColumn() is bypassed the attribute is ignored,
+          when a symbol() has been set. It should not be enabled
+          for derived classes, that overload drawColumn().
+         */
+        BatchColumns = 0x01
+    };
+
+    //! Paint attributes
+    typedef QFlags<PaintAttribute> PaintAttributes;
+
     explicit QwtPlotHistogram( const QString &title = QString::null );
     explicit QwtPlotHistogram( const QwtText &title );
     virtual ~QwtPlotHistogram();
 
     virtual int rtti() const;
 
+    void setPaintAttribute( PaintAttribute, bool on = true );
+    bool testPaintAttribute( PaintAttribute ) const;
+
     void setPen( const QColor &, qreal width = 0.0, Qt::PenStyle = Qt::SolidLine );
     void setPen( const QPen & );
     const QPen &pen() const;
@@ -136,4 +161,6 @@ private:
     PrivateData *d_data;
 };
 
+Q_DECLARE_OPERATORS_FOR_FLAGS( QwtPlotHistogram::PaintAttributes )
+
 #endif
@@ -150,13 +150,13 @@ void QwtPlotItem::setZ( double z )
 {
     if ( d_data->z != z )
     {
-        if ( d_data->plot ) // update the z order
-            d_data->plot->attachItem( this, false );
-
         d_data->z = z;
 
-        if ( d_data->plot )
-            d_data->plot->attachItem( this, true );
+        if ( d_data->plot ) // update the z order
+        {
+            d_data->plot->reindexItem( this );
+            d_data->plot->invalidateCullingIndex();
+        }
 
         itemChanged();
     }
@@ -450,7 +450,11 @@ bool QwtPlotItem::isVisible() const
 void QwtPlotItem::itemChanged()
 {
     if ( d_data->plot )
+    {
+        d_data->plot->updateCullingState( this );
+        d_data->plot->invalidateScrolling();
         d_data->plot->autoRefresh();
+    }
 }
 
 /*!
@@ -481,6 +485,9 @@ void QwtPlotItem::setAxes( int xAxis, int yAxis )
     if ( yAxis == QwtPlot::yLeft || yAxis == QwtPlot::yRight )
         d_data->yAxis = yAxis;
 
+    if ( d_data->plot )
+        d_data->plot->reindexItem( this );
+
     itemChanged();
 }
 
@@ -497,6 +504,10 @@ void QwtPlotItem::setXAxis( int axis )
     if ( axis == QwtPlot::xBottom || axis == QwtPlot::xTop )
     {
         d_data->xAxis = axis;
+
+        if ( d_data->plot )
+            d_data->plot->reindexItem( this );
+
         itemChanged();
     }
 }
@@ -514,6 +525,10 @@ void QwtPlotItem::setYAxis( int axis )
     if ( axis == QwtPlot::yLeft || axis == QwtPlot::yRight )
     {
         d_data->yAxis = axis;
+
+        if ( d_data->plot )
+            d_data->plot->reindexItem( this );
+
         itemChanged();
     }
 }
@@ -539,6 +554,39 @@ QRectF QwtPlotItem::boundingRect() const
     return QRectF( 1.0, 1.0, -2.0, -2.0 ); // invalid
 }
 
+/*!
+   \brief Area, that is used for culling the item
+
+   When the QwtPlotItem::ViewportCulling flag is enabled the item
+   is not painted, when cullingRect() - expanded by cullingMargin() -
+   doesn't intersect with the canvas.
+
+   A width ( or height ) < 0.0 indicates, that the item has no extent
+   in this direction and can't be culled horizontally ( or vertically ).
+
+   \return The default implementation returns boundingRect()
+   \sa cullingMargin(), ViewportCulling
+*/
+QRectF QwtPlotItem::cullingRect() const
+{
+    return boundingRect();
+}
+
+/*!
+   \brief Margin around the cullingRect(), where the item might paint
+
+   Some items display things like symbols or labels around the position,
+   that has been mapped to the canvas. The margin is in target device 
+   coordinates ( pixels on screen ).
+
+   \return The default implementation returns 0.0
+   \sa cullingRect(), ViewportCulling
+*/
+double QwtPlotItem::cullingMargin() const
+{
+    return 0.0;
+}
+
 /*!
    \brief Calculate a hint for the canvas margin
 
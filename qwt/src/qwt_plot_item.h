@@ -156,7 +156,24 @@ public:
            its bounding rectangle. 
            \sa getCanvasMarginHint()
          */
-        Margins = 0x04
+        Margins = 0x04,
+
+        /*!
+           The item is not painted, when its cullingRect() - expanded
+           by cullingMargin() - is outside of the visible area of the canvas.
+           \sa QwtPlot::drawItems()
+         */
+        ViewportCulling = 0x08,
+
+        /*!
+           The item is painted in a position relative to the canvas
+           - not in plot coordinates. It doesn't move, when the scales
+           are scrolled, so that the canvas can't reuse the scrolled
+           content of the backing store.
+
+           \sa QwtPlotCanvas::ScrollBackingStore
+         */
+        CanvasAligned = 0x10
     };
 
     //! Plot Item Attributes
@@ -268,6 +285,9 @@ public:
 
     virtual QRectF boundingRect() const;
 
+    virtual QRectF cullingRect() const;
+    virtual double cullingMargin() const;
+
     virtual void getCanvasMarginHint( 
         const QwtScaleMap &xMap, const QwtScaleMap &yMap,
         const QRectF &canvasSize,
@@ -13,12 +13,59 @@
 #include "qwt_scale_widget.h"
 #include "qwt_abstract_legend.h"
 #include <qscrollbar.h>
+#include <qlist.h>
 #include <qmath.h>
 
+namespace
+{
+    /*
+      The height of a text for the most recent width. As long
+      as text and width don't change, the - maybe expensive -
+      calculation of the text layout can be avoided.
+     */
+    class TextHeightCache
+    {
+    public:
+        TextHeightCache():
+            width( -1.0 ),
+            height( 0.0 )
+        {
+        }
+
+        inline bool lookup( const QwtText &text, 
+            const QFont &font, double width, double &height ) const
+        {
+            if ( width != this->width || font != this->font 
+                || !( text == this->text ) )
+            {
+                return false;
+            }
+
+            height = this->height;
+            return true;
+        }
+
+        inline void insert( const QwtText &text,
+            const QFont &font, double width, double height )
+        {
+            this->text = text;
+            this->font = font;
+            this->width = width;
+            this->height = height;
+        }
+
+        QwtText text;
+        QFont font;
+        double width;
+        double height;
+    };
+}
+
 class QwtPlotLayout::LayoutData
 {
 public:
     void init( const QwtPlot *, const QRectF &rect );
+    bool operator==( const LayoutData & ) const;
 
     struct t_legendData
     {
@@ -45,6 +92,7 @@ public:
         bool isEnabled;
         const QwtScaleWidget *scaleWidget;
         QFont scaleFont;
+        QwtText title;
         int start;
         int end;
         int baseLineOffset;
@@ -84,6 +132,13 @@ void QwtPlotLayout::LayoutData::init( const QwtPlot *plot, const QRectF &rect )
 
         legend.hint = QSize( w, h );
     }
+    else
+    {
+        legend.frameWidth = 0;
+        legend.hScrollExtent = 0;
+        legend.vScrollExtent = 0;
+        legend.hint = QSize();
+    }
 
     // title
 
@@ -128,6 +183,7 @@ void QwtPlotLayout::LayoutData::init( const QwtPlot *plot, const QRectF &rect )
             scale[axis].scaleWidget = scaleWidget;
 
             scale[axis].scaleFont = scaleWidget->font();
+            scale[axis].title = scaleWidget->title();
 
             scale[axis].start = scaleWidget->startBorderDist();
             scale[axis].end = scaleWidget->endBorderDist();
@@ -153,6 +209,9 @@ void QwtPlotLayout::LayoutData::init( const QwtPlot *plot, const QRectF &rect )
         else
         {
             scale[axis].isEnabled = false;
+            scale[axis].scaleWidget = NULL;
+            scale[axis].scaleFont = QFont();
+            scale[axis].title = QwtText();
             scale[axis].start = 0;
             scale[axis].end = 0;
             scale[axis].baseLineOffset = 0;
@@ -170,12 +229,66 @@ void QwtPlotLayout::LayoutData::init( const QwtPlot *plot, const QRectF &rect )
         &canvas.contentsMargins[ QwtPlot::xBottom ] );
 }
 
+/*
+  Compare the layout relevant data of 2 calls of activate()
+*/
+bool QwtPlotLayout::LayoutData::operator==( const LayoutData &other ) const
+{
+    if ( legend.frameWidth != other.legend.frameWidth
+        || legend.hScrollExtent != other.legend.hScrollExtent
+        || legend.vScrollExtent != other.legend.vScrollExtent
+        || legend.hint != other.legend.hint )
+    {
+        return false;
+    }
+
+    if ( title.frameWidth != other.title.frameWidth 
+        || !( title.text == other.title.text ) )
+    {
+        return false;
+    }
+
+    if ( footer.frameWidth != other.footer.frameWidth 
+        || !( footer.text == other.footer.text ) )
+    {
+        return false;
+    }
+
+    for ( int axis = 0; axis < QwtPlot::axisCnt; axis++ )
+    {
+        const t_scaleData &s1 = scale[axis];
+        const t_scaleData &s2 = other.scale[axis];
+
+        if ( s1.isEnabled != s2.isEnabled 
+            || s1.scaleWidget != s2.scaleWidget
+            || s1.start != s2.start || s1.end != s2.end
+            || s1.baseLineOffset != s2.baseLineOffset
+            || s1.tickOffset != s2.tickOffset
+            || s1.dimWithoutTitle != s2.dimWithoutTitle
+            || s1.scaleFont != s2.scaleFont 
+            || !( s1.title == s2.title ) )
+        {
+            return false;
+        }
+
+        if ( canvas.contentsMargins[axis] != other.canvas.contentsMargins[axis] )
+            return false;
+    }
+
+    return true;
+}
+
 class QwtPlotLayout::PrivateData
 {
 public:
     PrivateData():
         spacing( 5 )
     {
+        for ( int axis = 0; axis < QwtPlot::axisCnt; axis++ )
+        {
+            stableAxisWidth[axis] = false;
+            stableDim[axis] = 0;
+        }
     }
 
     QRectF titleRect;
@@ -191,8 +304,141 @@ public:
     unsigned int spacing;
     unsigned int canvasMargin[QwtPlot::axisCnt];
     bool alignCanvasToScales[QwtPlot::axisCnt];
+
+    bool stableAxisWidth[QwtPlot::axisCnt];
+    int stableDim[QwtPlot::axisCnt];
+
+    /*
+      The input and the geometries of a previous activate() call.
+      Keeping a couple of them avoids recalculations when a plot is
+      rendered alternately to the widget and to documents - or to
+      many documents of the same size.
+     */
+    class LayoutResult
+    {
+    public:
+        QRectF plotRect;
+        QwtPlotLayout::Options options;
+        bool hasLegend;
+        QwtPlotLayout::LayoutData layoutData;
+
+        QwtPlot::LegendPosition legendPos;
+        double legendRatio;
+        unsigned int spacing;
+        unsigned int canvasMargin[QwtPlot::axisCnt];
+        bool alignCanvasToScales[QwtPlot::axisCnt];
+
+        QRectF titleRect;
+        QRectF footerRect;
+        QRectF legendRect;
+        QRectF scaleRect[QwtPlot::axisCnt];
+        QRectF canvasRect;
+    };
+
+    bool restoreResult( const QRectF &plotRect,
+        QwtPlotLayout::Options, bool hasLegend );
+
+    void storeResult( const QRectF &plotRect,
+        QwtPlotLayout::Options, bool hasLegend );
+
+    void resetRects();
+
+    // most recent first
+    QList<LayoutResult> recentResults;
+
+    TextHeightCache titleHeight;
+    TextHeightCache footerHeight;
+    TextHeightCache axisTitleHeight[QwtPlot::axisCnt];
 };
 
+/*
+  Look for a previous result with identical input. When found, its
+  geometries become the current ones and the result is moved to the front.
+ */
+bool QwtPlotLayout::PrivateData::restoreResult( const QRectF &plotRect,
+    QwtPlotLayout::Options options, bool hasLegend )
+{
+    for ( int i = 0; i < recentResults.size(); i++ )
+    {
+        const LayoutResult &r = recentResults[i];
+
+        bool matches = r.plotRect == plotRect && r.options == options
+            && r.hasLegend == hasLegend && r.legendPos == legendPos
+            && r.legendRatio == legendRatio && r.spacing == spacing;
+
+        for ( int axis = 0; matches && axis < QwtPlot::axisCnt; axis++ )
+        {
+            matches = r.canvasMargin[axis] == canvasMargin[axis]
+                && r.alignCanvasToScales[axis] == alignCanvasToScales[axis];
+        }
+
+        if ( matches && r.layoutData == layoutData )
+        {
+            if ( i > 0 )
+                recentResults.move( i, 0 );
+
+            const LayoutResult &result = recentResults.first();
+
+            titleRect = result.titleRect;
+            footerRect = result.footerRect;
+            legendRect = result.legendRect;
+            canvasRect = result.canvasRect;
+
+            for ( int axis = 0; axis < QwtPlot::axisCnt; axis++ )
+                scaleRect[axis] = result.scaleRect[axis];
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*
+  Remember the input and the geometries of the current activate() call
+ */
+void QwtPlotLayout::PrivateData::storeResult( const QRectF &plotRect,
+    QwtPlotLayout::Options options, bool hasLegend )
+{
+    const int maxResults = 4;
+
+    LayoutResult result;
+
+    result.plotRect = plotRect;
+    result.options = options;
+    result.hasLegend = hasLegend;
+    result.layoutData = layoutData;
+
+    result.legendPos = legendPos;
+    result.legendRatio = legendRatio;
+    result.spacing = spacing;
+
+    result.titleRect = titleRect;
+    result.footerRect = footerRect;
+    result.legendRect = legendRect;
+    result.canvasRect = canvasRect;
+
+    for ( int axis = 0; axis < QwtPlot::axisCnt; axis++ )
+    {
+        result.canvasMargin[axis] = canvasMargin[axis];
+        result.alignCanvasToScales[axis] = alignCanvasToScales[axis];
+        result.scaleRect[axis] = scaleRect[axis];
+    }
+
+    recentResults.prepend( result );
+
+    while ( recentResults.size() > maxResults )
+        recentResults.removeLast();
+}
+
+void QwtPlotLayout::PrivateData::resetRects()
+{
+    titleRect = footerRect = legendRect = canvasRect = QRect();
+
+    for ( int axis = 0; axis < QwtPlot::axisCnt; axis++ )
+        scaleRect[axis] = QRect();
+}
+
 /*!
   \brief Constructor
  */
@@ -306,6 +552,61 @@ bool QwtPlotLayout::alignCanvasToScale( int axisId ) const
     return d_data->alignCanvasToScales[ axisId ];
 }
 
+/*!
+  \brief Set the stable-axis-width flag for all axes
+
+  \param on True/False
+  \sa setStableAxisWidth(), stableAxisWidth()
+*/
+void QwtPlotLayout::setStableAxisWidths( bool on )
+{
+    for ( int axis = 0; axis < QwtPlot::axisCnt; axis++ )
+        setStableAxisWidth( axis, on );
+}
+
+/*!
+  \brief En/Disable a stable width for an axis
+
+  The width of an axis ( the height for horizontal axes ) depends
+  on the size of its tick labels. When the labels of a scrolling axis
+  change for each replot, the width might change too, and every change
+  results in a new layout of the plot with a resized canvas.
+
+  When the stable-axis-width flag is enabled, the width of the axis
+  never shrinks: the layout uses the maximum of all widths, that have
+  been seen since the flag has been enabled. To shrink it again the
+  flag has to be disabled and enabled again.
+
+  The default setting is false.
+
+  \param axisId Axis index
+  \param on New stable-axis-width setting
+
+  \sa stableAxisWidth(), setStableAxisWidths(),
+      QwtAbstractScaleDraw::setMinimumExtent()
+*/
+void QwtPlotLayout::setStableAxisWidth( int axisId, bool on )
+{
+    if ( axisId >= 0 && axisId < QwtPlot::axisCnt )
+    {
+        d_data->stableAxisWidth[axisId] = on;
+        d_data->stableDim[axisId] = 0;
+    }
+}
+
+/*!
+  \param axisId Axis index
+  \return stable-axis-width setting
+  \sa setStableAxisWidth(), setStableAxisWidths()
+*/
+bool QwtPlotLayout::stableAxisWidth( int axisId ) const
+{
+    if ( axisId < 0 || axisId >= QwtPlot::axisCnt )
+        return false;
+
+    return d_data->stableAxisWidth[ axisId ];
+}
+
 /*!
   Change the spacing of the plot. The spacing is the distance
   between the plot components.
@@ -536,15 +837,19 @@ QRectF QwtPlotLayout::canvasRect() const
 
 /*!
   Invalidate the geometry of all components.
+
+  activate() keeps the results of its recent calls and reuses them,
+  when the plot rectangle, the options, the settings of the layout and
+  all layout relevant parameters of the plot components are the same.
+  Derived layouts depending on other parameters need to call invalidate(),
+  when those have changed.
+
   \sa activate()
 */
 void QwtPlotLayout::invalidate()
 {
-    d_data->titleRect = d_data->footerRect
-        = d_data->legendRect = d_data->canvasRect = QRect();
-
-    for ( int axis = 0; axis < QwtPlot::axisCnt; axis++ )
-        d_data->scaleRect[axis] = QRect();
+    d_data->resetRects();
+    d_data->recentResults.clear();
 }
 
 /*!
@@ -891,7 +1196,16 @@ void QwtPlotLayout::expandLineBreaks( Options options, const QRectF &rect,
                 w -= dimAxis[QwtPlot::yLeft] + dimAxis[QwtPlot::yRight];
             }
 
-            int d = qCeil( d_data->layoutData.title.text.heightForWidth( w ) );
+            const QwtText &text = d_data->layoutData.title.text;
+
+            double h;
+            if ( !d_data->titleHeight.lookup( text, text.font(), w, h ) )
+            {
+                h = text.heightForWidth( w );
+                d_data->titleHeight.insert( text, text.font(), w, h );
+            }
+
+            int d = qCeil( h );
             if ( !( options & IgnoreFrames ) )
                 d += 2 * d_data->layoutData.title.frameWidth;
 
@@ -914,7 +1228,16 @@ void QwtPlotLayout::expandLineBreaks( Options options, const QRectF &rect,
                 w -= dimAxis[QwtPlot::yLeft] + dimAxis[QwtPlot::yRight];
             }
 
-            int d = qCeil( d_data->layoutData.footer.text.heightForWidth( w ) );
+            const QwtText &text = d_data->layoutData.footer.text;
+
+            double h;
+            if ( !d_data->footerHeight.lookup( text, text.font(), w, h ) )
+            {
+                h = text.heightForWidth( w );
+                d_data->footerHeight.insert( text, text.font(), w, h );
+            }
+
+            int d = qCeil( h );
             if ( !( options & IgnoreFrames ) )
                 d += 2 * d_data->layoutData.footer.frameWidth;
 
@@ -977,9 +1300,22 @@ void QwtPlotLayout::expandLineBreaks( Options options, const QRectF &rect,
                 }
 
                 int d = scaleData.dimWithoutTitle;
-                if ( !scaleData.scaleWidget->title().isEmpty() )
+                if ( !scaleData.title.isEmpty() )
                 {
-                    d += scaleData.scaleWidget->titleHeightForWidth( qFloor( length ) );
+                    const int titleLength = qFloor( length );
+
+                    TextHeightCache &cache = d_data->axisTitleHeight[axis];
+
+                    double h;
+                    if ( !cache.lookup( scaleData.title, 
+                        scaleData.scaleFont, titleLength, h ) )
+                    {
+                        h = scaleData.scaleWidget->titleHeightForWidth( titleLength );
+                        cache.insert( scaleData.title, 
+                            scaleData.scaleFont, titleLength, h );
+                    }
+
+                    d += qRound( h );
                 }
 
 
@@ -1270,17 +1606,42 @@ void QwtPlotLayout::alignScales( Options options,
 void QwtPlotLayout::activate( const QwtPlot *plot,
     const QRectF &plotRect, Options options )
 {
-    invalidate();
+    // We extract all layout relevant parameters from the widgets
+    // and compare them with those from the previous calls. When nothing
+    // has changed, the geometries of a previous call are still valid.
 
-    QRectF rect( plotRect );  // undistributed rest of the plot rect
+    // Only complete layouts are reused: the components are measured
+    // on each call. The expensive part of it - the sizes of the 
+    // tick labels - is cached by the scale draws, that know, when
+    // their labels become invalid ( QwtAbstractScaleDraw::tickLabel() ).
 
-    // We extract all layout relevant parameters from the widgets,
-    // and save them to d_data->layoutData.
+    LayoutData layoutData;
+    layoutData.init( plot, plotRect );
 
-    d_data->layoutData.init( plot, rect );
+    for ( int axis = 0; axis < QwtPlot::axisCnt; axis++ )
+    {
+        if ( d_data->stableAxisWidth[axis] && layoutData.scale[axis].isEnabled )
+        {
+            int &dim = layoutData.scale[axis].dimWithoutTitle;
 
-    if ( !( options & IgnoreLegend )
-        && plot->legend() && !plot->legend()->isEmpty() )
+            dim = qMax( dim, d_data->stableDim[axis] );
+            d_data->stableDim[axis] = dim;
+        }
+    }
+
+    const bool hasLegend = !( options & IgnoreLegend )
+        && plot->legend() && !plot->legend()->isEmpty();
+
+    d_data->layoutData = layoutData;
+
+    if ( d_data->restoreResult( plotRect, options, hasLegend ) )
+        return;
+
+    d_data->resetRects();
+
+    QRectF rect( plotRect );  // undistributed rest of the plot rect
+
+    if ( hasLegend )
     {
         d_data->legendRect = layoutLegend( options, rect );
 
@@ -1439,4 +1800,6 @@ void QwtPlotLayout::activate( const QwtPlot *plot,
 
         d_data->legendRect = alignLegend( d_data->canvasRect, d_data->legendRect );
     }
+
+    d_data->storeResult( plotRect, options, hasLegend );
 }
@@ -68,6 +68,11 @@ public:
     void setAlignCanvasToScale( int axisId, bool );
     bool alignCanvasToScale( int axisId ) const;
 
+    void setStableAxisWidths( bool );
+
+    void setStableAxisWidth( int axisId, bool );
+    bool stableAxisWidth( int axisId ) const;
+
     void setSpacing( int );
     int spacing() const;
 
@@ -173,6 +173,7 @@ QwtPlotLegendItem::QwtPlotLegendItem():
     d_data = new PrivateData;
 
     setItemInterest( QwtPlotItem::LegendInterest, true );
+    setItemAttribute( QwtPlotItem::CanvasAligned, true );
     setZ( 100.0 );
 }
 
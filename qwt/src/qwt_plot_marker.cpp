@@ -47,19 +47,33 @@ public:
     double yValue;
 };
 
-//! Sets alignment to Qt::AlignCenter, and style to QwtPlotMarker::NoLine
+/*!
+  Sets alignment to Qt::AlignCenter, and style to QwtPlotMarker::NoLine
+
+  QwtPlotItem::ViewportCulling is enabled, so that markers 
+  outside of the visible area are not painted.
+ */
 QwtPlotMarker::QwtPlotMarker( const QString &title ):
     QwtPlotItem( QwtText( title ) )
 {
     d_data = new PrivateData;
+
+    setItemAttribute( QwtPlotItem::ViewportCulling, true );
     setZ( 30.0 );
 }
 
-//! Sets alignment to Qt::AlignCenter, and style to QwtPlotMarker::NoLine
+/*!
+  Sets alignment to Qt::AlignCenter, and style to QwtPlotMarker::NoLine
+
+  QwtPlotItem::ViewportCulling is enabled, so that markers 
+  outside of the visible area are not painted.
+ */
 QwtPlotMarker::QwtPlotMarker( const QwtText &title ):
     QwtPlotItem( title )
 {
     d_data = new PrivateData;
+
+    setItemAttribute( QwtPlotItem::ViewportCulling, true );
     setZ( 30.0 );
 }
 
@@ -565,6 +579,66 @@ QRectF QwtPlotMarker::boundingRect() const
     return QRectF( d_data->xValue, d_data->yValue, 0.0, 0.0 );
 }
 
+/*!
+   \return Position of the marker. Horizontal lines have no extent in 
+           x direction, vertical lines none in y direction.
+   \sa cullingMargin(), QwtPlotItem::ViewportCulling
+ */
+QRectF QwtPlotMarker::cullingRect() const
+{
+    QRectF rect = boundingRect();
+
+    switch( d_data->style )
+    {
+        case QwtPlotMarker::HLine:
+        {
+            rect.setLeft( 1.0 );
+            rect.setWidth( -2.0 );
+            break;
+        }
+        case QwtPlotMarker::VLine:
+        {
+            rect.setTop( 1.0 );
+            rect.setHeight( -2.0 );
+            break;
+        }
+        case QwtPlotMarker::Cross:
+        {
+            rect = QwtPlotItem::boundingRect();
+            break;
+        }
+        default:
+            break;
+    }
+
+    return rect;
+}
+
+/*!
+   \return Upper limit for the distance between the position 
+           of the marker and the symbol, label and pen
+   \sa cullingRect(), QwtPlotItem::ViewportCulling
+ */
+double QwtPlotMarker::cullingMargin() const
+{
+    double margin = 1.0 + d_data->pen.widthF();
+
+    if ( d_data->symbol &&
+        ( d_data->symbol->style() != QwtSymbol::NoSymbol ) )
+    {
+        const QRect br = d_data->symbol->boundingRect();
+        margin += qMax( br.width(), br.height() );
+    }
+
+    if ( !d_data->label.isEmpty() )
+    {
+        const QSizeF textSize = d_data->label.textSize();
+        margin += d_data->spacing + textSize.width() + textSize.height();
+    }
+
+    return margin;
+}
+
 /*!
    \return Icon representing the marker on the legend
 
@@ -112,6 +112,9 @@ public:
 
     virtual QRectF boundingRect() const;
 
+    virtual QRectF cullingRect() const;
+    virtual double cullingMargin() const;
+
     virtual QwtGraphic legendIcon( int index, const QSizeF & ) const;
 
 protected:
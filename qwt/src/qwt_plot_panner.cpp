@@ -234,7 +234,7 @@ void QwtPlotPanner::moveCanvas( int dx, int dy )
     }
 
     plot->setAutoReplot( doAutoReplot );
-    plot->replot();
+    plot->replotScrolled();
 }
 
 /*!
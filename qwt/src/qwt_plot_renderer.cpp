@@ -26,6 +26,7 @@
 #include <qfileinfo.h>
 #include <qstyle.h>
 #include <qstyleoption.h>
+#include <qimage.h>
 #include <qimagewriter.h>
 
 #ifndef QWT_NO_SVG
@@ -96,17 +97,74 @@ static QPainterPath qwtCanvasClip(
     return clipPath;
 }
 
+static bool qwtIsVectorDevice( const QPainter *painter )
+{
+    switch( painter->paintEngine()->type() )
+    {
+        case QPaintEngine::Pdf:
+        case QPaintEngine::PostScript:
+        case QPaintEngine::SVG:
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+namespace
+{
+    /*
+      Registers the vector flags for a painter as long as the guard 
+      is alive - even when painting the items throws.
+     */
+    class VectorGuard
+    {
+    public:
+        VectorGuard( const QPainter *painter, 
+                bool decimate, int rasterThreshold ):
+            d_painter( painter ),
+            d_decimate( decimate ),
+            d_rasterize( rasterThreshold >= 0 )
+        {
+            if ( d_decimate )
+                QwtPainter::setDecimating( d_painter, true );
+
+            if ( d_rasterize )
+                QwtPainter::setRasterThreshold( d_painter, rasterThreshold );
+        }
+
+        ~VectorGuard()
+        {
+            if ( d_decimate )
+                QwtPainter::setDecimating( d_painter, false );
+
+            if ( d_rasterize )
+                QwtPainter::setRasterThreshold( d_painter, -1 );
+        }
+
+    private:
+        const QPainter *d_painter;
+        const bool d_decimate;
+        const bool d_rasterize;
+    };
+}
+
 class QwtPlotRenderer::PrivateData
 {
 public:
     PrivateData():
         discardFlags( QwtPlotRenderer::DiscardNone ),
-        layoutFlags( QwtPlotRenderer::DefaultLayout )
+        layoutFlags( QwtPlotRenderer::DefaultLayout ),
+        vectorFlags( QwtPlotRenderer::DefaultVector ),
+        rasterThreshold( 100000 )
     {
     }
 
     QwtPlotRenderer::DiscardFlags discardFlags;
     QwtPlotRenderer::LayoutFlags layoutFlags;
+    QwtPlotRenderer::VectorFlags vectorFlags;
+
+    int rasterThreshold;
 };
 
 /*! 
@@ -217,6 +275,76 @@ QwtPlotRenderer::LayoutFlags QwtPlotRenderer::layoutFlags() const
     return d_data->layoutFlags;
 }
 
+/*!
+  Change a flag for reducing the size of vector documents
+
+  \param flag Flag to change
+  \param on On/Off
+
+  \sa VectorFlag, testVectorFlag(), setVectorFlags(), vectorFlags()
+*/
+void QwtPlotRenderer::setVectorFlag( VectorFlag flag, bool on )
+{
+    if ( on )
+        d_data->vectorFlags |= flag;
+    else
+        d_data->vectorFlags &= ~flag;
+}
+
+/*!
+  \return True, if flag is enabled.
+  \param flag Flag to be tested
+  \sa VectorFlag, setVectorFlag(), setVectorFlags(), vectorFlags()
+*/
+bool QwtPlotRenderer::testVectorFlag( VectorFlag flag ) const
+{
+    return d_data->vectorFlags & flag;
+}
+
+/*!
+  Set the flags for reducing the size of vector documents
+
+  \param flags Flags
+  \sa VectorFlag, setVectorFlag(), testVectorFlag(), vectorFlags()
+*/
+void QwtPlotRenderer::setVectorFlags( VectorFlags flags )
+{
+    d_data->vectorFlags = flags;
+}
+
+/*!
+  \return Flags for reducing the size of vector documents
+  \sa VectorFlag, setVectorFlags(), setVectorFlag(), testVectorFlag()
+*/
+QwtPlotRenderer::VectorFlags QwtPlotRenderer::vectorFlags() const
+{
+    return d_data->vectorFlags;
+}
+
+/*!
+  Set the number of points, from where on a curve is rendered
+  to an image, when RasterizeDenseItems is enabled.
+
+  The default setting is 100000.
+
+  \param numPoints Number of points
+  \sa rasterThreshold(), RasterizeDenseItems
+*/
+void QwtPlotRenderer::setRasterThreshold( int numPoints )
+{
+    d_data->rasterThreshold = qMax( numPoints, 0 );
+}
+
+/*!
+  \return Number of points, from where on a curve is rendered
+          to an image, when RasterizeDenseItems is enabled.
+  \sa setRasterThreshold(), RasterizeDenseItems
+*/
+int QwtPlotRenderer::rasterThreshold() const
+{
+    return d_data->rasterThreshold;
+}
+
 /*!
   Render a plot to a file
 
@@ -622,9 +750,6 @@ void QwtPlotRenderer::render( QwtPlot *plot,
 
         layout->setCanvasMargin( canvasMargins[axisId] );
     }
-
-    layout->invalidate();
-
 }
 
 /*!
@@ -812,7 +937,7 @@ void QwtPlotRenderer::renderCanvas( const QwtPlot *plot,
         painter->save();
 
         painter->setClipRect( canvasRect );
-        plot->drawItems( painter, canvasRect, map );
+        renderItems( plot, painter, canvasRect, map );
 
         painter->restore();
     }
@@ -836,7 +961,7 @@ void QwtPlotRenderer::renderCanvas( const QwtPlot *plot,
         else
             painter->setClipPath( clipPath );
 
-        plot->drawItems( painter, canvasRect, map );
+        renderItems( plot, painter, canvasRect, map );
 
         painter->restore();
     }
@@ -874,7 +999,7 @@ void QwtPlotRenderer::renderCanvas( const QwtPlot *plot,
             QwtPainter::drawBackgound( painter, innerRect, canvas );
         }
 
-        plot->drawItems( painter, innerRect, map );
+        renderItems( plot, painter, innerRect, map );
 
         painter->restore();
 
@@ -911,6 +1036,36 @@ void QwtPlotRenderer::renderCanvas( const QwtPlot *plot,
     }
 }
 
+/*!
+  Render the items of the canvas
+
+  The items are rendered by QwtPlot::drawItems(). For vector documents
+  the flags of vectorFlags() are registered for the painter
+  ( QwtPainter::setDecimating(), QwtPainter::setRasterThreshold() ), 
+  so that the items can evaluate them, when painting themselves.
+
+  \param plot Plot widget
+  \param painter Painter
+  \param canvasRect Canvas rectangle
+  \param maps Maps mapping between plot and paint device coordinates
+*/
+void QwtPlotRenderer::renderItems( const QwtPlot *plot, QPainter *painter,
+    const QRectF &canvasRect, const QwtScaleMap *maps ) const
+{
+    if ( d_data->vectorFlags == DefaultVector || !qwtIsVectorDevice( painter ) )
+    {
+        plot->drawItems( painter, canvasRect, maps );
+        return;
+    }
+
+    const VectorGuard vectorGuard( painter, 
+        d_data->vectorFlags & DecimatePoints,
+        ( d_data->vectorFlags & RasterizeDenseItems ) 
+            ? d_data->rasterThreshold : -1 );
+
+    plot->drawItems( painter, canvasRect, maps );
+}
+
 /*!
    Calculated the scale maps for rendering the canvas
 
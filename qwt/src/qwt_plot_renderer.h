@@ -95,6 +95,43 @@ public:
     //! Layout flags
     typedef QFlags<LayoutFlag> LayoutFlags;
 
+    /*!
+       \brief Flags reducing the size of vector documents
+
+       Vector documents ( PDF, PostScript, SVG ) store each point of 
+       a curve, even if millions of them end up in the same dot 
+       of the document. These flags have no effect on other devices.
+
+       \sa setVectorFlag(), testVectorFlag(), setRasterThreshold()
+     */
+    enum VectorFlag
+    {
+        //! Render all items with all their points
+        DefaultVector       = 0x00,
+
+        /*!
+          Reduce the points of the curves to the resolution of the
+          document - like QwtPlotCurve::FilterPointsAggressive does
+          for paint devices in integer coordinates. The attributes
+          of the curves are not modified.
+
+          \sa QwtPainter::setDecimating()
+         */
+        DecimatePoints      = 0x01,
+
+        /*!
+          Curves with more points than rasterThreshold() are rendered
+          to an image in the resolution of the document, that is
+          embedded into the document.
+
+          \sa QwtPainter::setRasterThreshold()
+         */
+        RasterizeDenseItems = 0x02
+    };
+
+    //! Vector flags
+    typedef QFlags<VectorFlag> VectorFlags;
+
     explicit QwtPlotRenderer( QObject * = NULL );
     virtual ~QwtPlotRenderer();
 
@@ -110,6 +147,15 @@ public:
     void setLayoutFlags( LayoutFlags flags );
     LayoutFlags layoutFlags() const;
 
+    void setVectorFlag( VectorFlag flag, bool on = true );
+    bool testVectorFlag( VectorFlag flag ) const;
+
+    void setVectorFlags( VectorFlags flags );
+    VectorFlags vectorFlags() const;
+
+    void setRasterThreshold( int numPoints );
+    int rasterThreshold() const;
+
     void renderDocument( QwtPlot *, const QString &fileName,
         const QSizeF &sizeMM, int resolution = 85 );
 
@@ -161,6 +207,9 @@ private:
     bool updateCanvasMargins( QwtPlot *,
         const QRectF &, const QwtScaleMap maps[] ) const;
 
+    void renderItems( const QwtPlot *, QPainter *, 
+        const QRectF &canvasRect, const QwtScaleMap *maps ) const;
+
 private:
     class PrivateData;
     PrivateData *d_data;
@@ -168,5 +217,6 @@ private:
 
 Q_DECLARE_OPERATORS_FOR_FLAGS( QwtPlotRenderer::DiscardFlags )
 Q_DECLARE_OPERATORS_FOR_FLAGS( QwtPlotRenderer::LayoutFlags )
+Q_DECLARE_OPERATORS_FOR_FLAGS( QwtPlotRenderer::VectorFlags )
 
 #endif
@@ -262,6 +262,8 @@ void QwtPlotScaleItem::setPosition( double pos )
     {
         d_data->position = pos;
         d_data->borderDistance = -1;
+
+        setItemAttribute( QwtPlotItem::CanvasAligned, false );
         itemChanged();
     }
 }
@@ -289,6 +291,7 @@ double QwtPlotScaleItem::position() const
    \param distance Number of pixels between the canvas border and the
                    backbone of the scale.
 
+   \note A scale aligned to the canvas is QwtPlotItem::CanvasAligned
    \sa setPosition(), borderDistance()
 */
 void QwtPlotScaleItem::setBorderDistance( int distance )
@@ -299,6 +302,9 @@ void QwtPlotScaleItem::setBorderDistance( int distance )
     if ( distance != d_data->borderDistance )
     {
         d_data->borderDistance = distance;
+
+        // the scale doesn't move with the scrolled content
+        setItemAttribute( QwtPlotItem::CanvasAligned, distance >= 0 );
         itemChanged();
     }
 }
@@ -137,6 +137,7 @@ void QwtPlotShapeItem::init()
 
     setItemAttribute( QwtPlotItem::AutoScale, true );
     setItemAttribute( QwtPlotItem::Legend, false );
+    setItemAttribute( QwtPlotItem::ViewportCulling, true );
 
     setZ( 8.0 );
 }
@@ -201,6 +202,15 @@ QRectF QwtPlotShapeItem::boundingRect() const
     return d_data->boundingRect;
 }
 
+/*!
+   \return Width of the pen, that is used to draw the outline
+   \sa QwtPlotItem::ViewportCulling, boundingRect()
+ */
+double QwtPlotShapeItem::cullingMargin() const
+{
+    return 1.0 + d_data->pen.widthF();
+}
+
 /*!
   \brief Set a path built from a rectangle
 
@@ -92,6 +92,7 @@ public:
     double renderTolerance() const;
 
     virtual QRectF boundingRect() const;
+    virtual double cullingMargin() const;
 
     virtual void draw( QPainter *p,
         const QwtScaleMap &xMap, const QwtScaleMap &yMap,
@@ -71,6 +71,7 @@ public:
 
    - QwtPlotItem::AutoScale: true
    - QwtPlotItem::Legend:    false
+   - QwtPlotItem::CanvasAligned: true
 
    The z value is initialized by 150
 
@@ -84,6 +85,7 @@ QwtPlotTextLabel::QwtPlotTextLabel():
 
     setItemAttribute( QwtPlotItem::AutoScale, false );
     setItemAttribute( QwtPlotItem::Legend, false );
+    setItemAttribute( QwtPlotItem::CanvasAligned, true );
 
     setZ( 150 );
 }
@@ -10,6 +10,23 @@
 #include "qwt_point_data.h"
 #include "qwt_math.h"
 #include <string.h>
+#include <limits>
+#include <typeinfo>
+
+#include <qthread.h>
+#include <qfuture.h>
+#include <qtconcurrentrun.h>
+
+/*
+  The columns bypass sample(), that might be overridden
+  in a derived class. So they are exposed only for the class
+  itself or when a derived class enables them explicitly.
+ */
+template <class Data>
+static inline bool qwtIsColumnar( const Data *data, bool enabled )
+{
+    return enabled || typeid( *data ) == typeid( Data );
+}
 
 /*!
   Constructor
@@ -77,6 +94,36 @@ QPointF QwtPointArrayData::sample( size_t index ) const
     return QPointF( d_x[int( index )], d_y[int( index )] );
 }
 
+/*!
+  \param stride Returns 1
+  \return Memory of the x coordinates, or NULL for a derived class,
+          that has not enabled the columns
+  \sa yColumn(), xData(), setColumnAccessEnabled()
+*/
+const double *QwtPointArrayData::xColumn( size_t &stride ) const
+{
+    stride = 1;
+    if ( !qwtIsColumnar( this, isColumnAccessEnabled() ) )
+        return NULL;
+
+    return d_x.constData();
+}
+
+/*!
+  \param stride Returns 1
+  \return Memory of the y coordinates, or NULL for a derived class,
+          that has not enabled the columns
+  \sa xColumn(), yData(), setColumnAccessEnabled()
+*/
+const double *QwtPointArrayData::yColumn( size_t &stride ) const
+{
+    stride = 1;
+    if ( !qwtIsColumnar( this, isColumnAccessEnabled() ) )
+        return NULL;
+
+    return d_y.constData();
+}
+
 //! \return Array of the x-values
 const QVector<double> &QwtPointArrayData::xData() const
 {
@@ -106,7 +153,38 @@ QwtCPointerData::QwtCPointerData(
         const double *x, const double *y, size_t size ):
     d_x( x ),
     d_y( y ),
-    d_size( size )
+    d_size( size ),
+    d_xStride( 1 ),
+    d_yStride( 1 )
+{
+}
+
+/*!
+  Constructor for strided memory layouts
+
+  The x coordinate of sample i is found at x[ i * xStride ],
+  the y coordinate at y[ i * yStride ]. F.e. for an array of
+  interleaved x/y values: QwtCPointerData( values, values + 1, size, 2, 2 ).
+
+  \param x Array of x values
+  \param y Array of y values
+  \param size Number of samples
+  \param xStride Distance between 2 x values in doubles
+  \param yStride Distance between 2 y values in doubles
+
+  \warning The programmer must assure that the memory blocks referenced
+           by the pointers remain valid during the lifetime of the
+           QwtPlotCPointer object.
+
+  \sa QwtPlotCurve::setData(), QwtPlotCurve::setRawSamples()
+*/
+QwtCPointerData::QwtCPointerData( const double *x, const double *y, 
+        size_t size, size_t xStride, size_t yStride ):
+    d_x( x ),
+    d_y( y ),
+    d_size( size ),
+    d_xStride( xStride ),
+    d_yStride( yStride )
 {
 }
 
@@ -140,7 +218,49 @@ size_t QwtCPointerData::size() const
 */
 QPointF QwtCPointerData::sample( size_t index ) const
 {
-    return QPointF( d_x[int( index )], d_y[int( index )] );
+    return QPointF( d_x[ index * d_xStride ], d_y[ index * d_yStride ] );
+}
+
+/*!
+  \param stride Returns xStride()
+  \return Memory of the x coordinates, or NULL for a derived class,
+          that has not enabled the columns
+  \sa yColumn(), xData(), setColumnAccessEnabled()
+*/
+const double *QwtCPointerData::xColumn( size_t &stride ) const
+{
+    stride = d_xStride;
+    if ( !qwtIsColumnar( this, isColumnAccessEnabled() ) )
+        return NULL;
+
+    return d_x;
+}
+
+/*!
+  \param stride Returns yStride()
+  \return Memory of the y coordinates, or NULL for a derived class,
+          that has not enabled the columns
+  \sa xColumn(), yData(), setColumnAccessEnabled()
+*/
+const double *QwtCPointerData::yColumn( size_t &stride ) const
+{
+    stride = d_yStride;
+    if ( !qwtIsColumnar( this, isColumnAccessEnabled() ) )
+        return NULL;
+
+    return d_y;
+}
+
+//! \return Distance between 2 x values in doubles
+size_t QwtCPointerData::xStride() const
+{
+    return d_xStride;
+}
+
+//! \return Distance between 2 y values in doubles
+size_t QwtCPointerData::yStride() const
+{
+    return d_yStride;
 }
 
 //! \return Array of the x-values
@@ -305,3 +425,619 @@ double QwtSyntheticPointData::x( uint index ) const
     const double dx = interval.width() / ( d_size - 1 );
     return interval.minValue() + index * dx;
 }
+
+class QwtCachedSyntheticPointData::PrivateData
+{
+public:
+    PrivateData():
+        isCacheEnabled( true ),
+        blockSize( 1024 ),
+        numThreads( 1 ),
+        cachedSize( 0 ),
+        isValid( false )
+    {
+    }
+
+    bool isCacheEnabled;
+    uint blockSize;
+    uint numThreads;
+
+    // parameters of the cached values
+    QwtInterval cachedInterval;
+    size_t cachedSize;
+    bool isValid;
+
+    QVector<double> x;
+    QVector<double> y;
+    QRectF boundingRect;
+};
+
+/*!
+   Constructor
+
+   \param size Number of points
+   \param interval Bounding interval for the points
+
+   \sa setInterval(), setSize()
+*/
+QwtCachedSyntheticPointData::QwtCachedSyntheticPointData(
+        size_t size, const QwtInterval &interval ):
+    QwtSyntheticPointData( size, interval )
+{
+    d_data = new PrivateData;
+}
+
+//! Destructor
+QwtCachedSyntheticPointData::~QwtCachedSyntheticPointData()
+{
+    delete d_data;
+}
+
+/*!
+   En/Disable caching of the calculated points
+
+   When caching is disabled the points are calculated on
+   each call of sample(), like in QwtSyntheticPointData.
+   The cache is enabled by default.
+
+   \param on On/Off
+   \sa isCacheEnabled(), invalidateCache()
+ */
+void QwtCachedSyntheticPointData::setCacheEnabled( bool on )
+{
+    if ( on != d_data->isCacheEnabled )
+    {
+        d_data->isCacheEnabled = on;
+        invalidateCache();
+    }
+}
+
+/*!
+   \return True, when the points are cached
+   \sa setCacheEnabled()
+ */
+bool QwtCachedSyntheticPointData::isCacheEnabled() const
+{
+    return d_data->isCacheEnabled;
+}
+
+/*!
+   Set the number of points, that are passed together to evaluate().
+   The default setting is 1024.
+
+   \param size Block size, values < 1 are ignored
+   \sa blockSize(), evaluate()
+ */
+void QwtCachedSyntheticPointData::setBlockSize( uint size )
+{
+    if ( size > 0 )
+        d_data->blockSize = size;
+}
+
+/*!
+   \return Number of points, that are passed together to evaluate().
+   \sa setBlockSize()
+ */
+uint QwtCachedSyntheticPointData::blockSize() const
+{
+    return d_data->blockSize;
+}
+
+/*!
+   Set the number of threads, that are used for filling the cache.
+
+   As the cache is rebuilt only, when the interval or the number
+   of points has been changed, using threads makes sense for
+   expensive functions only. The default setting is 1.
+
+   \param numThreads Number of threads. If numThreads is set to 0, 
+                     the system specific ideal thread count is used.
+
+   \note evaluate() and x() are called from different threads in parallel
+   \sa evaluationThreadCount()
+ */
+void QwtCachedSyntheticPointData::setEvaluationThreadCount( uint numThreads )
+{
+    d_data->numThreads = numThreads;
+}
+
+/*!
+   \return Number of threads, that are used for filling the cache.
+   \sa setEvaluationThreadCount()
+ */
+uint QwtCachedSyntheticPointData::evaluationThreadCount() const
+{
+    return d_data->numThreads;
+}
+
+/*!
+   Invalidate the cached points
+
+   Changes of the interval, the rectangle of interest or the size
+   are detected automatically. But when the function itself has been
+   changed, the cache needs to be invalidated manually.
+ */
+void QwtCachedSyntheticPointData::invalidateCache()
+{
+    d_data->isValid = false;
+    d_data->x.clear();
+    d_data->y.clear();
+}
+
+/*!
+   \return Bounding rectangle of the cached points
+   \sa QwtSyntheticPointData::boundingRect()
+ */
+QRectF QwtCachedSyntheticPointData::boundingRect() const
+{
+    if ( !updateCache() )
+        return QwtSyntheticPointData::boundingRect();
+
+    return d_data->boundingRect;
+}
+
+/*!
+   \param index Index
+   \return Cached point at position index
+   \sa QwtSyntheticPointData::sample()
+ */
+QPointF QwtCachedSyntheticPointData::sample( size_t index ) const
+{
+    if ( !updateCache() )
+        return QwtSyntheticPointData::sample( index );
+
+    if ( index >= d_data->cachedSize )
+        return QPointF( 0, 0 );
+
+    return QPointF( d_data->x[ int( index ) ], d_data->y[ int( index ) ] );
+}
+
+/*!
+   \param stride Returns 1
+   \return Cached x coordinates, or NULL when caching is disabled
+ */
+const double *QwtCachedSyntheticPointData::xColumn( size_t &stride ) const
+{
+    stride = 1;
+    return updateCache() ? d_data->x.constData() : NULL;
+}
+
+/*!
+   \param stride Returns 1
+   \return Cached y coordinates, or NULL when caching is disabled
+ */
+const double *QwtCachedSyntheticPointData::yColumn( size_t &stride ) const
+{
+    stride = 1;
+    return updateCache() ? d_data->y.constData() : NULL;
+}
+
+/*!
+   \brief Calculate a block of y values
+
+   The default implementation calls y() for each value.
+
+   \param x Array of x values
+   \param y Array for the calculated y values
+   \param count Number of values
+ */
+void QwtCachedSyntheticPointData::evaluate( 
+    const double *x, double *y, size_t count ) const
+{
+    for ( size_t i = 0; i < count; i++ )
+        y[i] = this->y( x[i] );
+}
+
+void QwtCachedSyntheticPointData::evaluateRange( 
+    size_t from, size_t count, double *x, double *y ) const
+{
+    const size_t blockSize = d_data->blockSize;
+
+    for ( size_t i = 0; i < count; i += blockSize )
+    {
+        const size_t n = qMin( blockSize, count - i );
+
+        for ( size_t j = 0; j < n; j++ )
+            x[i + j] = this->x( uint( from + i + j ) );
+
+        evaluate( x + i, y + i, n );
+    }
+}
+
+bool QwtCachedSyntheticPointData::updateCache() const
+{
+    if ( !d_data->isCacheEnabled )
+        return false;
+
+    QwtInterval interval = this->interval();
+    if ( !interval.isValid() )
+    {
+        const QRectF &rect = rectOfInterest();
+        interval = QwtInterval( rect.left(), rect.right() ).normalized();
+    }
+
+    const size_t numPoints = interval.isValid() ? size() : 0;
+
+    if ( d_data->isValid && numPoints == d_data->cachedSize
+        && interval == d_data->cachedInterval )
+    {
+        return true;
+    }
+
+    d_data->x.resize( int( numPoints ) );
+    d_data->y.resize( int( numPoints ) );
+
+    double *x = d_data->x.data();
+    double *y = d_data->y.data();
+
+#if !defined(QT_NO_QFUTURE)
+    uint numThreads = d_data->numThreads;
+
+    if ( numThreads <= 0 )
+        numThreads = QThread::idealThreadCount();
+
+    if ( numThreads <= 0 )
+        numThreads = 1;
+
+    // not worth to start threads for less than a few blocks
+    numThreads = qMin( numThreads, 
+        uint( numPoints / d_data->blockSize ) + 1 );
+
+    const size_t numChunk = numPoints / numThreads;
+
+    QList< QFuture<void> > futures;
+    for ( uint i = 0; i < numThreads; i++ )
+    {
+        const size_t from = i * numChunk;
+        if ( i == numThreads - 1 )
+        {
+            evaluateRange( from, numPoints - from, x + from, y + from );
+        }
+        else
+        {
+            futures += QtConcurrent::run( this, 
+                &QwtCachedSyntheticPointData::evaluateRange,
+                from, numChunk, x + from, y + from );
+        }
+    }
+    for ( int i = 0; i < futures.size(); i++ )
+        futures[i].waitForFinished();
+#else
+    evaluateRange( 0, numPoints, x, y );
+#endif
+
+    d_data->boundingRect = QRectF( 1.0, 1.0, -2.0, -2.0 ); // invalid
+    if ( numPoints > 0 )
+    {
+        double minX = x[0];
+        double maxX = x[0];
+        double minY = y[0];
+        double maxY = y[0];
+
+        for ( size_t i = 1; i < numPoints; i++ )
+        {
+            minX = qMin( minX, x[i] );
+            maxX = qMax( maxX, x[i] );
+            minY = qMin( minY, y[i] );
+            maxY = qMax( maxY, y[i] );
+        }
+
+        d_data->boundingRect = 
+            QRectF( minX, minY, maxX - minX, maxY - minY );
+    }
+
+    d_data->cachedInterval = interval;
+    d_data->cachedSize = numPoints;
+    d_data->isValid = true;
+
+    return true;
+}
+
+class QwtLevelOfDetailPointData::PrivateData
+{
+public:
+    PrivateData():
+        series( NULL ),
+        tolerance( 0.0 ),
+        relativeTolerance( 0.0 )
+    {
+    }
+
+    ~PrivateData()
+    {
+        delete series;
+    }
+
+    QwtSeriesData<QPointF> *series;
+
+    double tolerance;
+    double relativeTolerance;
+
+    // significance of each point
+    QVector<double> significance;
+
+    // indices sorted by decreasing significance and 
+    // the corresponding significance values
+    QVector<int> order;
+    QVector<double> orderedSignificance;
+
+    // indices of the current selection in increasing order
+    QVector<int> selection;
+};
+
+struct QwtSignificanceSegment
+{
+    int from;
+    int to;
+    double maxSignificance;
+};
+
+static inline double qwtVerticalDistance( 
+    const QPointF &p1, const QPointF &p2, const QPointF &p )
+{
+    const double dx = p2.x() - p1.x();
+    if ( dx == 0.0 )
+    {
+        // distance from the vertical line between p1 and p2
+
+        const double y1 = qMin( p1.y(), p2.y() );
+        const double y2 = qMax( p1.y(), p2.y() );
+
+        if ( p.y() < y1 )
+            return y1 - p.y();
+
+        if ( p.y() > y2 )
+            return p.y() - y2;
+
+        return 0.0;
+    }
+
+    const double y = p1.y() + ( p.x() - p1.x() ) * ( p2.y() - p1.y() ) / dx;
+    return qAbs( p.y() - y );
+}
+
+/*!
+  Constructor
+
+  \param series Series to be decorated. 
+                The ownership of the series is passed to 
+                QwtLevelOfDetailPointData.
+
+  \note The samples of series must not change after
+        the significance has been calculated in the constructor.
+ */
+QwtLevelOfDetailPointData::QwtLevelOfDetailPointData( 
+    QwtSeriesData<QPointF> *series )
+{
+    d_data = new PrivateData;
+    d_data->series = series;
+
+    computeSignificance();
+    updateSelection();
+}
+
+//! Destructor
+QwtLevelOfDetailPointData::~QwtLevelOfDetailPointData()
+{
+    delete d_data;
+}
+
+//! \return Decorated series
+const QwtSeriesData<QPointF> *QwtLevelOfDetailPointData::series() const
+{
+    return d_data->series;
+}
+
+/*!
+  \brief Set the tolerance in data coordinates
+
+  All points with a significance above the tolerance are offered
+  by sample(). A tolerance < 0.0 selects all points.
+  The default setting is 0.0, what drops collinear points only.
+
+  \param tolerance Tolerance in y direction, in data coordinates
+  \sa tolerance(), setRelativeTolerance()
+ */
+void QwtLevelOfDetailPointData::setTolerance( double tolerance )
+{
+    if ( tolerance != d_data->tolerance )
+    {
+        d_data->tolerance = tolerance;
+        updateSelection();
+    }
+}
+
+/*!
+  \return Tolerance in data coordinates
+  \sa setTolerance()
+ */
+double QwtLevelOfDetailPointData::tolerance() const
+{
+    return d_data->tolerance;
+}
+
+/*!
+  \brief Set a tolerance relative to the rectangle of interest
+
+  When the relative tolerance is > 0.0 the tolerance is adjusted
+  to relativeTolerance * rect.height(), whenever the rectangle of
+  interest is changed - what happens, when the scales of the plot 
+  have changed.
+
+  The default setting is 0.0, what disables the adjustment.
+
+  \param tolerance Tolerance as a fraction of the height 
+                   of the rectangle of interest
+  \sa relativeTolerance(), setTolerance(), setRectOfInterest()
+ */
+void QwtLevelOfDetailPointData::setRelativeTolerance( double tolerance )
+{
+    d_data->relativeTolerance = qMax( tolerance, 0.0 );
+}
+
+/*!
+  \return Tolerance relative to the rectangle of interest
+  \sa setRelativeTolerance()
+ */
+double QwtLevelOfDetailPointData::relativeTolerance() const
+{
+    return d_data->relativeTolerance;
+}
+
+/*!
+  \param index Index of a point of the decorated series
+  \return Tolerance, where the point becomes significant
+ */
+double QwtLevelOfDetailPointData::significance( size_t index ) const
+{
+    if ( index >= static_cast<size_t>( d_data->significance.size() ) )
+        return 0.0;
+
+    return d_data->significance[ static_cast<int>( index ) ];
+}
+
+/*!
+  \return Number of points, that are significant 
+          for the current tolerance
+ */
+size_t QwtLevelOfDetailPointData::size() const
+{
+    return d_data->selection.size();
+}
+
+/*!
+  \param i Index
+  \return i-th significant point of the decorated series
+ */
+QPointF QwtLevelOfDetailPointData::sample( size_t i ) const
+{
+    return d_data->series->sample( 
+        d_data->selection[ static_cast<int>( i ) ] );
+}
+
+/*!
+  \return Bounding rectangle of the decorated series
+
+  The bounding rectangle doesn't depend on the tolerance, 
+  so that autoscaling is not affected by the level of detail.
+ */
+QRectF QwtLevelOfDetailPointData::boundingRect() const
+{
+    return d_data->series->boundingRect();
+}
+
+/*!
+  Adjust the tolerance, when a relative tolerance has been set
+  and pass the rectangle to the decorated series.
+
+  \param rect Rectangle of interest
+  \sa setRelativeTolerance()
+ */
+void QwtLevelOfDetailPointData::setRectOfInterest( const QRectF &rect )
+{
+    d_data->series->setRectOfInterest( rect );
+
+    if ( d_data->relativeTolerance > 0.0 && rect.height() > 0.0 )
+        setTolerance( d_data->relativeTolerance * rect.height() );
+}
+
+void QwtLevelOfDetailPointData::computeSignificance()
+{
+    const int numPoints = static_cast<int>( d_data->series->size() );
+
+    QVector<double> &significance = d_data->significance;
+    significance.fill( 0.0, numPoints );
+
+    if ( numPoints <= 0 )
+        return;
+
+    const double maxSignificance = std::numeric_limits<double>::max();
+
+    QVector<QPointF> points( numPoints );
+    for ( int i = 0; i < numPoints; i++ )
+        points[i] = d_data->series->sample( i );
+
+    const QPointF *p = points.constData();
+
+    significance[0] = maxSignificance;
+    significance[numPoints - 1] = maxSignificance;
+
+    /*
+        The significance of a point is limited by the significance 
+        of the point, that has split the segment. So any threshold 
+        results in a subset, that is identical to running the 
+        Douglas Peucker algorithm with this tolerance.
+     */
+
+    QVector<QwtSignificanceSegment> stack;
+
+    const QwtSignificanceSegment segment = 
+        { 0, numPoints - 1, maxSignificance };
+    stack += segment;
+
+    while ( !stack.isEmpty() )
+    {
+        const QwtSignificanceSegment s = stack.last();
+        stack.removeLast();
+
+        if ( s.to - s.from < 2 )
+            continue;
+
+        const QPointF &p1 = p[s.from];
+        const QPointF &p2 = p[s.to];
+
+        double maxDist = -1.0;
+        int nVertexIndexMaxDistance = s.from + 1;
+
+        for ( int i = s.from + 1; i < s.to; i++ )
+        {
+            const double dist = qwtVerticalDistance( p1, p2, p[i] );
+            if ( dist > maxDist )
+            {
+                maxDist = dist;
+                nVertexIndexMaxDistance = i;
+            }
+        }
+
+        const double sig = qMin( maxDist, s.maxSignificance );
+        significance[nVertexIndexMaxDistance] = sig;
+
+        const QwtSignificanceSegment s1 = 
+            { s.from, nVertexIndexMaxDistance, sig };
+        const QwtSignificanceSegment s2 = 
+            { nVertexIndexMaxDistance, s.to, sig };
+
+        stack += s1;
+        stack += s2;
+    }
+
+    QVector< QPair<double, int> > ranking( numPoints );
+    for ( int i = 0; i < numPoints; i++ )
+        ranking[i] = qMakePair( -significance[i], i );
+
+    qSort( ranking );
+
+    d_data->order.resize( numPoints );
+    d_data->orderedSignificance.resize( numPoints );
+
+    for ( int i = 0; i < numPoints; i++ )
+    {
+        d_data->order[i] = ranking[i].second;
+        d_data->orderedSignificance[i] = -ranking[i].first;
+    }
+}
+
+void QwtLevelOfDetailPointData::updateSelection()
+{
+    const QVector<double> &sig = d_data->orderedSignificance;
+
+    // the number of points with a significance > tolerance
+
+    const QVector<double>::const_iterator it = qLowerBound( 
+        sig.constBegin(), sig.constEnd(), 
+        d_data->tolerance, qGreater<double>() );
+    const int count = it - sig.constBegin();
+
+    d_data->selection = d_data->order.mid( 0, count );
+    qSort( d_data->selection );
+}
@@ -27,6 +27,9 @@ public:
     virtual size_t size() const;
     virtual QPointF sample( size_t i ) const;
 
+    virtual const double *xColumn( size_t &stride ) const;
+    virtual const double *yColumn( size_t &stride ) const;
+
     const QVector<double> &xData() const;
     const QVector<double> &yData() const;
 
@@ -37,23 +40,37 @@ private:
 
 /*!
   \brief Data class containing two pointers to memory blocks of doubles.
+
+  The memory is not copied, what makes QwtCPointerData an adaptor 
+  for columnar buffers of other libraries ( f.e numpy arrays ). 
+  Strided memory layouts are supported as well.
  */
 class QWT_EXPORT QwtCPointerData: public QwtSeriesData<QPointF>
 {
 public:
     QwtCPointerData( const double *x, const double *y, size_t size );
+    QwtCPointerData( const double *x, const double *y, size_t size,
+        size_t xStride, size_t yStride );
 
     virtual QRectF boundingRect() const;
     virtual size_t size() const;
     virtual QPointF sample( size_t i ) const;
 
+    virtual const double *xColumn( size_t &stride ) const;
+    virtual const double *yColumn( size_t &stride ) const;
+
     const double *xData() const;
     const double *yData() const;
 
+    size_t xStride() const;
+    size_t yStride() const;
+
 private:
     const double *d_x;
     const double *d_y;
     size_t d_size;
+    size_t d_xStride;
+    size_t d_yStride;
 };
 
 /*!
@@ -143,4 +160,221 @@ private:
     QwtInterval d_intervalOfInterest;
 };
 
+/*!
+  \brief Synthetic point data with cached evaluation
+
+  QwtCachedSyntheticPointData evaluates the points in blocks and
+  stores them, so that they are calculated only once for the current 
+  interval and size - instead of on every replot and for every 
+  call of boundingRect(). The cached values are offered as columns
+  ( xColumn(), yColumn() ), so that they can be mapped without
+  calling sample() for each point.
+
+  For expensive functions the blocks can be evaluated in parallel.
+
+  \sa QwtFunctorPointData
+ */
+class QWT_EXPORT QwtCachedSyntheticPointData: public QwtSyntheticPointData
+{
+public:
+    QwtCachedSyntheticPointData( size_t size,
+        const QwtInterval & = QwtInterval() );
+
+    virtual ~QwtCachedSyntheticPointData();
+
+    void setCacheEnabled( bool );
+    bool isCacheEnabled() const;
+
+    void setBlockSize( uint );
+    uint blockSize() const;
+
+    void setEvaluationThreadCount( uint numThreads );
+    uint evaluationThreadCount() const;
+
+    void invalidateCache();
+
+    virtual QRectF boundingRect() const;
+    virtual QPointF sample( size_t i ) const;
+
+    virtual const double *xColumn( size_t &stride ) const;
+    virtual const double *yColumn( size_t &stride ) const;
+
+protected:
+    virtual void evaluate( const double *x, double *y, size_t count ) const;
+
+private:
+    bool updateCache() const;
+    void evaluateRange( size_t from, size_t count, 
+        double *x, double *y ) const;
+
+    class PrivateData;
+    PrivateData *d_data;
+};
+
+/*!
+  \brief Synthetic point data calculated by a functor
+
+  QwtFunctorPointData calculates the y values by any callable object
+  - a function pointer or an object with an "double operator()( double ) const".
+  As the functor is called inside of evaluate() it can be inlined
+  by the compiler, what avoids a virtual call for each point.
+
+  \par Example
+
+  \code
+#include <qwt_point_data.h>
+#include <qmath.h>
+
+class Gauss
+{
+public:
+    Gauss( double sigma ):
+        d_sigma( sigma )
+    {
+    }
+
+    double operator()( double x ) const
+    {
+        return qExp( -0.5 * x * x / ( d_sigma * d_sigma ) );
+    }
+
+private:
+    double d_sigma;
+};
+
+QwtPlotCurve *curve = new QwtPlotCurve();
+curve->setData( new QwtFunctorPointData<Gauss>( Gauss( 2.0 ), 1000 ) );
+  \endcode
+
+  \note When setEvaluationThreadCount() != 1 the functor is called
+        from different threads in parallel.
+ */
+template <typename Function>
+class QwtFunctorPointData: public QwtCachedSyntheticPointData
+{
+public:
+    /*!
+       Constructor
+
+       \param function Callable object, calculating y from x
+       \param size Number of points
+       \param interval Bounding interval for the points
+     */
+    QwtFunctorPointData( const Function &function, size_t size, 
+            const QwtInterval &interval = QwtInterval() ):
+        QwtCachedSyntheticPointData( size, interval ),
+        d_function( function )
+    {
+    }
+
+    /*!
+       Assign a functor and invalidate the cache
+       \param function Callable object, calculating y from x
+     */
+    void setFunction( const Function &function )
+    {
+        d_function = function;
+        invalidateCache();
+    }
+
+    //! \return Functor
+    const Function &function() const
+    {
+        return d_function;
+    }
+
+    /*!
+       Calculate a y value for a x value
+       \param x x value
+       \return function()( x )
+     */
+    virtual double y( double x ) const
+    {
+        return d_function( x );
+    }
+
+protected:
+    /*!
+       Calculate a block of y values
+       \param x Array of x values
+       \param y Array for the calculated y values
+       \param count Number of values
+     */
+    virtual void evaluate( const double *x, double *y, size_t count ) const
+    {
+        for ( size_t i = 0; i < count; i++ )
+            y[i] = d_function( x[i] );
+    }
+
+private:
+    Function d_function;
+};
+
+/*!
+  \brief Level of detail decorator for a series of points
+
+  QwtLevelOfDetailPointData runs the Douglas and Peucker algorithm
+  once - in data space - for the complete series and stores for each 
+  point the tolerance, where it becomes significant. Then a subset
+  of points for any tolerance can be extracted without simplifying
+  the points again, what makes it possible to paint huge series 
+  with a level of detail, that matches the current zoom level.
+
+  The significance of a point is the vertical distance to the line
+  between the points, that have been found before. As the vertical
+  distance is never below the perpendicular distance in screen 
+  coordinates, the simplified curve deviates by less than tolerance() 
+  from the original curve - in y direction. The algorithm is
+  intended for series with increasing x coordinates.
+
+  The tolerance can be set explicitly ( setTolerance() ) or relative 
+  to the height of the rectangle of interest ( setRelativeTolerance() ),
+  what adjusts it to the scales of the plot automatically.
+
+  \par Example
+  \code
+QwtLevelOfDetailPointData *data = 
+    new QwtLevelOfDetailPointData( new QwtPointArrayData( x, y ) );
+
+// ~ 1 pixel for a canvas of 1000 pixels
+data->setRelativeTolerance( 0.001 ); 
+
+QwtPlotCurve *curve = new QwtPlotCurve();
+curve->setData( data );
+  \endcode
+
+  \note The computation of the significance is O( n * log( n ) ) 
+        for typical data, but O( n * n ) in the worst case.
+  \sa QwtWeedingCurveFitter
+ */
+class QWT_EXPORT QwtLevelOfDetailPointData: public QwtSeriesData<QPointF>
+{
+public:
+    explicit QwtLevelOfDetailPointData( QwtSeriesData<QPointF> *series );
+    virtual ~QwtLevelOfDetailPointData();
+
+    const QwtSeriesData<QPointF> *series() const;
+
+    void setTolerance( double );
+    double tolerance() const;
+
+    void setRelativeTolerance( double );
+    double relativeTolerance() const;
+
+    double significance( size_t index ) const;
+
+    virtual size_t size() const;
+    virtual QPointF sample( size_t i ) const;
+    virtual QRectF boundingRect() const;
+
+    virtual void setRectOfInterest( const QRectF & );
+
+private:
+    void computeSignificance();
+    void updateSelection();
+
+    class PrivateData;
+    PrivateData *d_data;
+};
+
 #endif
@@ -10,6 +10,7 @@
 #include "qwt_point_mapper.h"
 #include "qwt_scale_map.h"
 #include "qwt_pixel_matrix.h"
+#include "qwt_scratch_arena.h"
 #include <qpolygon.h>
 #include <qimage.h>
 #include <qpen.h>
@@ -40,6 +41,30 @@ static inline double qwtRoundValueF( double value )
 #endif
 }
 
+template <class Polygon>
+static inline Polygon qwtScratchPolygon( int size )
+{
+    // reusing the memory of polygons from previous paint operations
+    Polygon polygon;
+    QwtScratchArena::instance()->acquire( size, polygon );
+
+    return polygon;
+}
+
+template <class Polygon>
+static inline void qwtSqueezePolygon( 
+    QwtPointMapper::TransformationFlags flags, Polygon &polygon )
+{
+    /*
+      The polygon is returned to the application, that might keep it.
+      When it has shrunk - f.e. by filtering - the points are copied
+      and the large buffer goes back to the arena. Callers, that
+      release the polygon themselves, don't need the copy.
+     */
+    if ( !( flags & QwtPointMapper::ScratchBuffers ) )
+        QwtScratchArena::instance()->squeeze( polygon );
+}
+
 static Qt::Orientation qwtProbeOrientation(
     const QwtSeriesData<QPointF> *series, int from, int to )
 {
@@ -49,8 +74,10 @@ static Qt::Orientation qwtProbeOrientation(
         return Qt::Horizontal;
     }
 
-    const double x0 = series->sample( from ).x();
-    const double xn = series->sample( to ).x();
+    const QwtPointColumns columns( series );
+
+    const double x0 = columns.x( from );
+    const double xn = columns.x( to );
 
     if ( x0 == xn )
         return Qt::Vertical;
@@ -61,7 +88,7 @@ static Qt::Orientation qwtProbeOrientation(
     double x1 = x0;
     for ( int i = from + step; i < to; i += step )
     {
-        const double x2 = series->sample( i ).x();
+        const double x2 = columns.x( i );
         if ( x2 != x1 )
         {
             if ( ( x2 > x1 ) != isIncreasing )
@@ -181,7 +208,9 @@ template <class Polygon, class Point, class PolygonQuadrupel>
 static Polygon qwtMapPointsQuad( const QwtScaleMap &xMap, const QwtScaleMap &yMap,
     const QwtSeriesData<QPointF> *series, int from, int to )
 {
-    const QPointF sample0 = series->sample( from );
+    const QwtPointColumns columns( series );
+
+    const QPointF sample0 = columns.sample( from );
 
     PolygonQuadrupel q;
     q.start( qwtRoundValue( xMap.transform( sample0.x() ) ),
@@ -190,7 +219,7 @@ static Polygon qwtMapPointsQuad( const QwtScaleMap &xMap, const QwtScaleMap &yMa
     Polygon polyline;
     for ( int i = from; i <= to; i++ )
     {
-        const QPointF sample = series->sample( i );
+        const QPointF sample = columns.sample( i );
 
         const int x = qwtRoundValue( xMap.transform( sample.x() ) );
         const int y = qwtRoundValue( yMap.transform( sample.y() ) );
@@ -296,9 +325,11 @@ static void qwtRenderDots(
     const int x0 = pos.x();
     const int y0 = pos.y();
 
+    const QwtPointColumns columns( command.series );
+
     for ( int i = command.from; i <= command.to; i++ )
     {
-        const QPointF sample = command.series->sample( i );
+        const QPointF sample = columns.sample( i );
 
         const int x = static_cast<int>( xMap.transform( sample.x() ) + 0.5 ) - x0;
         const int y = static_cast<int>( yMap.transform( sample.y() ) + 0.5 ) - y0;
@@ -343,9 +374,11 @@ static inline Polygon qwtToPoints(
     const QwtSeriesData<QPointF> *series, 
     int from, int to, Round round )
 {
-    Polygon polyline( to - from + 1 );
+    Polygon polyline = qwtScratchPolygon<Polygon>( to - from + 1 );
     Point *points = polyline.data();
 
+    const QwtPointColumns columns( series );
+
     int numPoints = 0;
 
     if ( boundingRect.isValid() )
@@ -356,7 +389,7 @@ static inline Polygon qwtToPoints(
 
         for ( int i = from; i <= to; i++ )
         {
-            const QPointF sample = series->sample( i );
+            const QPointF sample = columns.sample( i );
 
             const double x = xMap.transform( sample.x() );
             const double y = yMap.transform( sample.y() );
@@ -379,7 +412,7 @@ static inline Polygon qwtToPoints(
 
         for ( int i = from; i <= to; i++ )
         {
-            const QPointF sample = series->sample( i );
+            const QPointF sample = columns.sample( i );
 
             const double x = xMap.transform( sample.x() );
             const double y = yMap.transform( sample.y() );
@@ -429,10 +462,12 @@ static inline Polygon qwtToPolylineFiltered(
     // result in empty lines ( or symbols hidden by others )
     // we try to filter them out
 
-    Polygon polyline( to - from + 1 );
+    Polygon polyline = qwtScratchPolygon<Polygon>( to - from + 1 );
     Point *points = polyline.data();
 
-    const QPointF sample0 = series->sample( from );
+    const QwtPointColumns columns( series );
+
+    const QPointF sample0 = columns.sample( from );
 
     points[0].rx() = round( xMap.transform( sample0.x() ) );
     points[0].ry() = round( yMap.transform( sample0.y() ) );
@@ -440,7 +475,7 @@ static inline Polygon qwtToPolylineFiltered(
     int pos = 0;
     for ( int i = from + 1; i <= to; i++ )
     {
-        const QPointF sample = series->sample( i );
+        const QPointF sample = columns.sample( i );
 
         const Point p( round( xMap.transform( sample.x() ) ),
             round( yMap.transform( sample.y() ) ) );
@@ -450,6 +485,7 @@ static inline Polygon qwtToPolylineFiltered(
     }
 
     polyline.resize( pos + 1 );
+
     return polyline;
 }
 
@@ -481,15 +517,17 @@ static inline Polygon qwtToPointsFiltered(
     // F.e. in scatter plots ( no connecting lines ) we
     // can sort out all duplicates ( not only consecutive points )
 
-    Polygon polygon( to - from + 1 );
+    Polygon polygon = qwtScratchPolygon<Polygon>( to - from + 1 );
     Point *points = polygon.data();
 
     QwtPixelMatrix pixelMatrix( boundingRect.toAlignedRect() );
 
+    const QwtPointColumns columns( series );
+
     int numPoints = 0;
     for ( int i = from; i <= to; i++ )
     {
-        const QPointF sample = series->sample( i );
+        const QPointF sample = columns.sample( i );
 
         const int x = qwtRoundValue( xMap.transform( sample.x() ) );
         const int y = qwtRoundValue( yMap.transform( sample.y() ) );
@@ -504,6 +542,7 @@ static inline Polygon qwtToPointsFiltered(
     }
 
     polygon.resize( numPoints );
+
     return polygon;
 }
 
@@ -525,6 +564,186 @@ static inline QPolygonF qwtToPointsFilteredF(
         boundingRect, xMap, yMap, series, from, to );
 }
 
+// Clamping a polyline to a rectangle in one pass. Each segment is
+// split at the lines of the rectangle and all points are clamped
+// to the rectangle. So the parts outside are moved to the border,
+// what is the same as clipping, as long as the border is not visible.
+// As the winding number of any point inside is not affected
+// the result can be filled as well.
+
+class QwtPolylineClamper
+{
+public:
+    QwtPolylineClamper( const QRectF &rect, QPolygonF &polyline ):
+        d_x1( rect.left() ),
+        d_x2( rect.right() ),
+        d_y1( rect.top() ),
+        d_y2( rect.bottom() ),
+        d_polyline( polyline ),
+        d_count( 0 )
+    {
+        d_points = d_polyline.data();
+    }
+
+    inline void start( const QPointF &pos )
+    {
+        append( clamped( pos ) );
+        d_last = pos;
+    }
+
+    inline void lineTo( const QPointF &pos )
+    {
+        if ( isInside( pos ) && isInside( d_last ) )
+        {
+            append( pos );
+        }
+        else
+        {
+            double t[4];
+            int numSplits = 0;
+
+            addSplit( d_last.x(), pos.x(), d_x1, t, numSplits );
+            addSplit( d_last.x(), pos.x(), d_x2, t, numSplits );
+            addSplit( d_last.y(), pos.y(), d_y1, t, numSplits );
+            addSplit( d_last.y(), pos.y(), d_y2, t, numSplits );
+
+            if ( numSplits > 1 )
+                qSort( t, t + numSplits );
+
+            const double dx = pos.x() - d_last.x();
+            const double dy = pos.y() - d_last.y();
+
+            for ( int i = 0; i < numSplits; i++ )
+            {
+                const QPointF p( d_last.x() + t[i] * dx, 
+                    d_last.y() + t[i] * dy );
+
+                append( clamped( p ) );
+            }
+
+            append( clamped( pos ) );
+        }
+
+        d_last = pos;
+    }
+
+    inline void finish()
+    {
+        d_polyline.resize( d_count );
+    }
+
+private:
+    inline bool isInside( const QPointF &pos ) const
+    {
+        return pos.x() >= d_x1 && pos.x() <= d_x2
+            && pos.y() >= d_y1 && pos.y() <= d_y2;
+    }
+
+    inline QPointF clamped( const QPointF &pos ) const
+    {
+        return QPointF( qBound( d_x1, pos.x(), d_x2 ),
+            qBound( d_y1, pos.y(), d_y2 ) );
+    }
+
+    inline bool isOnBorder( const QPointF &p1, 
+        const QPointF &p2, const QPointF &p3 ) const
+    {
+        if ( p1.x() == p2.x() && p2.x() == p3.x() )
+            return p1.x() == d_x1 || p1.x() == d_x2;
+
+        if ( p1.y() == p2.y() && p2.y() == p3.y() )
+            return p1.y() == d_y1 || p1.y() == d_y2;
+
+        return false;
+    }
+
+    static inline void addSplit( double v1, double v2, double value,
+        double t[4], int &numSplits )
+    {
+        if ( ( v1 < value && v2 > value ) || ( v1 > value && v2 < value ) )
+            t[ numSplits++ ] = ( value - v1 ) / ( v2 - v1 );
+    }
+
+    inline void append( const QPointF &pos )
+    {
+        if ( d_count > 0 )
+        {
+            if ( d_points[d_count - 1] == pos )
+                return;
+
+            // weeding out points on the invisible border
+
+            if ( d_count > 1 && isOnBorder( 
+                d_points[d_count - 2], d_points[d_count - 1], pos ) )
+            {
+                if ( d_points[d_count - 2] == pos )
+                    d_count--;
+                else
+                    d_points[d_count - 1] = pos;
+
+                return;
+            }
+        }
+
+        if ( d_count >= d_polyline.size() )
+        {
+            d_polyline.resize( qMax( 2 * d_count, 16 ) );
+            d_points = d_polyline.data();
+        }
+
+        d_points[d_count++] = pos;
+    }
+
+    const double d_x1;
+    const double d_x2;
+    const double d_y1;
+    const double d_y2;
+
+    QPolygonF &d_polyline;
+    QPointF *d_points;
+    int d_count;
+
+    QPointF d_last;
+};
+
+template<class Round>
+static inline void qwtToClampedPolylineF( 
+    const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+    const QwtSeriesData<QPointF> *series, int from, int to, 
+    const QRectF &clipRect, bool weedOut, Round round, 
+    QPolygonF &polyline )
+{
+    const QwtPointColumns columns( series );
+
+    if ( polyline.size() < to - from + 1 )
+        polyline.resize( to - from + 1 );
+
+    QwtPolylineClamper clamper( clipRect, polyline );
+
+    const QPointF sample0 = columns.sample( from );
+
+    QPointF last( round( xMap.transform( sample0.x() ) ),
+        round( yMap.transform( sample0.y() ) ) );
+
+    clamper.start( last );
+
+    for ( int i = from + 1; i <= to; i++ )
+    {
+        const QPointF sample = columns.sample( i );
+
+        const QPointF p( round( xMap.transform( sample.x() ) ),
+            round( yMap.transform( sample.y() ) ) );
+
+        if ( weedOut && p == last )
+            continue;
+
+        clamper.lineTo( p );
+        last = p;
+    }
+
+    clamper.finish();
+}
+
 class QwtPointMapper::PrivateData
 {
 public:
@@ -676,9 +895,63 @@ QPolygonF QwtPointMapper::toPolygonF(
         }
     }
 
+    qwtSqueezePolygon( d_data->flags, polyline );
+
     return polyline;
 }
 
+/*!
+  \brief Translate a series of points into a clipped polyline
+
+  The points are translated, clipped against a rectangle and weeded
+  in one pass - without any intermediate polygons. The parts of
+  the polyline outside of the rectangle are moved to its border, 
+  so that the result can be filled too.
+
+  As the result is written to a buffer passed by the application,
+  its memory can be reused for each paint operation.
+
+  RoundPoints and WeedOutPoints are respected, WeedOutIntermediatePoints
+  is ignored. Consecutive points on the same line of the border
+  are always reduced to the end points.
+
+  \param xMap x map
+  \param yMap y map
+  \param series Series of points to be mapped
+  \param from Index of the first point to be painted
+  \param to Index of the last point to be painted
+  \param clipRect Clip rectangle, usually the rectangle of the canvas 
+                  expanded by the width of the pen, so that its
+                  border is not visible
+  \param polyline Buffer for the translated polyline
+
+  \sa toPolygonF(), QwtClipper::clipPolygonF()
+*/
+void QwtPointMapper::toPolylineF(
+    const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+    const QwtSeriesData<QPointF> *series, int from, int to,
+    const QRectF &clipRect, QPolygonF &polyline ) const
+{
+    if ( from > to || !clipRect.isValid() )
+    {
+        polyline.resize( 0 );
+        return;
+    }
+
+    const bool weedOut = d_data->flags & WeedOutPoints;
+
+    if ( d_data->flags & RoundPoints )
+    {
+        qwtToClampedPolylineF( xMap, yMap, series, from, to, 
+            clipRect, weedOut, QwtRoundF(), polyline );
+    }
+    else
+    {
+        qwtToClampedPolylineF( xMap, yMap, series, from, to, 
+            clipRect, weedOut, QwtNoRoundF(), polyline );
+    }
+}
+
 /*!
   \brief Translate a series of points into a QPolygon
 
@@ -716,6 +989,8 @@ QPolygon QwtPointMapper::toPolygon(
             qwtInvalidRect, xMap, yMap, series, from, to );
     }
 
+    qwtSqueezePolygon( d_data->flags, polyline );
+
     return polyline;
 }
 
@@ -798,6 +1073,8 @@ QPolygonF QwtPointMapper::toPointsF(
         }
     }
 
+    qwtSqueezePolygon( d_data->flags, points );
+
     return points;
 }
 
@@ -852,6 +1129,8 @@ QPolygon QwtPointMapper::toPoints(
             d_data->boundingRect, xMap, yMap, series, from, to );
     }
 
+    qwtSqueezePolygon( d_data->flags, points );
+
     return points;
 }
 
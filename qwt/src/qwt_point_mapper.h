@@ -62,7 +62,16 @@ public:
           As the algorithm is fast it can be used inside of 
           a polyline render cycle.
          */
-        WeedOutIntermediatePoints = 0x04
+        WeedOutIntermediatePoints = 0x04,
+
+        /*!
+          The returned polygons are buffers of QwtScratchArena, that
+          are not squeezed. The caller has to pass them back with
+          QwtScratchArena::release(), when they are not needed anymore.
+          Otherwise their memory, that might be much larger than
+          the polygon, is not reused.
+         */
+        ScratchBuffers = 0x08
     };
 
     /*!  
@@ -86,6 +95,10 @@ public:
     QPolygonF toPolygonF( const QwtScaleMap &xMap, const QwtScaleMap &yMap,
         const QwtSeriesData<QPointF> *series, int from, int to ) const;
 
+    void toPolylineF( const QwtScaleMap &xMap, const QwtScaleMap &yMap,
+        const QwtSeriesData<QPointF> *series, int from, int to,
+        const QRectF &clipRect, QPolygonF &polyline ) const;
+
     QPolygon toPolygon( const QwtScaleMap &xMap, const QwtScaleMap &yMap,
         const QwtSeriesData<QPointF> *series, int from, int to ) const;
 
@@ -188,6 +188,49 @@ double QwtScaleArithmetic::divideInterval(
     return stepSize;
 }
 
+namespace
+{
+    class ScaleDivEntry
+    {
+    public:
+        double x1;
+        double x2;
+        int maxMajorSteps;
+        int maxMinorSteps;
+        double stepSize;
+
+        double effectiveStepSize;
+        QwtScaleDiv scaleDiv;
+    };
+
+    class AutoScaleEntry
+    {
+    public:
+        int maxNumSteps;
+        double x1;
+        double x2;
+
+        double alignedX1;
+        double alignedX2;
+        double stepSize;
+    };
+}
+
+/*
+  The number of results, that are remembered. As each axis
+  has its own engine a few entries are enough for finding
+  the results of the previous replots.
+ */
+static const int qwtCacheSize = 4;
+
+template <class T>
+static inline void qwtInsertEntry( QList<T> &entries, const T &entry )
+{
+    entries.prepend( entry );
+    if ( entries.size() > qwtCacheSize )
+        entries.removeLast();
+}
+
 class QwtScaleEngine::PrivateData
 {
 public:
@@ -216,6 +259,10 @@ public:
     uint base;
 
     QwtTransform* transform;
+
+    // results of previous calculations, most recent first
+    QList<ScaleDivEntry> scaleDivCache;
+    QList<AutoScaleEntry> autoScaleCache;
 };
 
 /*!
@@ -256,6 +303,8 @@ void QwtScaleEngine::setTransformation( QwtTransform *transform )
     {
         delete d_data->transform;
         d_data->transform = transform;
+
+        invalidateCache();
     }
 }
 
@@ -318,6 +367,8 @@ void QwtScaleEngine::setMargins( double lower, double upper )
 {
     d_data->lowerMargin = qMax( lower, 0.0 );
     d_data->upperMargin = qMax( upper, 0.0 );
+
+    invalidateCache();
 }
 
 /*!
@@ -424,6 +475,8 @@ void QwtScaleEngine::setAttribute( Attribute attribute, bool on )
         d_data->attributes |= attribute;
     else
         d_data->attributes &= ~attribute;
+
+    invalidateCache();
 }
 
 /*!
@@ -446,6 +499,7 @@ bool QwtScaleEngine::testAttribute( Attribute attribute ) const
 void QwtScaleEngine::setAttributes( Attributes attributes )
 {
     d_data->attributes = attributes;
+    invalidateCache();
 }
 
 /*!
@@ -469,6 +523,7 @@ QwtScaleEngine::Attributes QwtScaleEngine::attributes() const
 void QwtScaleEngine::setReference( double r )
 {
     d_data->referenceValue = r;
+    invalidateCache();
 }
 
 /*!
@@ -495,6 +550,7 @@ double QwtScaleEngine::reference() const
 void QwtScaleEngine::setBase( uint base )
 { 
     d_data->base = qMax( base, 2U );
+    invalidateCache();
 }
 
 /*!
@@ -506,6 +562,206 @@ uint QwtScaleEngine::base() const
     return d_data->base;
 }
 
+/*!
+  \brief Forget the results of previous calculations
+
+  The implementations of autoScale() and divideScale() of the engines
+  of Qwt remember their most recent results, as they are usually
+  called with the same parameters for each replot. Only the parameters
+  of the calls are compared, the state of the engine is not. So the
+  cache is invalidated, whenever an attribute of the engine is changed.
+
+  Derived classes, that have additional attributes having an effect
+  on the results - f.e. by overloading intervalType() or alignDate() 
+  of QwtDateScaleEngine - need to call invalidateCache(), when one of
+  them has been changed. Otherwise the engine keeps returning
+  results, that have been calculated with the previous setting.
+
+  \sa lookupScaleDiv(), lookupAutoScale()
+ */
+void QwtScaleEngine::invalidateCache()
+{
+    d_data->scaleDivCache.clear();
+    d_data->autoScaleCache.clear();
+}
+
+/*!
+  \brief Find the result of a previous call of divideScale()
+
+  \param x1 First interval limit
+  \param x2 Second interval limit
+  \param maxMajorSteps Maximum for the number of major steps
+  \param maxMinorSteps Maximum number of minor steps
+  \param stepSize Step size, as passed to divideScale()
+  \param scaleDiv Cached scale division
+
+  \return True, when a scale division has been found
+  \sa insertScaleDiv(), invalidateCache()
+ */
+bool QwtScaleEngine::lookupScaleDiv( double x1, double x2,
+    int maxMajorSteps, int maxMinorSteps, double stepSize,
+    QwtScaleDiv &scaleDiv ) const
+{
+    QList<ScaleDivEntry> &entries = d_data->scaleDivCache;
+
+    for ( int i = 0; i < entries.size(); i++ )
+    {
+        const ScaleDivEntry &entry = entries[i];
+
+        if ( entry.x1 == x1 && entry.x2 == x2 
+            && entry.maxMajorSteps == maxMajorSteps 
+            && entry.maxMinorSteps == maxMinorSteps 
+            && entry.stepSize == stepSize )
+        {
+            scaleDiv = entry.scaleDiv;
+
+            if ( i > 0 )
+                entries.move( i, 0 );
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*!
+  \brief Find a cached scale division, that can be scrolled 
+
+  Look for a scale division, that has been divided with the same
+  step size and number of minor steps, and that overlaps with
+  interval. Its ticks are valid for the intersection of both intervals.
+
+  \param interval Normalized interval
+  \param maxMinorSteps Maximum number of minor steps
+  \param effectiveStepSize Step size, that is used for interval
+  \param scaleDiv Cached scale division, with increasing ticks
+
+  \return True, when a scale division has been found
+  \sa lookupScaleDiv(), insertScaleDiv()
+ */
+bool QwtScaleEngine::lookupScrolledScaleDiv( const QwtInterval &interval,
+    int maxMinorSteps, double effectiveStepSize,
+    QwtScaleDiv &scaleDiv ) const
+{
+    const QList<ScaleDivEntry> &entries = d_data->scaleDivCache;
+
+    for ( int i = 0; i < entries.size(); i++ )
+    {
+        const ScaleDivEntry &entry = entries[i];
+
+        if ( entry.effectiveStepSize == effectiveStepSize
+            && entry.maxMinorSteps == maxMinorSteps 
+            && !entry.scaleDiv.isEmpty() )
+        {
+            QwtScaleDiv div = entry.scaleDiv;
+            if ( !div.isIncreasing() )
+                div.invert();
+
+            if ( div.interval().intersects( interval ) )
+            {
+                scaleDiv = div;
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+/*!
+  \brief Remember the result of divideScale()
+
+  \param x1 First interval limit
+  \param x2 Second interval limit
+  \param maxMajorSteps Maximum for the number of major steps
+  \param maxMinorSteps Maximum number of minor steps
+  \param stepSize Step size, as passed to divideScale()
+  \param scaleDiv Calculated scale division
+  \param effectiveStepSize Step size, that has been used
+         for the major ticks. 0, when the ticks can't be scrolled.
+
+  \sa lookupScaleDiv(), lookupScrolledScaleDiv()
+ */
+void QwtScaleEngine::insertScaleDiv( double x1, double x2,
+    int maxMajorSteps, int maxMinorSteps, double stepSize,
+    const QwtScaleDiv &scaleDiv, double effectiveStepSize ) const
+{
+    ScaleDivEntry entry;
+    entry.x1 = x1;
+    entry.x2 = x2;
+    entry.maxMajorSteps = maxMajorSteps;
+    entry.maxMinorSteps = maxMinorSteps;
+    entry.stepSize = stepSize;
+    entry.effectiveStepSize = effectiveStepSize;
+    entry.scaleDiv = scaleDiv;
+
+    qwtInsertEntry( d_data->scaleDivCache, entry );
+}
+
+/*!
+  \brief Find the result of a previous call of autoScale()
+
+  \param maxNumSteps Max. number of steps
+  \param x1 First limit of the interval (In/Out)
+  \param x2 Second limit of the interval (In/Out)
+  \param stepSize Step size (Out)
+
+  \return True, when a result has been found
+  \sa insertAutoScale(), invalidateCache()
+ */
+bool QwtScaleEngine::lookupAutoScale( int maxNumSteps,
+    double &x1, double &x2, double &stepSize ) const
+{
+    QList<AutoScaleEntry> &entries = d_data->autoScaleCache;
+
+    for ( int i = 0; i < entries.size(); i++ )
+    {
+        const AutoScaleEntry &entry = entries[i];
+
+        if ( entry.x1 == x1 && entry.x2 == x2 
+            && entry.maxNumSteps == maxNumSteps )
+        {
+            x1 = entry.alignedX1;
+            x2 = entry.alignedX2;
+            stepSize = entry.stepSize;
+
+            if ( i > 0 )
+                entries.move( i, 0 );
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*!
+  \brief Remember the result of autoScale()
+
+  \param maxNumSteps Max. number of steps
+  \param x1 First limit of the interval, as passed to autoScale()
+  \param x2 Second limit of the interval, as passed to autoScale()
+  \param alignedX1 First limit of the interval, returned from autoScale()
+  \param alignedX2 Second limit of the interval, returned from autoScale()
+  \param stepSize Step size, returned from autoScale()
+
+  \sa lookupAutoScale()
+ */
+void QwtScaleEngine::insertAutoScale( int maxNumSteps, double x1, double x2,
+    double alignedX1, double alignedX2, double stepSize ) const
+{
+    AutoScaleEntry entry;
+    entry.maxNumSteps = maxNumSteps;
+    entry.x1 = x1;
+    entry.x2 = x2;
+    entry.alignedX1 = alignedX1;
+    entry.alignedX2 = alignedX2;
+    entry.stepSize = stepSize;
+
+    qwtInsertEntry( d_data->autoScaleCache, entry );
+}
+
 /*!
   Constructor
 
@@ -535,6 +791,12 @@ QwtLinearScaleEngine::~QwtLinearScaleEngine()
 void QwtLinearScaleEngine::autoScale( int maxNumSteps,
     double &x1, double &x2, double &stepSize ) const
 {
+    if ( lookupAutoScale( maxNumSteps, x1, x2, stepSize ) )
+        return;
+
+    const double x10 = x1;
+    const double x20 = x2;
+
     QwtInterval interval( x1, x2 );
     interval = interval.normalized();
 
@@ -564,11 +826,18 @@ void QwtLinearScaleEngine::autoScale( int maxNumSteps,
         qSwap( x1, x2 );
         stepSize = -stepSize;
     }
+
+    insertAutoScale( maxNumSteps, x10, x20, x1, x2, stepSize );
 }
 
 /*!
    \brief Calculate a scale division for an interval
 
+   When the step size is the same as for a previous interval, that
+   overlaps with the requested interval, the ticks of the previous
+   interval are reused and only the ticks for the uncovered parts
+   are calculated ( f.e. for scrolling an axis ).
+
    \param x1 First interval limit
    \param x2 Second interval limit
    \param maxMajorSteps Maximum for the number of major steps
@@ -581,6 +850,51 @@ void QwtLinearScaleEngine::autoScale( int maxNumSteps,
 QwtScaleDiv QwtLinearScaleEngine::divideScale( double x1, double x2,
     int maxMajorSteps, int maxMinorSteps, double stepSize ) const
 {
+    QwtScaleDiv scaleDiv;
+    if ( lookupScaleDiv( x1, x2, maxMajorSteps, 
+        maxMinorSteps, stepSize, scaleDiv ) )
+    {
+        return scaleDiv;
+    }
+
+    double effectiveStepSize = 0.0;
+
+    scaleDiv = calculateScaleDiv( x1, x2, 
+        maxMajorSteps, maxMinorSteps, stepSize, effectiveStepSize );
+
+    insertScaleDiv( x1, x2, maxMajorSteps, maxMinorSteps, 
+        stepSize, scaleDiv, effectiveStepSize );
+
+    return scaleDiv;
+}
+
+/*!
+   \brief Calculate a scale division for an interval
+
+   Like divideScale(), but without looking up and remembering the
+   result. Ticks of an overlapping scale division with the same 
+   step size are reused.
+
+   \param x1 First interval limit
+   \param x2 Second interval limit
+   \param maxMajorSteps Maximum for the number of major steps
+   \param maxMinorSteps Maximum number of minor steps
+   \param stepSize Step size. If stepSize == 0, the engine
+                   calculates one.
+   \param effectiveStepSize Step size, that has been used for the
+                   major ticks. 0, when no ticks have been calculated.
+
+   \return Calculated scale division
+   \sa divideScale(), insertScaleDiv()
+*/
+QwtScaleDiv QwtLinearScaleEngine::calculateScaleDiv( double x1, double x2,
+    int maxMajorSteps, int maxMinorSteps, double stepSize,
+    double &effectiveStepSize ) const
+{
+    effectiveStepSize = 0.0;
+
+    QwtScaleDiv scaleDiv;
+
     QwtInterval interval = QwtInterval( x1, x2 ).normalized();
 
     if ( interval.widthL() > std::numeric_limits<double>::max() )
@@ -602,14 +916,24 @@ QwtScaleDiv QwtLinearScaleEngine::divideScale( double x1, double x2,
             interval.width(), maxMajorSteps, base() );
     }
 
-    QwtScaleDiv scaleDiv;
-
     if ( stepSize != 0.0 )
     {
         QList<double> ticks[QwtScaleDiv::NTickTypes];
-        buildTicks( interval, stepSize, maxMinorSteps, ticks );
+
+        QwtScaleDiv scrolledDiv;
+        if ( lookupScrolledScaleDiv( interval, 
+            maxMinorSteps, stepSize, scrolledDiv ) )
+        {
+            buildScrolledTicks( scrolledDiv, interval, 
+                stepSize, maxMinorSteps, ticks );
+        }
+        else
+        {
+            buildTicks( interval, stepSize, maxMinorSteps, ticks );
+        }
 
         scaleDiv = QwtScaleDiv( interval, ticks );
+        effectiveStepSize = stepSize;
     }
 
     if ( x1 > x2 )
@@ -658,6 +982,89 @@ void QwtLinearScaleEngine::buildTicks(
     }
 }
 
+/*!
+   \brief Calculate ticks for an interval reusing the ticks 
+          of an overlapping scale division
+
+   The ticks of scaleDiv inside of interval are taken as they are,
+   the ticks for the parts of interval, that are not covered by
+   scaleDiv, are calculated by buildTicks(). So the values of the
+   ticks don't change, when scrolling an axis.
+
+   \param scaleDiv Scale division with increasing ticks, that
+                   has been calculated for the same step size
+   \param interval Interval
+   \param stepSize Step size
+   \param maxMinorSteps Maximum number of minor steps
+   \param ticks Arrays to be filled with the calculated ticks
+
+   \sa buildTicks()
+*/
+void QwtLinearScaleEngine::buildScrolledTicks( const QwtScaleDiv &scaleDiv,
+    const QwtInterval& interval, double stepSize, int maxMinorSteps,
+    QList<double> ticks[QwtScaleDiv::NTickTypes] ) const
+{
+    const QwtInterval cachedInterval = scaleDiv.interval();
+
+    QList<double> lowerTicks[QwtScaleDiv::NTickTypes];
+    if ( interval.minValue() < cachedInterval.minValue() )
+    {
+        // one step more on both sides, so that the uncovered
+        // part is calculated like for the complete interval
+
+        const QwtInterval lowerInterval( interval.minValue() - stepSize,
+            cachedInterval.minValue() + stepSize );
+
+        buildTicks( lowerInterval, stepSize, maxMinorSteps, lowerTicks );
+    }
+
+    QList<double> upperTicks[QwtScaleDiv::NTickTypes];
+    if ( interval.maxValue() > cachedInterval.maxValue() )
+    {
+        const QwtInterval upperInterval( 
+            cachedInterval.maxValue() - stepSize,
+            interval.maxValue() + stepSize );
+
+        buildTicks( upperInterval, stepSize, maxMinorSteps, upperTicks );
+    }
+
+    for ( int i = 0; i < QwtScaleDiv::NTickTypes; i++ )
+    {
+        QList<double> &tickList = ticks[i];
+
+        for ( int j = 0; j < lowerTicks[i].size(); j++ )
+        {
+            const double value = lowerTicks[i][j];
+
+            if ( value < cachedInterval.minValue() 
+                && contains( interval, value )
+                && !contains( cachedInterval, value ) )
+            {
+                tickList += value;
+            }
+        }
+
+        const QList<double> &cachedTicks = scaleDiv.ticks( i );
+        for ( int j = 0; j < cachedTicks.size(); j++ )
+        {
+            if ( contains( interval, cachedTicks[j] ) )
+                tickList += cachedTicks[j];
+        }
+
+        for ( int j = 0; j < upperTicks[i].size(); j++ )
+        {
+            const double value = upperTicks[i][j];
+
+            if ( value > cachedInterval.maxValue() 
+                && contains( interval, value )
+                && !contains( cachedInterval, value ) )
+            {
+                tickList += value;
+            }
+        }
+    }
+}
+
 /*!
    \brief Calculate major ticks for an interval
 
@@ -799,6 +1206,12 @@ QwtLogScaleEngine::~QwtLogScaleEngine()
 void QwtLogScaleEngine::autoScale( int maxNumSteps,
     double &x1, double &x2, double &stepSize ) const
 {
+    if ( lookupAutoScale( maxNumSteps, x1, x2, stepSize ) )
+        return;
+
+    const double x10 = x1;
+    const double x20 = x2;
+
     if ( x1 > x2 )
         qSwap( x1, x2 );
 
@@ -824,6 +1237,8 @@ void QwtLogScaleEngine::autoScale( int maxNumSteps,
         if ( linearInterval.maxValue() / linearInterval.minValue() < logBase )
         {
             stepSize = 0.0;
+            insertAutoScale( maxNumSteps, x10, x20, x1, x2, stepSize );
+
             return;
         }
     }
@@ -863,6 +1278,8 @@ void QwtLogScaleEngine::autoScale( int maxNumSteps,
         qSwap( x1, x2 );
         stepSize = -stepSize;
     }
+
+    insertAutoScale( maxNumSteps, x10, x20, x1, x2, stepSize );
 }
 
 /*!
@@ -880,6 +1297,16 @@ void QwtLogScaleEngine::autoScale( int maxNumSteps,
 QwtScaleDiv QwtLogScaleEngine::divideScale( double x1, double x2,
     int maxMajorSteps, int maxMinorSteps, double stepSize ) const
 {
+    QwtScaleDiv scaleDiv;
+    if ( lookupScaleDiv( x1, x2, maxMajorSteps, 
+        maxMinorSteps, stepSize, scaleDiv ) )
+    {
+        return scaleDiv;
+    }
+
+    const int maxMajorSteps0 = maxMajorSteps;
+    const double stepSize0 = stepSize;
+
     QwtInterval interval = QwtInterval( x1, x2 ).normalized();
     interval = interval.limited( LOG_MIN, LOG_MAX );
 
@@ -897,8 +1324,13 @@ QwtScaleDiv QwtLogScaleEngine::divideScale( double x1, double x2,
         linearScaler.setReference( reference() );
         linearScaler.setMargins( lowerMargin(), upperMargin() );
 
-        return linearScaler.divideScale( x1, x2,
+        scaleDiv = linearScaler.divideScale( x1, x2,
             maxMajorSteps, maxMinorSteps, 0.0 );
+
+        insertScaleDiv( x1, x2, maxMajorSteps0, 
+            maxMinorSteps, stepSize0, scaleDiv );
+
+        return scaleDiv;
     }
 
     stepSize = qAbs( stepSize );
@@ -913,7 +1345,6 @@ QwtScaleDiv QwtLogScaleEngine::divideScale( double x1, double x2,
             stepSize = 1.0; // major step must be >= 1 decade
     }
 
-    QwtScaleDiv scaleDiv;
     if ( stepSize != 0.0 )
     {
         QList<double> ticks[QwtScaleDiv::NTickTypes];
@@ -925,6 +1356,9 @@ QwtScaleDiv QwtLogScaleEngine::divideScale( double x1, double x2,
     if ( x1 > x2 )
         scaleDiv.invert();
 
+    insertScaleDiv( x1, x2, maxMajorSteps0, 
+        maxMinorSteps, stepSize0, scaleDiv );
+
     return scaleDiv;
 }
 
@@ -127,6 +127,8 @@ public:
     void setTransformation( QwtTransform * );
     QwtTransform *transformation() const;
 
+    void invalidateCache();
+
 protected:
     bool contains( const QwtInterval &, double val ) const;
     QList<double> strip( const QList<double>&, const QwtInterval & ) const;
@@ -135,6 +137,24 @@ protected:
 
     QwtInterval buildInterval( double v ) const;
 
+    bool lookupScaleDiv( double x1, double x2,
+        int maxMajorSteps, int maxMinorSteps, double stepSize,
+        QwtScaleDiv & ) const;
+
+    bool lookupScrolledScaleDiv( const QwtInterval &,
+        int maxMinorSteps, double effectiveStepSize,
+        QwtScaleDiv & ) const;
+
+    void insertScaleDiv( double x1, double x2,
+        int maxMajorSteps, int maxMinorSteps, double stepSize,
+        const QwtScaleDiv &, double effectiveStepSize = 0.0 ) const;
+
+    bool lookupAutoScale( int maxNumSteps, 
+        double &x1, double &x2, double &stepSize ) const;
+
+    void insertAutoScale( int maxNumSteps, double x1, double x2,
+        double alignedX1, double alignedX2, double stepSize ) const;
+
 private:
     Q_DISABLE_COPY(QwtScaleEngine)
 
@@ -164,12 +184,20 @@ public:
 
 
 protected:
+    QwtScaleDiv calculateScaleDiv( double x1, double x2,
+        int maxMajorSteps, int maxMinorSteps, double stepSize,
+        double &effectiveStepSize ) const;
+
     QwtInterval align( const QwtInterval&, double stepSize ) const;
 
     void buildTicks(
         const QwtInterval &, double stepSize, int maxMinSteps,
         QList<double> ticks[QwtScaleDiv::NTickTypes] ) const;
 
+    void buildScrolledTicks( const QwtScaleDiv &,
+        const QwtInterval &, double stepSize, int maxMinSteps,
+        QList<double> ticks[QwtScaleDiv::NTickTypes] ) const;
+
     QList<double> buildMajorTicks(
         const QwtInterval &interval, double stepSize ) const;
 
@@ -0,0 +1,553 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#include "qwt_scratch_arena.h"
+#include <qlist.h>
+#include <qthreadstorage.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace
+{
+    class MemoryBlock
+    {
+    public:
+        MemoryBlock( void *memory = NULL, size_t capacity = 0 ):
+            memory( memory ),
+            capacity( capacity )
+        {
+        }
+
+        void *memory;
+        size_t capacity;
+    };
+}
+
+static inline size_t qwtCapacity( const MemoryBlock &block )
+{
+    return block.capacity;
+}
+
+template <class Polygon>
+static inline size_t qwtCapacity( const Polygon &polygon )
+{
+    return polygon.capacity();
+}
+
+static inline size_t qwtBytes( const MemoryBlock &block )
+{
+    return block.capacity;
+}
+
+template <class Polygon>
+static inline size_t qwtBytes( const Polygon &polygon )
+{
+    return polygon.capacity() * sizeof( typename Polygon::value_type );
+}
+
+/*
+  A buffer is reused only, when it is not much larger than needed.
+  Otherwise a small request would keep the memory of a huge buffer.
+ */
+static inline bool qwtIsFitting( size_t capacity, size_t size )
+{
+    return ( capacity >= size ) && ( capacity <= 2 * size + 256 );
+}
+
+/*
+  Find the buffer, that fits best: the smallest one, that is
+  large enough, but not much larger than needed.
+ */
+template <class T>
+static int qwtBestFit( const QList<T> &buffers, size_t size )
+{
+    int index = -1;
+
+    for ( int i = 0; i < buffers.size(); i++ )
+    {
+        const size_t capacity = qwtCapacity( buffers[i] );
+
+        if ( qwtIsFitting( capacity, size ) )
+        {
+            if ( index < 0 || capacity < qwtCapacity( buffers[index] ) )
+                index = i;
+        }
+    }
+
+    return index;
+}
+
+static inline void qwtFree( MemoryBlock &block )
+{
+    ::free( block.memory );
+}
+
+template <class Polygon>
+static inline void qwtFree( Polygon & )
+{
+    // the memory is released by the destructor of the polygon
+}
+
+class QwtScratchArena::PrivateData
+{
+public:
+    PrivateData():
+        maxBuffers( 16 ),
+        maxBytes( 32 * 1024 * 1024 ),
+        bytes( 0 )
+    {
+    }
+
+    template <class Polygon>
+    void acquire( QwtScratchArena *arena, int size, Polygon &polygon )
+    {
+        QList<Polygon> &buffers = polygonList( polygon );
+
+        const int index = qwtBestFit( buffers, size );
+        if ( index >= 0 )
+            polygon = take( buffers, index );
+        else
+            polygon = Polygon();
+
+        const size_t numBytes = size * sizeof( typename Polygon::value_type );
+        arena->count( polygon.capacity() < size, numBytes );
+
+        /*
+           reserve() also avoids, that the memory is released,
+           when shrinking the polygon later
+         */
+        polygon.reserve( qMax( size, polygon.capacity() ) );
+        polygon.resize( size );
+    }
+
+    template <class Polygon>
+    void release( Polygon &polygon )
+    {
+        if ( polygon.capacity() > 0 )
+        {
+            QList<Polygon> &buffers = polygonList( polygon );
+            if ( makeRoom( buffers, qwtBytes( polygon ) ) )
+            {
+                bytes += qwtBytes( polygon );
+                buffers += polygon;
+            }
+        }
+
+        polygon = Polygon();
+    }
+
+    template <class Polygon>
+    void squeeze( QwtScratchArena *arena, Polygon &polygon )
+    {
+        const int size = polygon.size();
+        if ( qwtIsFitting( polygon.capacity(), size ) )
+            return;
+
+        const size_t numBytes = size * sizeof( typename Polygon::value_type );
+
+        Polygon squeezed( size );
+        if ( size > 0 )
+        {
+            ::memcpy( squeezed.data(), polygon.constData(), numBytes );
+            arena->count( true, numBytes );
+        }
+
+        release( polygon );
+        polygon = squeezed;
+    }
+
+    template <class T>
+    T take( QList<T> &buffers, int index )
+    {
+        T buffer = buffers.takeAt( index );
+        bytes -= qwtBytes( buffer );
+
+        return buffer;
+    }
+
+    /*
+      Make room for a buffer by removing the oldest buffers:
+      first those of the same type, then the others.
+      Returns false, when the buffer doesn't fit into the pool at all.
+     */
+    template <class T>
+    bool makeRoom( QList<T> &buffers, size_t size )
+    {
+        if ( maxBuffers <= 0 || size > maxBytes )
+            return false;
+
+        while ( buffers.size() >= maxBuffers )
+            removeOldest( buffers );
+
+        while ( bytes + size > maxBytes )
+        {
+            if ( !buffers.isEmpty() )
+                removeOldest( buffers );
+            else
+                removeOldest();
+        }
+
+        return true;
+    }
+
+    // remove buffers until the pool respects the limits
+    void applyLimits()
+    {
+        while ( polygonsF.size() > maxBuffers )
+            removeOldest( polygonsF );
+
+        while ( polygons.size() > maxBuffers )
+            removeOldest( polygons );
+
+        while ( memoryBlocks.size() > maxBuffers )
+            removeOldest( memoryBlocks );
+
+        while ( bytes > maxBytes )
+        {
+            if ( !removeOldest() )
+                break;
+        }
+    }
+
+    template <class T>
+    void removeOldest( QList<T> &buffers )
+    {
+        T buffer = take( buffers, 0 );
+        qwtFree( buffer );
+    }
+
+    bool removeOldest()
+    {
+        if ( !memoryBlocks.isEmpty() )
+            removeOldest( memoryBlocks );
+        else if ( !polygonsF.isEmpty() )
+            removeOldest( polygonsF );
+        else if ( !polygons.isEmpty() )
+            removeOldest( polygons );
+        else
+            return false;
+
+        return true;
+    }
+
+    inline QList<QPolygonF> &polygonList( const QPolygonF & )
+    {
+        return polygonsF;
+    }
+
+    inline QList<QPolygon> &polygonList( const QPolygon & )
+    {
+        return polygons;
+    }
+
+    int maxBuffers;
+    size_t maxBytes;
+
+    // bytes of all buffers in the pool
+    size_t bytes;
+
+    // buffers in the order they have been released
+    QList<QPolygonF> polygonsF;
+    QList<QPolygon> polygons;
+    QList<MemoryBlock> memoryBlocks;
+
+    QwtScratchArena::Statistics statistics;
+};
+
+//! Constructor, initializing all counters with 0
+QwtScratchArena::Statistics::Statistics():
+    numAllocations( 0 ),
+    allocatedBytes( 0 ),
+    numReuses( 0 ),
+    reusedBytes( 0 )
+{
+}
+
+//! Constructor
+QwtScratchArena::QwtScratchArena()
+{
+    d_data = new PrivateData;
+}
+
+//! Destructor, freeing all buffers of the arena
+QwtScratchArena::~QwtScratchArena()
+{
+    clear();
+    delete d_data;
+}
+
+/*!
+  \return Arena of the calling thread
+
+  The arena is created on the first call and deleted, when
+  the thread terminates.
+ */
+QwtScratchArena *QwtScratchArena::instance()
+{
+    static QThreadStorage<QwtScratchArena *> arenas;
+
+    if ( !arenas.hasLocalData() )
+        arenas.setLocalData( new QwtScratchArena() );
+
+    return arenas.localData();
+}
+
+/*!
+  Set the maximum number of buffers of each type, that are kept
+  in the pool. When the pool is full the oldest buffer is freed.
+
+  The default setting is 16.
+
+  \param numBuffers Maximum number of buffers
+  \sa maxBuffers(), setMaxBytes()
+ */
+void QwtScratchArena::setMaxBuffers( int numBuffers )
+{
+    d_data->maxBuffers = qMax( numBuffers, 0 );
+    d_data->applyLimits();
+}
+
+/*!
+  \return Maximum number of buffers of each type
+  \sa setMaxBuffers()
+ */
+int QwtScratchArena::maxBuffers() const
+{
+    return d_data->maxBuffers;
+}
+
+/*!
+  Set the maximum number of bytes of all buffers, that are kept
+  in the pool. When the limit is exceeded the oldest buffers are freed.
+  Buffers, that are larger than the limit, are never kept.
+
+  The default setting is 32MB.
+
+  \param numBytes Maximum number of bytes
+  \sa maxBytes(), setMaxBuffers()
+ */
+void QwtScratchArena::setMaxBytes( size_t numBytes )
+{
+    d_data->maxBytes = numBytes;
+    d_data->applyLimits();
+}
+
+/*!
+  \return Maximum number of bytes of all buffers in the pool
+  \sa setMaxBytes()
+ */
+size_t QwtScratchArena::maxBytes() const
+{
+    return d_data->maxBytes;
+}
+
+/*!
+  \brief Take a polygon from the pool
+
+  \param size Number of points
+  \param polygon Polygon, that is resized to size.
+                 The values of its points are undefined.
+
+  \sa release()
+ */
+void QwtScratchArena::acquire( int size, QPolygonF &polygon )
+{
+    d_data->acquire( this, size, polygon );
+}
+
+/*!
+  \brief Pass the memory of a polygon back to the pool
+
+  \param polygon Polygon, that is cleared
+  \sa acquire()
+ */
+void QwtScratchArena::release( QPolygonF &polygon )
+{
+    d_data->release( polygon );
+}
+
+/*!
+  \brief Take a polygon from the pool
+
+  \param size Number of points
+  \param polygon Polygon, that is resized to size.
+                 The values of its points are undefined.
+
+  \sa release()
+ */
+void QwtScratchArena::acquire( int size, QPolygon &polygon )
+{
+    d_data->acquire( this, size, polygon );
+}
+
+/*!
+  \brief Pass the memory of a polygon back to the pool
+
+  \param polygon Polygon, that is cleared
+  \sa acquire()
+ */
+void QwtScratchArena::release( QPolygon &polygon )
+{
+    d_data->release( polygon );
+}
+
+/*!
+  \brief Release unused memory of a polygon
+
+  When the capacity of the polygon is significantly larger than its size,
+  the points are copied into a polygon of the exact size and the
+  buffer is passed back to the pool. 
+  
+  Polygons, that have been taken from the pool, need to be squeezed, 
+  before they are passed to code, that might keep them 
+  - f.e. as return value of a public API.
+
+  The copy is counted as allocation in the statistics(). Internal
+  code should pass its buffers back with release() instead.
+
+  \param polygon Polygon
+  \sa acquire()
+ */
+void QwtScratchArena::squeeze( QPolygonF &polygon )
+{
+    d_data->squeeze( this, polygon );
+}
+
+/*!
+  \brief Release unused memory of a polygon
+
+  \param polygon Polygon
+  \sa squeeze( QPolygonF & ), acquire()
+ */
+void QwtScratchArena::squeeze( QPolygon &polygon )
+{
+    d_data->squeeze( this, polygon );
+}
+
+/*!
+  \brief Take a block of raw memory from the pool
+
+  \param size Number of bytes, that are needed
+  \param capacity Returns the size of the block, that might be
+                  larger than size
+
+  \return Memory block, that has to be passed back
+          with releaseMemory()
+
+  \sa resizeMemory(), releaseMemory()
+ */
+void *QwtScratchArena::acquireMemory( size_t size, size_t &capacity )
+{
+    QList<MemoryBlock> &blocks = d_data->memoryBlocks;
+
+    const int index = qwtBestFit( blocks, size );
+    if ( index >= 0 )
+    {
+        const MemoryBlock block = d_data->take( blocks, index );
+        count( false, size );
+
+        capacity = block.capacity;
+        return block.memory;
+    }
+
+    capacity = 0;
+    return resizeMemory( NULL, size, capacity );
+}
+
+/*!
+  \brief Grow a block of memory, that has been taken from the pool
+
+  \param memory Memory block
+  \param size Number of bytes, that are needed
+  \param capacity Current size of the block,
+                  returns the new size of the block
+
+  \return Memory block, that might have been moved
+  \sa acquireMemory(), releaseMemory()
+ */
+void *QwtScratchArena::resizeMemory(
+    void *memory, size_t size, size_t &capacity )
+{
+    if ( memory && size <= capacity )
+        return memory;
+
+    memory = ::realloc( memory, size );
+    capacity = size;
+
+    count( true, size );
+
+    return memory;
+}
+
+/*!
+  \brief Pass a block of memory back to the pool
+
+  \param memory Memory block
+  \param capacity Size of the block
+
+  \sa acquireMemory()
+ */
+void QwtScratchArena::releaseMemory( void *memory, size_t capacity )
+{
+    if ( memory == NULL )
+        return;
+
+    QList<MemoryBlock> &blocks = d_data->memoryBlocks;
+
+    if ( !d_data->makeRoom( blocks, capacity ) )
+    {
+        ::free( memory );
+        return;
+    }
+
+    d_data->bytes += capacity;
+    blocks += MemoryBlock( memory, capacity );
+}
+
+/*!
+  \return Counters for the requests of the arena
+  \sa resetStatistics()
+ */
+QwtScratchArena::Statistics QwtScratchArena::statistics() const
+{
+    return d_data->statistics;
+}
+
+/*!
+  Reset all counters to 0
+  \sa statistics()
+ */
+void QwtScratchArena::resetStatistics()
+{
+    d_data->statistics = Statistics();
+}
+
+//! Free all buffers of the pool
+void QwtScratchArena::clear()
+{
+    while ( d_data->removeOldest() )
+    {
+    }
+}
+
+void QwtScratchArena::count( bool isAllocated, size_t bytes )
+{
+    Statistics &statistics = d_data->statistics;
+
+    if ( isAllocated )
+    {
+        statistics.numAllocations++;
+        statistics.allocatedBytes += bytes;
+    }
+    else
+    {
+        statistics.numReuses++;
+        statistics.reusedBytes += bytes;
+    }
+}
@@ -0,0 +1,113 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#ifndef QWT_SCRATCH_ARENA_H
+#define QWT_SCRATCH_ARENA_H
+
+#include "qwt_global.h"
+#include <qpolygon.h>
+
+/*!
+  \brief A per thread pool of buffers for temporary polygons
+
+  Painting a curve needs several temporary buffers for the
+  translated and clipped points, that are thrown away after
+  each paint operation. QwtScratchArena keeps these buffers,
+  so that their memory can be reused by the next paint operation.
+  In a steady state - f.e. a realtime plot with a similar number
+  of points for each replot - no memory needs to be allocated
+  on the heap.
+
+  Each thread has its own arena ( instance() ), so that no
+  synchronization is necessary.
+
+  \code
+QwtScratchArena *arena = QwtScratchArena::instance();
+
+QPolygonF polygon;
+arena->acquire( numPoints, polygon );
+
+...
+
+arena->release( polygon );
+  \endcode
+
+  The pool is limited by the number of buffers ( setMaxBuffers() )
+  and the number of bytes ( setMaxBytes() ). Buffers are reused only,
+  when they are not much larger than requested.
+
+  \note Buffers, that are not released, are simply not reused.
+  \note Polygons from the pool should never be returned from a public
+        API without squeeze().
+  \sa statistics()
+ */
+class QWT_EXPORT QwtScratchArena
+{
+public:
+    /*!
+      \brief Counters for the buffer requests of an arena
+      \sa QwtScratchArena::statistics()
+     */
+    class Statistics
+    {
+    public:
+        Statistics();
+
+        //! Number of requests, that had to allocate memory
+        quint64 numAllocations;
+
+        //! Number of bytes, that have been allocated
+        quint64 allocatedBytes;
+
+        //! Number of requests, that could reuse a buffer
+        quint64 numReuses;
+
+        //! Number of bytes, that have been reused
+        quint64 reusedBytes;
+    };
+
+    static QwtScratchArena *instance();
+
+    void setMaxBuffers( int );
+    int maxBuffers() const;
+
+    void setMaxBytes( size_t );
+    size_t maxBytes() const;
+
+    void acquire( int size, QPolygonF & );
+    void release( QPolygonF & );
+
+    void acquire( int size, QPolygon & );
+    void release( QPolygon & );
+
+    void squeeze( QPolygonF & );
+    void squeeze( QPolygon & );
+
+    void *acquireMemory( size_t size, size_t &capacity );
+    void *resizeMemory( void *memory, size_t size, size_t &capacity );
+    void releaseMemory( void *memory, size_t capacity );
+
+    Statistics statistics() const;
+    void resetStatistics();
+
+    void clear();
+
+    ~QwtScratchArena();
+
+private:
+    QwtScratchArena();
+    Q_DISABLE_COPY(QwtScratchArena)
+
+    void count( bool isAllocated, size_t bytes );
+
+    class PrivateData;
+    PrivateData *d_data;
+};
+
+#endif
@@ -9,6 +9,18 @@
 
 #include "qwt_series_data.h"
 #include "qwt_math.h"
+#include <typeinfo>
+
+/*
+  The columns bypass sample(), that might be overridden
+  in a derived class. So they are exposed only for the class
+  itself or when a derived class enables them explicitly.
+ */
+template <class Data>
+static inline bool qwtIsColumnar( const Data *data, bool enabled )
+{
+    return enabled || typeid( *data ) == typeid( Data );
+}
 
 static inline QRectF qwtBoundingRect( const QPointF &sample )
 {
@@ -124,7 +136,40 @@ QRectF qwtBoundingRectT(
 QRectF qwtBoundingRect(
     const QwtSeriesData<QPointF> &series, int from, int to )
 {
-    return qwtBoundingRectT<QPointF>( series, from, to );
+    const QwtPointColumns columns( &series );
+    if ( !columns.isContiguous() )
+        return qwtBoundingRectT<QPointF>( series, from, to );
+
+    if ( from < 0 )
+        from = 0;
+
+    if ( to < 0 )
+        to = series.size() - 1;
+
+    if ( to < from )
+        return QRectF( 1.0, 1.0, -2.0, -2.0 ); // invalid
+
+    size_t xStride, yStride;
+    const double *x = columns.xColumn( xStride );
+    const double *y = columns.yColumn( yStride );
+
+    double minX = x[ from * xStride ];
+    double maxX = minX;
+    double minY = y[ from * yStride ];
+    double maxY = minY;
+
+    for ( int i = from + 1; i <= to; i++ )
+    {
+        const double xi = x[ i * xStride ];
+        minX = qMin( minX, xi );
+        maxX = qMax( maxX, xi );
+
+        const double yi = y[ i * yStride ];
+        minY = qMin( minY, yi );
+        maxY = qMax( maxY, yi );
+    }
+
+    return QRectF( minX, minY, maxX - minX, maxY - minY );
 }
 
 /*!
@@ -241,6 +286,40 @@ QRectF QwtPointSeriesData::boundingRect() const
     return d_boundingRect;
 }
 
+/*!
+  \param stride Returns 2, as x and y coordinates are interleaved
+  \return Memory of the x coordinates, or NULL, when qreal is not double
+  \sa yColumn(), setColumnAccessEnabled()
+*/
+const double *QwtPointSeriesData::xColumn( size_t &stride ) const
+{
+    stride = 2;
+    if ( !qwtIsColumnar( this, isColumnAccessEnabled() ) )
+        return NULL;
+
+    if ( sizeof( qreal ) != sizeof( double ) )
+        return NULL;
+
+    return reinterpret_cast<const double *>( d_samples.constData() );
+}
+
+/*!
+  \param stride Returns 2, as x and y coordinates are interleaved
+  \return Memory of the y coordinates, or NULL, when qreal is not double
+  \sa xColumn(), setColumnAccessEnabled()
+*/
+const double *QwtPointSeriesData::yColumn( size_t &stride ) const
+{
+    stride = 2;
+    if ( !qwtIsColumnar( this, isColumnAccessEnabled() ) )
+        return NULL;
+
+    if ( sizeof( qreal ) != sizeof( double ) )
+        return NULL;
+
+    return reinterpret_cast<const double *>( d_samples.constData() ) + 1;
+}
+
 /*!
    Constructor
    \param samples Samples
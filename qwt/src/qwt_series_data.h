@@ -41,7 +41,20 @@
      but often it is possible to implement a more efficient algorithm 
      depending on the characteristics of the series.
      The member d_boundingRect is intended for caching the calculated rectangle.
+
+   When the coordinates of a QwtSeriesData<QPointF> are stored in memory
+   as arrays of doubles - like in numpy or Arrow like columnar buffers -
+   it is recommended to implement xColumn() and yColumn() too. Then
+   algorithms like mapping or calculating the bounding rectangle can read 
+   the values directly from memory without calling sample() for each point.
+
+   The built-in classes QwtPointSeriesData, QwtPointArrayData and 
+   QwtCPointerData expose their memory as columns. As the columns 
+   bypass sample(), they are not exposed for derived classes, 
+   that might override sample(), unless these classes enable them 
+   explicitly with setColumnAccessEnabled().
     
+   \sa QwtPointColumns
 */
 template <typename T>
 class QwtSeriesData
@@ -90,17 +103,53 @@ public:
     */
     virtual void setRectOfInterest( const QRectF &rect );
 
+    /*!
+       \brief Contiguous memory of the x coordinates
+
+       The x coordinate of sample i is found at xColumn()[ i * stride ].
+       The default implementation returns NULL, what means, that
+       the values can be accessed by sample() only.
+
+       \param stride Distance between 2 x coordinates in doubles
+       \return Pointer to the x coordinate of the first sample, or NULL
+
+       \note Only used for QwtSeriesData<QPointF>
+       \sa yColumn(), QwtPointColumns
+     */
+    virtual const double *xColumn( size_t &stride ) const;
+
+    /*!
+       \brief Contiguous memory of the y coordinates
+
+       The y coordinate of sample i is found at yColumn()[ i * stride ].
+       The default implementation returns NULL, what means, that
+       the values can be accessed by sample() only.
+
+       \param stride Distance between 2 y coordinates in doubles
+       \return Pointer to the y coordinate of the first sample, or NULL
+
+       \note Only used for QwtSeriesData<QPointF>
+       \sa xColumn(), QwtPointColumns
+     */
+    virtual const double *yColumn( size_t &stride ) const;
+
 protected:
+    void setColumnAccessEnabled( bool on );
+    bool isColumnAccessEnabled() const;
+
     //! Can be used to cache a calculated bounding rectangle
     mutable QRectF d_boundingRect;
 
 private:
     QwtSeriesData<T> &operator=( const QwtSeriesData<T> & );
+
+    bool d_columnAccess;
 };
 
 template <typename T>
 QwtSeriesData<T>::QwtSeriesData():
-    d_boundingRect( 0.0, 0.0, -1.0, -1.0 )
+    d_boundingRect( 0.0, 0.0, -1.0, -1.0 ),
+    d_columnAccess( false )
 {
 }
 
@@ -114,6 +163,48 @@ void QwtSeriesData<T>::setRectOfInterest( const QRectF & )
 {
 }
 
+/*!
+   \brief En/Disable the columns of a built-in class for a derived class
+
+   QwtPointSeriesData, QwtPointArrayData and QwtCPointerData offer their
+   memory as columns ( xColumn(), yColumn() ) only, when the object is
+   not of a derived class or when the derived class has enabled them. 
+   A derived class must not enable them, when it overrides sample().
+
+   \param on On/Off
+   \sa isColumnAccessEnabled(), xColumn(), yColumn()
+ */
+template <typename T>
+void QwtSeriesData<T>::setColumnAccessEnabled( bool on )
+{
+    d_columnAccess = on;
+}
+
+/*!
+   \return True, when a derived class has enabled the columns
+           of a built-in class
+   \sa setColumnAccessEnabled()
+ */
+template <typename T>
+bool QwtSeriesData<T>::isColumnAccessEnabled() const
+{
+    return d_columnAccess;
+}
+
+template <typename T>
+const double *QwtSeriesData<T>::xColumn( size_t &stride ) const
+{
+    stride = 0;
+    return NULL;
+}
+
+template <typename T>
+const double *QwtSeriesData<T>::yColumn( size_t &stride ) const
+{
+    stride = 0;
+    return NULL;
+}
+
 /*!
   \brief Template class for data, that is organized as QVector
 
@@ -202,8 +293,139 @@ public:
         const QVector<QPointF> & = QVector<QPointF>() );
 
     virtual QRectF boundingRect() const;
+
+    virtual const double *xColumn( size_t &stride ) const;
+    virtual const double *yColumn( size_t &stride ) const;
+};
+
+/*!
+  \brief Fast read access to the samples of a QwtSeriesData<QPointF>
+
+  When the series offers its coordinates in contiguous memory
+  ( QwtSeriesData::xColumn(), QwtSeriesData::yColumn() ) the values
+  are read directly from memory - without a virtual call for each sample.
+  Otherwise QwtSeriesData::sample() is used.
+
+  Derived classes of the built-in series classes offer their columns
+  only, when enabled explicitly ( QwtSeriesData::setColumnAccessEnabled() ),
+  so that an overridden sample() is always respected.
+
+  \code
+    const QwtPointColumns columns( series );
+    for ( size_t i = 0; i < series->size(); i++ )
+        doSomething( columns.sample( i ) );
+  \endcode
+*/
+class QwtPointColumns
+{
+public:
+    explicit QwtPointColumns( const QwtSeriesData<QPointF> *series );
+
+    bool isContiguous() const;
+
+    QPointF sample( size_t index ) const;
+    double x( size_t index ) const;
+    double y( size_t index ) const;
+
+    const double *xColumn( size_t &stride ) const;
+    const double *yColumn( size_t &stride ) const;
+
+private:
+    const QwtSeriesData<QPointF> *d_series;
+
+    const double *d_x;
+    const double *d_y;
+
+    size_t d_xStride;
+    size_t d_yStride;
 };
 
+/*!
+  Constructor
+  \param series Series
+ */
+inline QwtPointColumns::QwtPointColumns( 
+        const QwtSeriesData<QPointF> *series ):
+    d_series( series ),
+    d_x( NULL ),
+    d_y( NULL ),
+    d_xStride( 0 ),
+    d_yStride( 0 )
+{
+    if ( series )
+    {
+        d_x = series->xColumn( d_xStride );
+        d_y = series->yColumn( d_yStride );
+
+        if ( d_x == NULL || d_y == NULL )
+            d_x = d_y = NULL;
+    }
+}
+
+/*!
+  \return True, when the samples can be read directly from memory
+ */
+inline bool QwtPointColumns::isContiguous() const
+{
+    return d_x != NULL;
+}
+
+/*!
+  \param index Index
+  \return Sample at position index
+ */
+inline QPointF QwtPointColumns::sample( size_t index ) const
+{
+    if ( d_x )
+        return QPointF( d_x[ index * d_xStride ], d_y[ index * d_yStride ] );
+
+    return d_series->sample( index );
+}
+
+/*!
+  \param index Index
+  \return x coordinate of the sample at position index
+ */
+inline double QwtPointColumns::x( size_t index ) const
+{
+    if ( d_x )
+        return d_x[ index * d_xStride ];
+
+    return d_series->sample( index ).x();
+}
+
+/*!
+  \param index Index
+  \return y coordinate of the sample at position index
+ */
+inline double QwtPointColumns::y( size_t index ) const
+{
+    if ( d_y )
+        return d_y[ index * d_yStride ];
+
+    return d_series->sample( index ).y();
+}
+
+/*!
+  \param stride Distance between 2 x coordinates in doubles
+  \return Memory of the x coordinates, or NULL, when !isContiguous()
+ */
+inline const double *QwtPointColumns::xColumn( size_t &stride ) const
+{
+    stride = d_xStride;
+    return d_x;
+}
+
+/*!
+  \param stride Distance between 2 y coordinates in doubles
+  \return Memory of the y coordinates, or NULL, when !isContiguous()
+ */
+inline const double *QwtPointColumns::yColumn( size_t &stride ) const
+{
+    stride = d_yStride;
+    return d_y;
+}
+
 //! Interface for iterating over an array of 3D points
 class QWT_EXPORT QwtPoint3DSeriesData: public QwtArraySeriesData<QwtPoint3D>
 {
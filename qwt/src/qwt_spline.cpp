@@ -12,6 +12,10 @@
 #include "qwt_bezier.h"
 #include "qwt_math.h"
 
+#include <qthread.h>
+#include <qfuture.h>
+#include <qtconcurrentrun.h>
+
 namespace QwtSplineC1P
 {
     struct param
@@ -183,6 +187,85 @@ namespace QwtSplineC1P
     }
 }
 
+template< class T >
+static void qwtSplineRunParallel( 
+    void ( *function )( const QPointF *, const double *, T *, int, int ),
+    const QPointF *points, const double *values, T *result, 
+    int size, int numThreads )
+{
+#if !defined(QT_NO_QFUTURE)
+    if ( numThreads > 1 )
+    {
+        const int chunkSize = size / numThreads;
+
+        QList< QFuture<void> > futures;
+        for ( int i = 0; i < numThreads - 1; i++ )
+        {
+            const int from = i * chunkSize;
+
+            futures += QtConcurrent::run( function, 
+                points, values, result, from, from + chunkSize );
+        }
+
+        function( points, values, result, 
+            ( numThreads - 1 ) * chunkSize, size );
+
+        for ( int i = 0; i < futures.size(); i++ )
+            futures[i].waitForFinished();
+
+        return;
+    }
+#else
+    Q_UNUSED( numThreads )
+#endif
+
+    function( points, values, result, 0, size );
+}
+
+static void qwtControlLinesFromSlopes( const QPointF *p, 
+    const double *m, QLineF *lines, int from, int to )
+{
+    for ( int i = from; i < to; i++ )
+    {
+        const double dx3 = ( p[i+1].x() - p[i].x() ) / 3.0;
+
+        lines[i].setLine( p[i].x() + dx3, p[i].y() + m[i] * dx3,
+            p[i+1].x() - dx3, p[i+1].y() - m[i+1] * dx3 );
+    }
+}
+
+static void qwtPolynomialsFromSlopes( const QPointF *p, 
+    const double *m, QwtSplinePolynomial *polynomials, int from, int to )
+{
+    for ( int i = from; i < to; i++ )
+    {
+        polynomials[i] = QwtSplinePolynomial::fromSlopes( 
+            p[i], m[i], p[i+1], m[i+1] );
+    }
+}
+
+static void qwtPolynomialsFromCurvatures( const QPointF *p, 
+    const double *cv, QwtSplinePolynomial *polynomials, int from, int to )
+{
+    for ( int i = from; i < to; i++ )
+    {
+        polynomials[i] = QwtSplinePolynomial::fromCurvatures( 
+            p[i], cv[i], p[i+1], cv[i+1] );
+    }
+}
+
+static void qwtSlopesFromCurvatures( const QPointF *p, 
+    const double *cv, double *m, int from, int to )
+{
+    for ( int i = from; i < to; i++ )
+    {
+        const QwtSplinePolynomial polynomial = 
+            QwtSplinePolynomial::fromCurvatures( p[i], cv[i], p[i+1], cv[i+1] );
+
+        m[i] = polynomial.c1;
+    }
+}
+
 template< class SplineStore >
 static inline SplineStore qwtSplineC1PathParamX(
     const QwtSplineC1 *spline, const QPolygonF &points )
@@ -429,11 +512,139 @@ static QPolygonF qwtPolygonParametric( double distance,
     return fittedPoints;
 }
 
+static inline int qwtFlatteningSteps( double value )
+{
+    // limiting the number of lines for a single segment
+    const int maxSteps = 10000;
+
+    if ( !( value > 1.0 ) ) // also true for NaN
+        return 1;
+
+    if ( value >= maxSteps )
+        return maxSteps;
+
+    return qCeil( value );
+}
+
+static inline int qwtBezierSteps( const QPointF &p1, const QPointF &cp1,
+    const QPointF &cp2, const QPointF &p2, double tolerance )
+{
+    /*
+      The distance between a Bezier curve and a polyline with
+      n equidistant steps in t is below max( |B''| ) / ( 8 * n² ),
+      where |B''| is below 6 * max( |p1 - 2 * cp1 + cp2|, |cp1 - 2 * cp2 + p2| )
+     */
+
+    const double dx1 = p1.x() - 2.0 * cp1.x() + cp2.x();
+    const double dy1 = p1.y() - 2.0 * cp1.y() + cp2.y();
+    const double dx2 = cp1.x() - 2.0 * cp2.x() + p2.x();
+    const double dy2 = cp1.y() - 2.0 * cp2.y() + p2.y();
+
+    const double d = qSqrt( qMax( dx1 * dx1 + dy1 * dy1, dx2 * dx2 + dy2 * dy2 ) );
+
+    return qwtFlatteningSteps( qSqrt( 0.75 * d / tolerance ) );
+}
+
+static inline QPointF *qwtFlattenBezier( const QPointF &p1, const QPointF &cp1,
+    const QPointF &cp2, const QPointF &p2, int steps, QPointF *points )
+{
+    // forward differencing of B(t) = a * t³ + b * t² + c * t + p1
+
+    const double h = 1.0 / steps;
+    const double h2 = h * h;
+    const double h3 = h2 * h;
+
+    const double ax = p2.x() - p1.x() + 3.0 * ( cp1.x() - cp2.x() );
+    const double bx = 3.0 * ( cp2.x() - 2.0 * cp1.x() + p1.x() );
+    const double cx = 3.0 * ( cp1.x() - p1.x() );
+
+    const double ay = p2.y() - p1.y() + 3.0 * ( cp1.y() - cp2.y() );
+    const double by = 3.0 * ( cp2.y() - 2.0 * cp1.y() + p1.y() );
+    const double cy = 3.0 * ( cp1.y() - p1.y() );
+
+    double x = p1.x();
+    double dx1 = ax * h3 + bx * h2 + cx * h;
+    double dx2 = 6.0 * ax * h3 + 2.0 * bx * h2;
+    const double dx3 = 6.0 * ax * h3;
+
+    double y = p1.y();
+    double dy1 = ay * h3 + by * h2 + cy * h;
+    double dy2 = 6.0 * ay * h3 + 2.0 * by * h2;
+    const double dy3 = 6.0 * ay * h3;
+
+    for ( int i = 1; i < steps; i++ )
+    {
+        x += dx1;
+        dx1 += dx2;
+        dx2 += dx3;
+
+        y += dy1;
+        dy1 += dy2;
+        dy2 += dy3;
+
+        *points++ = QPointF( x, y );
+    }
+
+    // avoiding, that rounding errors accumulate
+    *points++ = p2;
+
+    return points;
+}
+
+static inline int qwtPolynomialSteps( const QwtSplinePolynomial &polynomial,
+    double dx, double tolerance )
+{
+    /*
+      The curvature is linear, so its maximum is at one of the end points. 
+      The vertical distance between the polynomial and a chord of length s
+      is below max( |y''| ) * s² / 8 - what is also an upper limit for
+      the distance in any direction.
+     */
+    const double cv = qMax( qAbs( polynomial.curvatureAt( 0.0 ) ), 
+        qAbs( polynomial.curvatureAt( dx ) ) );
+
+    return qwtFlatteningSteps( qAbs( dx ) * qSqrt( cv / ( 8.0 * tolerance ) ) );
+}
+
+static inline QPointF *qwtFlattenPolynomial( const QPointF &p1, const QPointF &p2,
+    const QwtSplinePolynomial &polynomial, int steps, QPointF *points )
+{
+    // forward differencing of y = c3 * x³ + c2 * x² + c1 * x
+
+    const double c3 = polynomial.c3;
+    const double c2 = polynomial.c2;
+    const double c1 = polynomial.c1;
+
+    const double s = ( p2.x() - p1.x() ) / steps;
+    const double s2 = s * s;
+    const double s3 = s2 * s;
+
+    double y = p1.y();
+    double dy1 = c3 * s3 + c2 * s2 + c1 * s;
+    double dy2 = 6.0 * c3 * s3 + 2.0 * c2 * s2;
+    const double dy3 = 6.0 * c3 * s3;
+
+    for ( int i = 1; i < steps; i++ )
+    {
+        y += dy1;
+        dy1 += dy2;
+        dy2 += dy3;
+
+        *points++ = QPointF( p1.x() + i * s, y );
+    }
+
+    // avoiding, that rounding errors accumulate
+    *points++ = p2;
+
+    return points;
+}
+
 class QwtSpline::PrivateData
 {
 public:
     PrivateData():
-        boundaryType( QwtSpline::ConditionalBoundaries )
+        boundaryType( QwtSpline::ConditionalBoundaries ),
+        numThreads( 1 )
     {
         parametrization = new QwtSplineParametrization( 
             QwtSplineParametrization::ParameterChordal );
@@ -461,6 +672,8 @@ public:
         double value;
     
     } boundaryConditions[2];
+
+    uint numThreads;
 };
 
 /*!
@@ -481,8 +694,10 @@ public:
   Interpolates a polygon piecewise with Bezier curves
   interpolating them in a 2nd pass by polygons.
 
-  The interpolation is based on "Piecewise Linear Approximation of Bézier Curves"
-  by Roger Willcocks ( http://www.rops.org )
+  The Bezier curves are flattened by forward differencing, where
+  the number of steps for each curve is found from an upper limit
+  of its 2nd derivate. The number of points is calculated in advance, 
+  so that the polygon is allocated only once.
 
   \param points Control points
   \param tolerance Maximum for the accepted error of the approximation
@@ -505,22 +720,44 @@ QPolygonF QwtSpline::polygon( const QPolygonF &points, double tolerance ) const
     if ( el.type != QPainterPath::MoveToElement )
         return QPolygonF();
 
+    const int numCurves = ( n - 1 ) / 3;
+
+    QVector<int> steps( numCurves );
+    int numPoints = 1;
+
     QPointF p1( el.x, el.y );
 
-    QPolygonF polygon;
-    QwtBezier bezier( tolerance );
+    for ( int i = 0; i < numCurves; i++ )
+    {
+        const QPainterPath::Element el1 = path.elementAt( 3 * i + 1 );
+        const QPainterPath::Element el2 = path.elementAt( 3 * i + 2 );
+        const QPainterPath::Element el3 = path.elementAt( 3 * i + 3 );
+
+        const QPointF p2( el3.x, el3.y );
+
+        steps[i] = qwtBezierSteps( p1, QPointF( el1.x, el1.y ), 
+            QPointF( el2.x, el2.y ), p2, tolerance );
+
+        numPoints += steps[i];
+        p1 = p2;
+    }
+
+    QPolygonF polygon( numPoints );
+    QPointF *pp = polygon.data();
 
-    for ( int i = 1; i < n; i += 3 )
+    p1 = QPointF( el.x, el.y );
+    *pp++ = p1;
+
+    for ( int i = 0; i < numCurves; i++ )
     {
-        const QPainterPath::Element el1 = path.elementAt( i );
-        const QPainterPath::Element el2 = path.elementAt( i + 1 );
-        const QPainterPath::Element el3 = path.elementAt( i + 2 );
+        const QPainterPath::Element el1 = path.elementAt( 3 * i + 1 );
+        const QPainterPath::Element el2 = path.elementAt( 3 * i + 2 );
+        const QPainterPath::Element el3 = path.elementAt( 3 * i + 3 );
 
-        const QPointF cp1( el1.x, el1.y );
-        const QPointF cp2( el2.x, el2.y );
         const QPointF p2( el3.x, el3.y );
 
-        bezier.appendToPolygon( p1, cp1, cp2, p2, polygon );
+        pp = qwtFlattenBezier( p1, QPointF( el1.x, el1.y ), 
+            QPointF( el2.x, el2.y ), p2, steps[i], pp );
 
         p1 = p2;
     }
@@ -705,6 +942,62 @@ void QwtSpline::setBoundaryConditions(
     setBoundaryValue( QwtSpline::AtEnd, valueEnd );
 }   
 
+/*!
+  \brief Set the number of threads for calculating huge polygons
+
+  Splines, that offer a parallel implementation, split the 
+  calculation of slopes, curvatures and control points into chunks,
+  that are calculated in parallel threads. As threads are not for free,
+  only polygons with more than 50000 points per thread are split.
+
+  The default setting is 1.
+
+  \param numThreads Number of threads to be used. If numThreads is set to 0,
+                    the system specific ideal thread count is used.
+
+  \sa threadCount(), QwtSplineLocal, QwtSplineCubic
+ */
+void QwtSpline::setThreadCount( uint numThreads )
+{
+    d_data->numThreads = numThreads;
+}
+
+/*!
+  \return Number of threads for calculating huge polygons
+  \sa setThreadCount()
+ */
+uint QwtSpline::threadCount() const
+{
+    return d_data->numThreads;
+}
+
+/*!
+  \brief Number of threads for a calculation
+
+  Threads don't pay off for small polygons: each thread needs
+  to have at least 50000 points. 
+
+  \param numPoints Number of points of the calculation
+  \return Number of threads, that are used - at least 1
+  \sa threadCount()
+ */
+int QwtSpline::effectiveThreadCount( int numPoints ) const
+{
+#if defined(QT_NO_QFUTURE)
+    Q_UNUSED( numPoints )
+    return 1;
+#else
+    const int minPointsPerThread = 50000;
+
+    int numThreads = d_data->numThreads;
+    if ( numThreads <= 0 )
+        numThreads = QThread::idealThreadCount();
+
+    numThreads = qMin( numThreads, numPoints / minPointsPerThread );
+    return qMax( numThreads, 1 );
+#endif
+}
+
 //! \brief Constructor
 QwtSplineInterpolating::QwtSplineInterpolating()
 {
@@ -790,15 +1083,16 @@ QPainterPath QwtSplineInterpolating::painterPath( const QPolygonF &points ) cons
   Interpolates a polygon piecewise with Bezier curves
   approximating them by polygons.
 
-  The approximation is based on "Piecewise Linear Approximation of Bézier Curves"
-  by Roger Willcocks ( http://www.rops.org )
+  The Bezier curves are flattened by forward differencing, where
+  the number of steps for each curve is found from an upper limit
+  of its 2nd derivate.
 
   \param points Control points
   \param tolerance Maximum for the accepted error of the approximation
    
   \return polygon approximating the interpolating polynomials
 
-  \sa bezierControlLines(), QwtSplineBezier::toPolygon()
+  \sa bezierControlLines(), QwtBezier
  */
 QPolygonF QwtSplineInterpolating::polygon(
     const QPolygonF &points, double tolerance ) const
@@ -812,25 +1106,32 @@ QPolygonF QwtSplineInterpolating::polygon(
 
     const bool isClosed = boundaryType() == QwtSpline::ClosedPolygon;
 
-    QwtBezier bezier( tolerance );
-
     const QPointF *p = points.constData();
     const QLineF *cl = controlLines.constData();
 
     const int n = controlLines.size();
 
-    QPolygonF polygon;
+    QVector<int> steps( n );
+    int numPoints = 1;
 
-    for ( int i = 0; i < n - 1; i++ )
+    for ( int i = 0; i < n; i++ )
     {
-        const QLineF &l = cl[i];
-        bezier.appendToPolygon( p[i], l.p1(), l.p2(), p[i+1], polygon );
+        const QPointF &p2 = ( isClosed && i == n - 1 ) ? p[0] : p[i+1];
+
+        steps[i] = qwtBezierSteps( p[i], cl[i].p1(), cl[i].p2(), p2, tolerance );
+        numPoints += steps[i];
     }
 
-    const QPointF &pn = isClosed ? p[0] : p[n];
-    const QLineF &l = cl[n-1];
+    QPolygonF polygon( numPoints );
+    QPointF *pp = polygon.data();
 
-    bezier.appendToPolygon( p[n-1], l.p1(), l.p2(), pn, polygon );
+    *pp++ = p[0];
+
+    for ( int i = 0; i < n; i++ )
+    {
+        const QPointF &p2 = ( isClosed && i == n - 1 ) ? p[0] : p[i+1];
+        pp = qwtFlattenBezier( p[i], cl[i].p1(), cl[i].p2(), p2, steps[i], pp );
+    }
 
     return polygon;
 }
@@ -1104,6 +1405,24 @@ QVector<QLineF> QwtSplineC1::bezierControlLines( const QPolygonF &points ) const
     if ( n <= 2 )
         return QVector<QLineF>();
 
+    if ( parametrization()->type() == QwtSplineParametrization::ParameterX )
+    {
+        const int numThreads = effectiveThreadCount( n );
+        if ( numThreads > 1 )
+        {
+            const QVector<double> m = slopes( points );
+            if ( m.size() != n )
+                return QVector<QLineF>();
+
+            QVector<QLineF> lines( n - 1 );
+            qwtSplineRunParallel( qwtControlLinesFromSlopes, 
+                points.constData(), m.constData(), lines.data(), 
+                n - 1, numThreads );
+
+            return lines;
+        }
+    }
+
     ControlPointsStore store;
     switch( parametrization()->type() )
     {
@@ -1145,6 +1464,66 @@ QVector<QLineF> QwtSplineC1::bezierControlLines( const QPolygonF &points ) const
     return store.controlPoints;
 }
 
+/*!
+  \brief Interpolate a curve by a polygon
+
+  The implementation is optimized for non parametric curves
+  ( QwtSplineParametrization::ParameterX ) with conditional boundaries, 
+  where the polynomials are flattened by forward differencing without
+  calculating any Bezier curves. For all other splines it falls back
+  to QwtSplineInterpolating::polygon().
+
+  The number of steps for each polynomial is found from the maximum
+  of its 2nd derivate, so that the vertical distance between the
+  polygon and the polynomial is below the tolerance. 
+
+  \param points Control points
+  \param tolerance Maximum for the accepted error of the approximation
+   
+  \return polygon approximating the interpolating polynomials
+  \sa polynomials()
+ */
+QPolygonF QwtSplineC1::polygon( const QPolygonF &points, double tolerance ) const
+{
+    if ( tolerance <= 0.0 )
+        return QPolygonF();
+
+    const int n = points.size();
+
+    if ( n <= 2 
+        || parametrization()->type() != QwtSplineParametrization::ParameterX
+        || boundaryType() != QwtSpline::ConditionalBoundaries )
+    {
+        return QwtSplineInterpolating::polygon( points, tolerance );
+    }
+
+    const QVector<QwtSplinePolynomial> polynomials = this->polynomials( points );
+    if ( polynomials.size() != n - 1 )
+        return QPolygonF();
+
+    const QPointF *p = points.constData();
+    const QwtSplinePolynomial *pol = polynomials.constData();
+
+    QVector<int> steps( n - 1 );
+    int numPoints = 1;
+
+    for ( int i = 0; i < n - 1; i++ )
+    {
+        steps[i] = qwtPolynomialSteps( pol[i], p[i+1].x() - p[i].x(), tolerance );
+        numPoints += steps[i];
+    }
+
+    QPolygonF polygon( numPoints );
+    QPointF *pp = polygon.data();
+
+    *pp++ = p[0];
+
+    for ( int i = 0; i < n - 1; i++ )
+        pp = qwtFlattenPolynomial( p[i], p[i+1], pol[i], steps[i], pp );
+
+    return polygon;
+}
+
 /*!
   \brief Find an interpolated polygon with "equidistant" points
 
@@ -1205,6 +1584,17 @@ QVector<QwtSplinePolynomial> QwtSplineC1::polynomials(
     if ( m.size() < 2 )
         return polynomials;
 
+    const int numThreads = effectiveThreadCount( m.size() );
+    if ( numThreads > 1 )
+    {
+        polynomials.resize( m.size() - 1 );
+        qwtSplineRunParallel( qwtPolynomialsFromSlopes, 
+            points.constData(), m.constData(), polynomials.data(), 
+            m.size() - 1, numThreads );
+
+        return polynomials;
+    }
+
     for ( int i = 1; i < m.size(); i++ )
     {
         polynomials += QwtSplinePolynomial::fromSlopes( 
@@ -1347,13 +1737,11 @@ QVector<double> QwtSplineC2::slopes( const QPolygonF &points ) const
     const int n = points.size();
     const QPointF *p = points.constData();
 
-    QwtSplinePolynomial polynomial;
+    qwtSplineRunParallel( qwtSlopesFromCurvatures, p, cv, m, 
+        n - 1, effectiveThreadCount( n ) );
 
-    for ( int i = 0; i < n - 1; i++ )
-    {
-        polynomial = QwtSplinePolynomial::fromCurvatures( p[i], cv[i], p[i+1], cv[i+1] );
-        m[i] = polynomial.c1;
-    }
+    const QwtSplinePolynomial polynomial = 
+        QwtSplinePolynomial::fromCurvatures( p[n-2], cv[n-2], p[n-1], cv[n-1] );
 
     m[n-1] = polynomial.slopeAt( p[n-1].x() - p[n-2].x() );
 
@@ -1386,6 +1774,16 @@ QVector<QwtSplinePolynomial> QwtSplineC2::polynomials( const QPolygonF &points )
     const QPointF *p = points.constData();
     const double *cv = curvatures.constData();
     const int n = curvatures.size();
+
+    const int numThreads = effectiveThreadCount( n );
+    if ( numThreads > 1 )
+    {
+        polynomials.resize( n - 1 );
+        qwtSplineRunParallel( qwtPolynomialsFromCurvatures, 
+            p, cv, polynomials.data(), n - 1, numThreads );
+
+        return polynomials;
+    }
     
     for ( int i = 1; i < n; i++ )
     {   
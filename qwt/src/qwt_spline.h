@@ -168,11 +168,17 @@ public:
     void setBoundaryConditions( int condition,
         double valueBegin = 0.0, double valueEnd = 0.0 );
 
+    void setThreadCount( uint numThreads );
+    uint threadCount() const;
+
     virtual QPolygonF polygon( const QPolygonF &, double tolerance ) const;
     virtual QPainterPath painterPath( const QPolygonF & ) const = 0;
 
     virtual uint locality() const;
 
+protected:
+    int effectiveThreadCount( int numPoints ) const;
+
 private:
     Q_DISABLE_COPY(QwtSpline)
 
@@ -239,6 +245,8 @@ public:
     virtual QPolygonF equidistantPolygon( const QPolygonF &,
         double distance, bool withNodes ) const;
 
+    virtual QPolygonF polygon( const QPolygonF &, double tolerance ) const;
+
     // these methods are the non parametric part
     virtual QVector<QwtSplinePolynomial> polynomials( const QPolygonF & ) const;
     virtual QVector<double> slopes( const QPolygonF & ) const = 0;
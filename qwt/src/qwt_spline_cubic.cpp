@@ -9,6 +9,8 @@
 
 #include "qwt_spline_cubic.h"
 #include <qdebug.h>
+#include <qfuture.h>
+#include <qtconcurrentrun.h>
 
 #define SLOPES_INCREMENTAL 0
 #define KAHAN 0
@@ -773,6 +775,286 @@ namespace QwtSplineCubicP
     };
 }
 
+namespace QwtSplineCubicP
+{
+    /*
+      A block of the spline equations for the "SPIKE" algorithm.
+
+      Each block is resolved independently, ignoring the coupling
+      to its neighbours. The coupling is corrected later using
+      the "spikes" - the solutions for a unit vector at the first/last
+      row of the block. As the equations are strictly diagonally 
+      dominant the spikes decay by more than 1/2 with each row, so that
+      only the tips of the spikes are relevant.
+     */
+    class SpikeBlock
+    {
+    public:
+        enum { MaxTips = 64 };
+
+        inline void setup( const QPointF *points, double *b, int first, int last )
+        {
+            d_points = points;
+            d_b = b;
+
+            from = first;
+            to = last;
+
+            numTips = qMin( static_cast<int>( MaxTips ), to - from );
+        }
+
+        void solve()
+        {
+            d_cp.resize( to - from );
+
+            resolve( from, to, NULL, d_b + from );
+
+            double r[MaxTips];
+            for ( int i = 0; i < numTips; i++ )
+                r[i] = 0.0;
+
+            r[0] = 1.0;
+            resolve( from, from + numTips, r, w );
+
+            r[0] = 0.0;
+            r[numTips - 1] = 1.0;
+            resolve( to - numTips, to, r, v );
+        }
+
+        // the rows [from, to[ of the equation system
+        int from;
+        int to;
+
+        // tips of the spikes at the beginning and the end of the block
+        int numTips;
+        double w[MaxTips];
+        double v[MaxTips];
+
+    private:
+        void resolve( int first, int last, const double *rhs, double *x )
+        {
+            // Thomas algorithm with the spline equations of the rows [first, last[
+            // and the right hand side rhs - or the spline equations, when rhs is NULL
+
+            const QPointF *p = d_points;
+            double *cp = d_cp.data();
+
+            double cpPrev = 0.0;
+            double xPrev = 0.0;
+
+            for ( int i = first; i < last; i++ )
+            {
+                const double h1 = p[i].x() - p[i-1].x();
+                const double h2 = p[i+1].x() - p[i].x();
+
+                double r;
+                if ( rhs )
+                {
+                    r = rhs[i - first];
+                }
+                else
+                {
+                    const double s1 = ( p[i].y() - p[i-1].y() ) / h1;
+                    const double s2 = ( p[i+1].y() - p[i].y() ) / h2;
+
+                    r = 3.0 * ( s2 - s1 );
+                }
+
+                double d = 2.0 * ( h1 + h2 );
+                if ( i > first )
+                {
+                    d -= h1 * cpPrev;
+                    r -= h1 * xPrev;
+                }
+
+                cpPrev = cp[i - first] = h2 / d;
+                xPrev = x[i - first] = r / d;
+            }
+
+            for ( int i = last - 2; i >= first; i-- )
+                x[i - first] -= cp[i - first] * x[i - first + 1];
+        }
+
+        const QPointF *d_points;
+        double *d_b;
+        QVector<double> d_cp;
+    };
+
+    template <class T>
+    class SpikeSystem
+    {
+    public:
+        void setStartCondition( double p, double q, double u, double r )
+        {
+            d_conditionsEQ[0].setup( p, q, u, r );
+        }
+
+        void setEndCondition( double p, double q, double u, double r )
+        {
+            d_conditionsEQ[1].setup( p, q, u, r );
+        }
+
+        const T &store() const 
+        { 
+            return d_store;
+        }
+
+        /*
+          Resolve the equation system splitting it into numThreads blocks,
+          that are resolved in parallel. When the system can't be resolved
+          this way false is returned and the sequential implementation has 
+          to be used.
+         */
+        bool resolve( const QPolygonF &points, int numThreads ) 
+        {
+            const int n = points.size();
+            const QPointF *p = points.constData();
+
+            const Equation3 &eq0 = d_conditionsEQ[0];
+            const Equation3 &eqN = d_conditionsEQ[1];
+
+            if ( numThreads < 2 || eq0.p == 0.0 || eqN.u == 0.0 )
+                return false;
+
+            const int chunkSize = ( n - 2 ) / numThreads;
+            if ( chunkSize < 2 * SpikeBlock::MaxTips )
+                return false;
+
+            QVector<double> values( n );
+            double *b = values.data();
+
+            QVector<SpikeBlock> blocks( numThreads );
+            SpikeBlock *blk = blocks.data();
+
+            for ( int i = 0; i < numThreads; i++ )
+            {
+                const int from = 1 + i * chunkSize;
+                const int to = ( i == numThreads - 1 ) ? n - 1 : from + chunkSize;
+
+                blk[i].setup( p, b, from, to );
+            }
+
+#if !defined(QT_NO_QFUTURE)
+            QList< QFuture<void> > futures;
+            for ( int i = 0; i < numThreads - 1; i++ )
+                futures += QtConcurrent::run( &blk[i], &SpikeBlock::solve );
+
+            blk[numThreads - 1].solve();
+
+            for ( int i = 0; i < futures.size(); i++ )
+                futures[i].waitForFinished();
+#else
+            for ( int i = 0; i < numThreads; i++ )
+                blk[i].solve();
+#endif
+
+            // the values at the interfaces between the blocks
+
+            QVector<double> x( numThreads ), y( numThreads );
+            for ( int i = 0; i < numThreads - 1; i++ )
+            {
+                const int k = blk[i].to;
+                const double h = p[k].x() - p[k-1].x();
+
+                const double cv = h * blk[i].v[blk[i].numTips - 1];
+                const double aw = h * blk[i+1].w[0];
+
+                const double denom = 1.0 - cv * aw;
+                if ( denom == 0.0 )
+                    return false;
+
+                x[i] = ( b[k-1] - cv * b[k] ) / denom;
+                y[i] = b[k] - aw * x[i];
+            }
+
+            for ( int i = 0; i < numThreads; i++ )
+            {
+                const SpikeBlock &block = blk[i];
+
+                if ( i > 0 )
+                {
+                    const double h = p[block.from].x() - p[block.from - 1].x();
+                    for ( int k = 0; k < block.numTips; k++ )
+                        b[block.from + k] -= h * x[i-1] * block.w[k];
+                }
+
+                if ( i < numThreads - 1 )
+                {
+                    const double h = p[block.to].x() - p[block.to - 1].x();
+                    for ( int k = 0; k < block.numTips; k++ )
+                        b[block.to - block.numTips + k] -= h * y[i] * block.v[k];
+                }
+            }
+
+            // the boundary conditions
+
+            const SpikeBlock &blk0 = blk[0];
+            const SpikeBlock &blkN = blk[numThreads - 1];
+            const int tips = blkN.numTips;
+
+            const double h0 = p[1].x() - p[0].x();
+            const double hn = p[n-1].x() - p[n-2].x();
+
+            const double denom0 = eq0.p - eq0.q * h0 * blk0.w[0] 
+                - eq0.u * h0 * blk0.w[1];
+
+            const double denomN = eqN.u - eqN.p * hn * blkN.v[tips - 2] 
+                - eqN.q * hn * blkN.v[tips - 1];
+
+            if ( denom0 == 0.0 || denomN == 0.0 )
+                return false;
+
+            const double b0 = ( eq0.r - eq0.q * b[1] - eq0.u * b[2] ) / denom0;
+            const double bn = ( eqN.r - eqN.p * b[n-3] - eqN.q * b[n-2] ) / denomN;
+
+            for ( int k = 0; k < blk0.numTips; k++ )
+                b[1 + k] -= b0 * h0 * blk0.w[k];
+
+            for ( int k = 0; k < tips; k++ )
+                b[n - 1 - tips + k] -= bn * hn * blkN.v[k];
+
+            b[0] = b0;
+            b[n-1] = bn;
+
+            // storing the results
+
+            d_store.setup( n );
+            d_store.storeFirst( h0, p[0], p[1], b[0], b[1] );
+
+#if !defined(QT_NO_QFUTURE) && !SLOPES_INCREMENTAL
+            futures.clear();
+            for ( int i = 0; i < numThreads - 1; i++ )
+            {
+                futures += QtConcurrent::run( this, &SpikeSystem<T>::storeRange,
+                    p, b, blk[i].from, blk[i].to );
+            }
+
+            storeRange( p, b, blkN.from, n );
+
+            for ( int i = 0; i < futures.size(); i++ )
+                futures[i].waitForFinished();
+#else
+            storeRange( p, b, 1, n );
+#endif
+
+            return true;
+        }
+
+    private:
+        void storeRange( const QPointF *p, const double *b, int from, int to )
+        {
+            for ( int i = from; i < to; i++ )
+            {
+                d_store.storeNext( i, p[i].x() - p[i-1].x(), 
+                    p[i-1], p[i], b[i-1], b[i] );
+            }
+        }
+
+        Equation3 d_conditionsEQ[2];
+        T d_store;
+    };
+}
+
 static void qwtSetupEndEquations( 
     int conditionBegin, double valueBegin, int conditionEnd, double valueEnd, 
     const QPolygonF &points, QwtSplineCubicP::Equation3 eq[2] )
@@ -998,6 +1280,9 @@ uint QwtSplineCubic::locality() const
   In opposite to the implementation QwtSplineC2::slopes the first derivates
   are calculated directly, without calculating the second derivates first.
 
+  For huge polygons with conditional boundaries the equation system
+  is resolved in parallel ( QwtSpline::setThreadCount() ).
+
   \param points Control nodes of the spline
   \return Vector with the values of the 2nd derivate at the control points
 
@@ -1059,6 +1344,17 @@ QVector<double> QwtSplineCubic::slopes( const QPolygonF &points ) const
         boundaryValue( QwtSpline::AtEnd ), 
         points, eq );
 
+    const int numThreads = effectiveThreadCount( points.size() );
+    if ( numThreads > 1 )
+    {
+        SpikeSystem<SlopeStore> spikes;
+        spikes.setStartCondition( eq[0].p, eq[0].q, eq[0].u, eq[0].r );
+        spikes.setEndCondition( eq[1].p, eq[1].q, eq[1].u, eq[1].r );
+
+        if ( spikes.resolve( points, numThreads ) )
+            return spikes.store().slopes();
+    }
+
     EquationSystem<SlopeStore> eqs;
     eqs.setStartCondition( eq[0].p, eq[0].q, eq[0].u, eq[0].r );
     eqs.setEndCondition( eq[1].p, eq[1].q, eq[1].u, eq[1].r );
@@ -1070,6 +1366,9 @@ QVector<double> QwtSplineCubic::slopes( const QPolygonF &points ) const
 /*!
   \brief Find the second derivative at the control points
 
+  For huge polygons with conditional boundaries the equation system
+  is resolved in parallel ( QwtSpline::setThreadCount() ).
+
   \param points Control nodes of the spline
   \return Vector with the values of the 2nd derivate at the control points
 
@@ -1109,6 +1408,17 @@ QVector<double> QwtSplineCubic::curvatures( const QPolygonF &points ) const
         boundaryValue( QwtSpline::AtEnd ),
         points, eq );
 
+    const int numThreads = effectiveThreadCount( points.size() );
+    if ( numThreads > 1 )
+    {
+        SpikeSystem<CurvatureStore> spikes;
+        spikes.setStartCondition( eq[0].p, eq[0].q, eq[0].u, eq[0].r );
+        spikes.setEndCondition( eq[1].p, eq[1].q, eq[1].u, eq[1].r );
+
+        if ( spikes.resolve( points, numThreads ) )
+            return spikes.store().curvatures();
+    }
+
     EquationSystem<CurvatureStore> eqs;
     eqs.setStartCondition( eq[0].p, eq[0].q, eq[0].u, eq[0].r );
     eqs.setEndCondition( eq[1].p, eq[1].q, eq[1].u, eq[1].r );
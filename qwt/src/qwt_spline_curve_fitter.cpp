@@ -11,18 +11,88 @@
 #include "qwt_spline_local.h"
 #include "qwt_spline_parametrization.h"
 
+static inline bool qwtIntersects( const QRectF &rect,
+    const QPointF &p1, const QPointF &p2 )
+{
+    if ( qMax( p1.x(), p2.x() ) < rect.left() 
+        || qMin( p1.x(), p2.x() ) > rect.right() )
+    {
+        return false;
+    }
+
+    if ( qMax( p1.y(), p2.y() ) < rect.top() 
+        || qMin( p1.y(), p2.y() ) > rect.bottom() )
+    {
+        return false;
+    }
+
+    return true;
+}
+
+/*
+  Find the first and the last segment, where the bounding rectangle
+  of its end points intersects with rect. We expect, that the 
+  interpolating curve doesn't leave the bounding rectangles of 
+  its segments much.
+ */
+static bool qwtVisibleRange( const QPolygonF &points, 
+    const QRectF &rect, int &from, int &to )
+{
+    const int n = points.size();
+    const QPointF *p = points.constData();
+
+    from = -1;
+    for ( int i = 0; i < n - 1; i++ )
+    {
+        if ( qwtIntersects( rect, p[i], p[i+1] ) )
+        {
+            from = i;
+            break;
+        }
+    }
+
+    if ( from < 0 )
+        return false;
+
+    to = from + 1;
+    for ( int i = n - 1; i > from + 1; i-- )
+    {
+        if ( qwtIntersects( rect, p[i-1], p[i] ) )
+        {
+            to = i;
+            break;
+        }
+    }
+
+    return true;
+}
+
+class QwtSplineCurveFitter::PrivateData
+{
+public:
+    PrivateData():
+        spline( NULL )
+    {
+    }
+
+    QwtSpline *spline;
+};
+
 //! Constructor
 QwtSplineCurveFitter::QwtSplineCurveFitter():
     QwtCurveFitter( QwtCurveFitter::Path )
 {
-    d_spline = new QwtSplineLocal( QwtSplineLocal::Cardinal );
-    d_spline->setParametrization( QwtSplineParametrization::ParameterUniform );
+    d_data = new PrivateData;
+
+    d_data->spline = new QwtSplineLocal( QwtSplineLocal::Cardinal );
+    d_data->spline->setParametrization( QwtSplineParametrization::ParameterUniform );
 }
 
 //! Destructor
 QwtSplineCurveFitter::~QwtSplineCurveFitter()
 {
-    delete d_spline;
+    delete d_data->spline;
+    delete d_data;
 }
 
 /*!
@@ -36,11 +106,11 @@ QwtSplineCurveFitter::~QwtSplineCurveFitter()
 */
 void QwtSplineCurveFitter::setSpline( QwtSpline *spline )
 {
-    if ( d_spline == spline )
+    if ( d_data->spline == spline )
         return;
 
-    delete d_spline;
-    d_spline = spline;
+    delete d_data->spline;
+    d_data->spline = spline;
 }
 
 /*!
@@ -49,7 +119,7 @@ void QwtSplineCurveFitter::setSpline( QwtSpline *spline )
 */
 const QwtSpline *QwtSplineCurveFitter::spline() const
 {
-    return d_spline;
+    return d_data->spline;
 }
 
 /*!
@@ -58,7 +128,7 @@ const QwtSpline *QwtSplineCurveFitter::spline() const
 */
 QwtSpline *QwtSplineCurveFitter::spline() 
 {
-    return d_spline;
+    return d_data->spline;
 }
 
 /*!
@@ -73,9 +143,9 @@ QPolygonF QwtSplineCurveFitter::fitCurve( const QPolygonF &points ) const
 {
     const QPainterPath path = fitCurvePath( points );
 
-    const QList<QPolygonF> subPaths = fitCurvePath( points ).toSubpathPolygons();
+    const QList<QPolygonF> subPaths = path.toSubpathPolygons();
     if ( subPaths.size() == 1 )
-        subPaths.first();
+        return subPaths.first();
 
     return QPolygonF();
 }
@@ -86,14 +156,123 @@ QPolygonF QwtSplineCurveFitter::fitCurve( const QPolygonF &points ) const
   \param points Series of data points
   \return Fitted Curve
 
-  \sa fitCurve()
+  \sa fitCurve(), fitCurvePathInRect()
 */
 QPainterPath QwtSplineCurveFitter::fitCurvePath( const QPolygonF &points ) const
 {
+    const QwtSpline *spline = d_data->spline;
+    if ( spline == NULL )
+        return QPainterPath();
+
+    return spline->painterPath( points );
+}
+
+/*!
+  Find a curve path which has the best fit to the part of a series
+  of data points, that is inside a rectangle of interest
+
+  Only the segments of the curve, that intersect with the rectangle,
+  are fitted. This is done for splines with conditional boundaries only, 
+  for all other splines the result is the same as fitCurvePath().
+
+  \param points Series of data points
+  \param rect Rectangle of interest in the coordinates of the points,
+              an invalid rectangle means the complete curve
+
+  \return Fitted Curve
+  \sa fitCurvePath(), isRestrictingToRect()
+*/
+QPainterPath QwtSplineCurveFitter::fitCurvePathInRect( 
+    const QPolygonF &points, const QRectF &rect ) const
+{
+    const QwtSpline *spline = d_data->spline;
+    if ( spline == NULL )
+        return QPainterPath();
+
+    if ( rect.isValid() && points.size() > 2
+        && spline->boundaryType() == QwtSpline::ConditionalBoundaries )
+    {
+        int from, to;
+        if ( !qwtVisibleRange( points, rect, from, to ) )
+            return QPainterPath();
+
+        if ( spline->locality() > 0 )
+            return fitLocal( points, from, to );
+
+        if ( dynamic_cast<const QwtSplineInterpolating *>( spline ) )
+            return fitSegments( points, from, to );
+    }
+
+    return spline->painterPath( points );
+}
+
+/*!
+  \return True, when the spline has conditional boundaries and is
+          local or interpolating, so that fitCurvePathInRect() 
+          fits the visible segments only
+  \sa fitCurvePathInRect()
+ */
+bool QwtSplineCurveFitter::isRestrictingToRect() const
+{
+    const QwtSpline *spline = d_data->spline;
+    if ( spline == NULL 
+        || spline->boundaryType() != QwtSpline::ConditionalBoundaries )
+    {
+        return false;
+    }
+
+    return spline->locality() > 0
+        || dynamic_cast<const QwtSplineInterpolating *>( spline ) != NULL;
+}
+
+QPainterPath QwtSplineCurveFitter::fitLocal( 
+    const QPolygonF &points, int from, int to ) const
+{
+    const QwtSpline *spline = d_data->spline;
+
+    /*
+      The polynomials of the visible segments depend on
+      "locality" neighbours on each side. One more segment
+      is included, as the curve might bulge into the visible area.
+     */
+    const int margin = spline->locality() + 1;
+
+    from = qMax( from - margin, 0 );
+    to = qMin( to + margin, points.size() - 1 );
+
+    if ( from == 0 && to == points.size() - 1 )
+        return spline->painterPath( points );
+
+    return spline->painterPath( points.mid( from, to - from + 1 ) );
+}
+
+QPainterPath QwtSplineCurveFitter::fitSegments( 
+    const QPolygonF &points, int from, int to ) const
+{
+    const QwtSplineInterpolating *spline = 
+        static_cast<const QwtSplineInterpolating *>( d_data->spline );
+
+    const int n = points.size();
+
+    // the control lines depend on all points
+
+    const QVector<QLineF> lines = spline->bezierControlLines( points );
+    if ( lines.size() < n - 1 )
+        return QPainterPath();
+
+    // one more segment, as the curve might bulge into the visible area
+
+    from = qMax( from - 1, 0 );
+    to = qMin( to + 1, n - 1 );
+
+    const QPointF *p = points.constData();
+    const QLineF *l = lines.constData();
+
     QPainterPath path;
+    path.moveTo( p[from] );
 
-    if ( d_spline )
-        path = d_spline->painterPath( points );
+    for ( int i = from; i < to; i++ )
+        path.cubicTo( l[i].p1(), l[i].p2(), p[i+1] );
 
     return path;
 }
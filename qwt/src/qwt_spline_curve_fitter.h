@@ -20,6 +20,12 @@ class QwtSpline;
   The default setting for the spline is a cardinal spline with
   uniform parametrization.
 
+  fitCurvePathInRect() fits only the part of the curve, that
+  is inside a rectangle of interest. For local splines ( QwtSpline::locality() )
+  this is done from a subpolygon including the neighbours, that
+  have an effect on the visible polynomials. For other interpolating
+  splines only the path of the visible segments is built.
+
   \sa QwtSpline, QwtSplineLocal
 */
 class QWT_EXPORT QwtSplineCurveFitter: public QwtCurveFitter
@@ -36,8 +42,17 @@ public:
     virtual QPolygonF fitCurve( const QPolygonF & ) const;
     virtual QPainterPath fitCurvePath( const QPolygonF & ) const;
 
+    virtual QPainterPath fitCurvePathInRect( 
+        const QPolygonF &, const QRectF & ) const;
+
+    virtual bool isRestrictingToRect() const;
+
 private:
-    QwtSpline *d_spline;
+    QPainterPath fitLocal( const QPolygonF &, int from, int to ) const;
+    QPainterPath fitSegments( const QPolygonF &, int from, int to ) const;
+
+    class PrivateData;
+    PrivateData *d_data;
 };
 
 #endif
@@ -0,0 +1,324 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#include "qwt_spline_incremental.h"
+#include "qwt_spline_cubic.h"
+#include "qwt_spline_parametrization.h"
+
+class QwtSplineIncremental::PrivateData
+{
+public:
+    PrivateData():
+        spline( NULL ),
+        windowSize( 64 )
+    {
+    }
+
+    QwtSplineC1 *spline;
+    int windowSize;
+
+    QPolygonF points;
+    QVector<double> slopes;
+    QVector<QwtSplinePolynomial> polynomials;
+};
+
+/*!
+  \brief Constructor
+
+  The spline needs to be allocated by new and will be deleted
+  in the destructor.
+
+  \param spline Spline
+ */
+QwtSplineIncremental::QwtSplineIncremental( QwtSplineC1 *spline )
+{
+    d_data = new PrivateData;
+    d_data->spline = spline;
+}
+
+//! Destructor
+QwtSplineIncremental::~QwtSplineIncremental()
+{
+    delete d_data->spline;
+    delete d_data;
+}
+
+/*!
+  Assign a spline
+
+  The spline needs to be allocated by new and will be deleted
+  in the destructor. All coefficients are recalculated.
+
+  \param spline Spline
+  \sa spline()
+ */
+void QwtSplineIncremental::setSpline( QwtSplineC1 *spline )
+{
+    if ( d_data->spline == spline )
+        return;
+
+    delete d_data->spline;
+    d_data->spline = spline;
+
+    recalculate();
+}
+
+/*!
+  \return Spline
+  \sa setSpline()
+ */
+const QwtSplineC1 *QwtSplineIncremental::spline() const
+{
+    return d_data->spline;
+}
+
+/*!
+  \return Spline
+  \note After modifying the spline invalidate() needs to be called
+  \sa setSpline(), invalidate()
+ */
+QwtSplineC1 *QwtSplineIncremental::spline()
+{
+    return d_data->spline;
+}
+
+/*!
+  \brief Set the number of points, that are resolved again for a cubic spline
+
+  When appending points to a QwtSplineCubic the equation system is 
+  resolved for the last windowSize points only. The default setting is 64.
+
+  \param size Number of points
+  \sa windowSize()
+ */
+void QwtSplineIncremental::setWindowSize( int size )
+{
+    d_data->windowSize = qMax( size, 4 );
+}
+
+/*!
+  \return Number of points, that are resolved again for a cubic spline
+  \sa setWindowSize()
+ */
+int QwtSplineIncremental::windowSize() const
+{
+    return d_data->windowSize;
+}
+
+/*!
+  \brief Assign the points and calculate all coefficients
+
+  \param points Control points
+  \sa append(), points()
+ */
+void QwtSplineIncremental::setPoints( const QPolygonF &points )
+{
+    d_data->points = points;
+    recalculate();
+}
+
+/*!
+  \brief Append points and update the coefficients of the tail
+
+  \param points Control points, that are appended
+  \sa setPoints(), points()
+ */
+void QwtSplineIncremental::append( const QPolygonF &points )
+{
+    if ( points.isEmpty() )
+        return;
+
+    const int numOldPoints = d_data->points.size();
+
+    d_data->points += points;
+    updateTail( numOldPoints );
+}
+
+/*!
+  \brief Append a point and update the coefficients of the tail
+
+  \param point Control point, that is appended
+  \sa setPoints(), points()
+ */
+void QwtSplineIncremental::append( const QPointF &point )
+{
+    const int numOldPoints = d_data->points.size();
+
+    d_data->points += point;
+    updateTail( numOldPoints );
+}
+
+//! Remove all points and coefficients
+void QwtSplineIncremental::clear()
+{
+    d_data->points.clear();
+    d_data->slopes.clear();
+    d_data->polynomials.clear();
+}
+
+/*!
+  \brief Recalculate all coefficients
+
+  This needs to be done, when the spline has been modified.
+  \sa spline()
+ */
+void QwtSplineIncremental::invalidate()
+{
+    recalculate();
+}
+
+/*!
+  \return Control points
+  \sa setPoints(), append()
+ */
+const QPolygonF &QwtSplineIncremental::points() const
+{
+    return d_data->points;
+}
+
+/*!
+  \return Slopes at the control points
+  \sa polynomials(), QwtSplineC1::slopes()
+ */
+const QVector<double> &QwtSplineIncremental::slopes() const
+{
+    return d_data->slopes;
+}
+
+/*!
+  \return Interpolating polynomials
+  \sa slopes(), QwtSplineC1::polynomials()
+ */
+const QVector<QwtSplinePolynomial> &QwtSplineIncremental::polynomials() const
+{
+    return d_data->polynomials;
+}
+
+void QwtSplineIncremental::recalculate()
+{
+    const QwtSplineC1 *spline = d_data->spline;
+    const QPolygonF &points = d_data->points;
+
+    d_data->slopes.clear();
+    d_data->polynomials.clear();
+
+    if ( spline == NULL || points.size() < 2 )
+        return;
+
+    const QVector<double> m = spline->slopes( points );
+    if ( m.size() != points.size() )
+        return;
+
+    d_data->slopes = m;
+
+    const QPointF *p = points.constData();
+
+    QVector<QwtSplinePolynomial> &polynomials = d_data->polynomials;
+    polynomials.resize( points.size() - 1 );
+
+    for ( int i = 0; i < polynomials.size(); i++ )
+    {
+        polynomials[i] = QwtSplinePolynomial::fromSlopes( 
+            p[i], m[i], p[i+1], m[i+1] );
+    }
+}
+
+void QwtSplineIncremental::updateTail( int numOldPoints )
+{
+    const QwtSplineC1 *spline = d_data->spline;
+    const QPolygonF &points = d_data->points;
+    const int n = points.size();
+
+    if ( spline == NULL || numOldPoints < 2 
+        || d_data->slopes.size() != numOldPoints
+        || spline->boundaryType() != QwtSpline::ConditionalBoundaries )
+    {
+        recalculate();
+        return;
+    }
+
+    // the slopes from index "from" need to be recalculated,
+    // what is done from a subpolygon starting at "offset"
+
+    int from = -1;
+    int offset = -1;
+
+    QVector<double> m;
+
+    const int locality = spline->locality();
+    if ( locality > 0 )
+    {
+        /*
+          The slopes of the last "locality" points have been 
+          calculated from the boundary conditions, and the
+          slopes of the first "locality" points of the subpolygon
+          depend on them. So we need a margin on both sides.
+         */
+        from = numOldPoints - 1 - locality;
+        offset = from - locality - 2;
+
+        if ( offset > 0 )
+            m = spline->slopes( points.mid( offset ) );
+    }
+    else
+    {
+        const QwtSplineCubic *cubic = 
+            dynamic_cast<const QwtSplineCubic *>( spline );
+
+        if ( cubic )
+        {
+            /*
+              Resolving the last points again, clamping the first 
+              slope of the window to the value, we already know.
+             */
+            offset = from = numOldPoints - 1 - d_data->windowSize;
+
+            if ( offset > 0 )
+            {
+                QwtSplineCubic window;
+                window.setParametrization( cubic->parametrization()->type() );
+
+                window.setBoundaryCondition( QwtSpline::AtBeginning, 
+                    QwtSpline::Clamped1 );
+                window.setBoundaryValue( QwtSpline::AtBeginning, 
+                    d_data->slopes[offset] );
+
+                window.setBoundaryCondition( QwtSpline::AtEnd,
+                    cubic->boundaryCondition( QwtSpline::AtEnd ) );
+                window.setBoundaryValue( QwtSpline::AtEnd,
+                    cubic->boundaryValue( QwtSpline::AtEnd ) );
+
+                m = window.slopes( points.mid( offset ) );
+            }
+        }
+    }
+
+    if ( offset <= 0 || m.size() != n - offset )
+    {
+        recalculate();
+        return;
+    }
+
+    QVector<double> &slopes = d_data->slopes;
+    slopes.resize( n );
+
+    for ( int i = from; i < n; i++ )
+        slopes[i] = m[i - offset];
+
+    const QPointF *p = points.constData();
+
+    QVector<QwtSplinePolynomial> &polynomials = d_data->polynomials;
+    polynomials.resize( n - 1 );
+
+    for ( int i = qMax( from - 1, 0 ); i < n - 1; i++ )
+    {
+        polynomials[i] = QwtSplinePolynomial::fromSlopes( 
+            p[i], slopes[i], p[i+1], slopes[i+1] );
+    }
+}
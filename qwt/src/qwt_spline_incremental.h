@@ -0,0 +1,89 @@
+/* -*- mode: C++ ; c-file-style: "stroustrup" -*- *****************************
+ * Qwt Widget Library
+ * Copyright (C) 1997   Josef Wilgen
+ * Copyright (C) 2002   Uwe Rathmann
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the Qwt License, Version 1.0
+ *****************************************************************************/
+
+#ifndef QWT_SPLINE_INCREMENTAL_H
+#define QWT_SPLINE_INCREMENTAL_H 1
+
+#include "qwt_global.h"
+#include "qwt_spline_polynomial.h"
+#include <qpolygon.h>
+#include <qvector.h>
+
+class QwtSplineC1;
+
+/*!
+  \brief A spline, that keeps its coefficients for a growing polygon
+
+  QwtSplineC1::polynomials() calculates all coefficients from scratch
+  for each call. QwtSplineIncremental keeps the points, the slopes 
+  and the polynomials, so that appending points only updates the
+  tail - what is important for realtime curves, where a couple of
+  points are appended for each frame.
+
+  - For local splines ( QwtSpline::locality() > 0 ) the update is exact: 
+    the slopes of the last points are recalculated from a subpolygon,
+    that includes all neighbours having an effect on them.
+
+  - For QwtSplineCubic the last windowSize() points are resolved
+    again, using the slope, that is known from the previous calculation,
+    as start condition. As the influence of a point is decaying by more
+    than 1/2 for each neighbour the error is below the precision 
+    of a double for the default setting.
+
+  - For all other splines, or closed/periodic boundaries, 
+    everything is recalculated.
+
+  \code
+QwtSplineIncremental spline( new QwtSplineCubic() );
+spline.setPoints( points );
+
+...
+spline.append( newPoints );
+const QVector<QwtSplinePolynomial> polynomials = spline.polynomials();
+  \endcode
+
+  \note The points need to have increasing x coordinates and the spline
+        needs to be used with QwtSplineParametrization::ParameterX.
+ */
+class QWT_EXPORT QwtSplineIncremental
+{
+public:
+    explicit QwtSplineIncremental( QwtSplineC1 * = NULL );
+    ~QwtSplineIncremental();
+
+    void setSpline( QwtSplineC1 * );
+
+    const QwtSplineC1 *spline() const;
+    QwtSplineC1 *spline();
+
+    void setWindowSize( int );
+    int windowSize() const;
+
+    void setPoints( const QPolygonF & );
+    void append( const QPolygonF & );
+    void append( const QPointF & );
+    void clear();
+
+    void invalidate();
+
+    const QPolygonF &points() const;
+    const QVector<double> &slopes() const;
+    const QVector<QwtSplinePolynomial> &polynomials() const;
+
+private:
+    Q_DISABLE_COPY(QwtSplineIncremental)
+
+    void recalculate();
+    void updateTail( int numOldPoints );
+
+    class PrivateData;
+    PrivateData *d_data;
+};
+
+#endif
@@ -10,6 +10,8 @@
 #include "qwt_spline_local.h"
 #include "qwt_spline_parametrization.h"
 #include <qmath.h>
+#include <qfuture.h>
+#include <qtconcurrentrun.h>
 
 static inline bool qwtIsStrictlyMonotonic( double dy1, double dy2 )
 {
@@ -384,6 +386,116 @@ static inline SplineStore qwtSplineAkima(
     return store;
 }
 
+// calculating the slopes at the points [from, to[ 
+typedef void ( *QwtSlopesFunction )( const QPointF *, double *, int, int );
+
+static void qwtRunSlopesParallel( QwtSlopesFunction function,
+    const QPointF *points, double *slopes, int from, int to, int numThreads )
+{
+#if !defined(QT_NO_QFUTURE)
+    const int chunkSize = ( to - from ) / numThreads;
+
+    QList< QFuture<void> > futures;
+    for ( int i = 0; i < numThreads - 1; i++ )
+    {
+        const int index = from + i * chunkSize;
+
+        futures += QtConcurrent::run( function, 
+            points, slopes, index, index + chunkSize );
+    }
+
+    function( points, slopes, from + ( numThreads - 1 ) * chunkSize, to );
+
+    for ( int i = 0; i < futures.size(); i++ )
+        futures[i].waitForFinished();
+#else
+    Q_UNUSED( numThreads )
+    function( points, slopes, from, to );
+#endif
+}
+
+template< class Slope >
+static void qwtSlopesL1( const QPointF *p, double *m, int from, int to )
+{
+    for ( int i = from; i < to; i++ )
+    {
+        const double dx1 = p[i].x() - p[i-1].x();
+        const double dy1 = p[i].y() - p[i-1].y();
+        const double dx2 = p[i+1].x() - p[i].x();
+        const double dy2 = p[i+1].y() - p[i].y();
+
+        m[i] = Slope::value( dx1, dy1, dy1 / dx1, dx2, dy2, dy2 / dx2 );
+    }
+}
+
+static void qwtSlopesAkima( const QPointF *p, double *m, int from, int to )
+{
+    // the slopes of the neighbours are needed: 2 <= i < n - 2
+
+    for ( int i = from; i < to; i++ )
+    {
+        m[i] = qwtSlopeAkima( p[i-2], p[i-1], p[i], p[i+1], p[i+2] );
+    }
+}
+
+static QVector<double> qwtSlopesParallel( 
+    const QwtSplineLocal *spline, const QPolygonF &points, int numThreads )
+{
+    using namespace QwtSplineLocalP;
+
+    const int n = points.size();
+    const QPointF *p = points.constData();
+
+    QVector<double> slopes( n );
+    double *m = slopes.data();
+
+    switch( spline->type() )
+    {
+        case QwtSplineLocal::Cardinal:
+        {
+            qwtSplineBoundariesL1<slopeCardinal>( spline, points, m[0], m[n-1] );
+            qwtRunSlopesParallel( qwtSlopesL1<slopeCardinal>, 
+                p, m, 1, n - 1, numThreads );
+            break;
+        }
+        case QwtSplineLocal::ParabolicBlending:
+        {
+            qwtSplineBoundariesL1<slopeParabolicBlending>( spline, points, m[0], m[n-1] );
+            qwtRunSlopesParallel( qwtSlopesL1<slopeParabolicBlending>, 
+                p, m, 1, n - 1, numThreads );
+            break;
+        }
+        case QwtSplineLocal::PChip:
+        {
+            qwtSplineBoundariesL1<slopePChip>( spline, points, m[0], m[n-1] );
+            qwtRunSlopesParallel( qwtSlopesL1<slopePChip>, 
+                p, m, 1, n - 1, numThreads );
+            break;
+        }
+        case QwtSplineLocal::Akima:
+        {
+            qwtSplineAkimaBoundaries( spline, points, m[0], m[n-1] );
+
+            const double s0 = qwtSlopeLine( p[0], p[1] );
+            const double sn = qwtSlopeLine( p[n-2], p[n-1] );
+
+            m[1] = qwtSlopeAkima( 0.5 * s0, s0, 
+                qwtSlopeLine( p[1], p[2] ), qwtSlopeLine( p[2], p[3] ) );
+
+            m[n-2] = qwtSlopeAkima( qwtSlopeLine( p[n-4], p[n-3] ),
+                qwtSlopeLine( p[n-3], p[n-2] ), sn, 0.5 * sn );
+
+            qwtRunSlopesParallel( qwtSlopesAkima, 
+                p, m, 2, n - 2, numThreads );
+            break;
+        }
+        default:
+            break;
+    }
+
+    return slopes;
+}
+
 template< class SplineStore >
 static inline SplineStore qwtSplineLocal( 
     const QwtSplineLocal *spline, const QVector<QPointF> &points )
@@ -501,6 +613,12 @@ QVector<QLineF> QwtSplineLocal::bezierControlLines( const QPolygonF &points ) co
 {
     if ( parametrization()->type() == QwtSplineParametrization::ParameterX )
     {   
+        if ( effectiveThreadCount( points.size() ) > 1 )
+        {
+            // parallel calculation of the slopes and the control lines
+            return QwtSplineC1::bezierControlLines( points );
+        }
+
         using namespace QwtSplineLocalP;
         return qwtSplineLocal<ControlPointsStore>( this, points ).controlPoints;
     }
@@ -511,6 +629,9 @@ QVector<QLineF> QwtSplineLocal::bezierControlLines( const QPolygonF &points ) co
 /*! 
   \brief Find the first derivative at the control points
 
+  For huge polygons the slopes are calculated in parallel
+  ( QwtSpline::setThreadCount() ).
+
   \param points Control nodes of the spline
   \return Vector with the values of the 2nd derivate at the control points
 
@@ -518,6 +639,10 @@ QVector<QLineF> QwtSplineLocal::bezierControlLines( const QPolygonF &points ) co
  */
 QVector<double> QwtSplineLocal::slopes( const QPolygonF &points ) const
 {
+    const int numThreads = effectiveThreadCount( points.size() );
+    if ( numThreads > 1 )
+        return qwtSlopesParallel( this, points, numThreads );
+
     using namespace QwtSplineLocalP;
     return qwtSplineLocal<SlopeStore>( this, points ).slopes;
 }
@@ -11,6 +11,9 @@
 #include "qwt_math.h"
 #include <qstack.h>
 #include <qvector.h>
+#include <qthread.h>
+#include <qfuture.h>
+#include <qtconcurrentrun.h>
 
 #if QT_VERSION < 0x040601
 #define qFabs(x) ::fabs(x)
@@ -20,15 +23,149 @@ class QwtWeedingCurveFitter::PrivateData
 {
 public:
     PrivateData():
+        algorithm( QwtWeedingCurveFitter::DouglasPeucker ),
         tolerance( 1.0 ),
-        chunkSize( 0 )
+        chunkSize( 0 ),
+        numThreads( 1 )
     {
     }
 
+    QwtWeedingCurveFitter::Algorithm algorithm;
     double tolerance;
     uint chunkSize;
+    uint numThreads;
 };
 
+static inline double qwtTriangleArea( 
+    const QPointF &p1, const QPointF &p2, const QPointF &p3 )
+{
+    const double cross = ( p2.x() - p1.x() ) * ( p3.y() - p1.y() )
+        - ( p3.x() - p1.x() ) * ( p2.y() - p1.y() );
+
+    return 0.5 * qAbs( cross );
+}
+
+namespace
+{
+    // min heap of point indices ordered by their effective area,
+    // that allows to update the area of a point in O( log n )
+
+    class AreaHeap
+    {
+    public:
+        AreaHeap( const QVector<double> &area ):
+            d_area( area ),
+            d_position( area.size(), -1 )
+        {
+        }
+
+        void build( int from, int to )
+        {
+            d_heap.reserve( to - from + 1 );
+            for ( int i = from; i <= to; i++ )
+            {
+                d_position[i] = d_heap.size();
+                d_heap += i;
+            }
+
+            for ( int i = d_heap.size() / 2 - 1; i >= 0; i-- )
+                siftDown( i );
+        }
+
+        inline bool isEmpty() const
+        {
+            return d_heap.isEmpty();
+        }
+
+        inline int top() const
+        {
+            return d_heap[0];
+        }
+
+        void pop()
+        {
+            remove( d_heap[0] );
+        }
+
+        void remove( int index )
+        {
+            const int pos = d_position[index];
+            const int last = d_heap.size() - 1;
+
+            swap( pos, last );
+            d_heap.resize( last );
+            d_position[index] = -1;
+
+            if ( pos < last )
+            {
+                siftUp( pos );
+                siftDown( pos );
+            }
+        }
+
+        void update( int index )
+        {
+            const int pos = d_position[index];
+            if ( pos >= 0 )
+            {
+                siftUp( pos );
+                siftDown( d_position[index] );
+            }
+        }
+
+    private:
+        inline bool isLess( int pos1, int pos2 ) const
+        {
+            return d_area[ d_heap[pos1] ] < d_area[ d_heap[pos2] ];
+        }
+
+        inline void swap( int pos1, int pos2 )
+        {
+            qSwap( d_heap[pos1], d_heap[pos2] );
+            d_position[ d_heap[pos1] ] = pos1;
+            d_position[ d_heap[pos2] ] = pos2;
+        }
+
+        void siftUp( int pos )
+        {
+            while ( pos > 0 )
+            {
+                const int parent = ( pos - 1 ) / 2;
+                if ( !isLess( pos, parent ) )
+                    break;
+
+                swap( pos, parent );
+                pos = parent;
+            }
+        }
+
+        void siftDown( int pos )
+        {
+            const int size = d_heap.size();
+
+            while ( true )
+            {
+                int child = 2 * pos + 1;
+                if ( child >= size )
+                    break;
+
+                if ( child + 1 < size && isLess( child + 1, child ) )
+                    child++;
+
+                if ( !isLess( child, pos ) )
+                    break;
+
+                swap( pos, child );
+                pos = child;
+            }
+        }
+
+        const QVector<double> &d_area;
+        QVector<int> d_heap;
+        QVector<int> d_position;
+    };
+}
+
 class QwtWeedingCurveFitter::Line
 {
 public:
@@ -61,6 +198,27 @@ QwtWeedingCurveFitter::~QwtWeedingCurveFitter()
     delete d_data;
 }
 
+/*!
+  Set the algorithm, that is used for simplifying the polygon.
+  The default setting is DouglasPeucker.
+
+  \param algorithm Simplification algorithm
+  \sa algorithm(), setTolerance()
+ */
+void QwtWeedingCurveFitter::setAlgorithm( Algorithm algorithm )
+{
+    d_data->algorithm = algorithm;
+}
+
+/*!
+  \return Algorithm, that is used for simplifying the polygon
+  \sa setAlgorithm()
+ */
+QwtWeedingCurveFitter::Algorithm QwtWeedingCurveFitter::algorithm() const
+{
+    return d_data->algorithm;
+}
+
 /*!
  Assign the tolerance
 
@@ -118,6 +276,33 @@ uint QwtWeedingCurveFitter::chunkSize() const
     return d_data->chunkSize;
 }
 
+/*!
+  Set the number of threads, that are used for simplifying
+  the chunks of a polygon in parallel.
+
+  The default setting is 1.
+
+  \param numThreads Number of threads to be used. If numThreads is 
+                    set to 0, the system specific ideal thread count is used.
+
+  \note Has no effect, when chunkSize() is 0
+  \sa threadCount(), setChunkSize()
+ */
+void QwtWeedingCurveFitter::setThreadCount( uint numThreads )
+{
+    d_data->numThreads = numThreads;
+}
+
+/*!
+  \return Number of threads, that are used for simplifying 
+          the chunks of a polygon.
+  \sa setThreadCount()
+ */
+uint QwtWeedingCurveFitter::threadCount() const
+{
+    return d_data->numThreads;
+}
+
 /*!
   \param points Series of data points
   \return Curve points
@@ -127,15 +312,40 @@ QPolygonF QwtWeedingCurveFitter::fitCurve( const QPolygonF &points ) const
 {
     QPolygonF fittedPoints;
 
-    if ( d_data->chunkSize == 0 )
+    const int chunkSize = d_data->chunkSize;
+
+    if ( chunkSize == 0 || points.size() <= chunkSize )
     {
         fittedPoints = simplify( points );
     }
     else
     {
-        for ( int i = 0; i < points.size(); i += d_data->chunkSize )
+#if !defined(QT_NO_QFUTURE)
+        uint numThreads = d_data->numThreads;
+
+        if ( numThreads == 0 )
+            numThreads = QThread::idealThreadCount();
+
+        if ( numThreads > 1 )
+        {
+            QList< QFuture<QPolygonF> > futures;
+            for ( int i = 0; i < points.size(); i += chunkSize )
+            {
+                futures += QtConcurrent::run( this,
+                    &QwtWeedingCurveFitter::simplify, 
+                    points.mid( i, chunkSize ) );
+            }
+
+            for ( int i = 0; i < futures.size(); i++ )
+                fittedPoints += futures[i].result();
+
+            return fittedPoints;
+        }
+#endif
+
+        for ( int i = 0; i < points.size(); i += chunkSize )
         {
-            const QPolygonF p = points.mid( i, d_data->chunkSize );
+            const QPolygonF p = points.mid( i, chunkSize );
             fittedPoints += simplify( p );
         }
     }
@@ -156,6 +366,25 @@ QPainterPath QwtWeedingCurveFitter::fitCurvePath( const QPolygonF &points ) cons
 }
 
 QPolygonF QwtWeedingCurveFitter::simplify( const QPolygonF &points ) const
+{
+    if ( points.size() < 3 )
+        return points;
+
+    switch( d_data->algorithm )
+    {
+        case VisvalingamWhyatt:
+            return simplifyVisvalingamWhyatt( points );
+
+        case ReumannWitkam:
+            return simplifyReumannWitkam( points );
+
+        default:
+            return simplifyDouglasPeucker( points );
+    }
+}
+
+QPolygonF QwtWeedingCurveFitter::simplifyDouglasPeucker( 
+    const QPolygonF &points ) const
 {
     const double toleranceSqr = d_data->tolerance * d_data->tolerance;
 
@@ -239,3 +468,129 @@ QPolygonF QwtWeedingCurveFitter::simplify( const QPolygonF &points ) const
 
     return stripped;
 }
+
+QPolygonF QwtWeedingCurveFitter::simplifyVisvalingamWhyatt(
+    const QPolygonF &points ) const
+{
+    const double minArea = d_data->tolerance * d_data->tolerance;
+
+    const QPointF *p = points.constData();
+    const int nPoints = points.size();
+
+    // the points are organized as a double linked list
+
+    QVector<int> prev( nPoints );
+    QVector<int> next( nPoints );
+    QVector<double> area( nPoints, 0.0 );
+
+    for ( int i = 0; i < nPoints; i++ )
+    {
+        prev[i] = i - 1;
+        next[i] = i + 1;
+    }
+
+    for ( int i = 1; i < nPoints - 1; i++ )
+        area[i] = qwtTriangleArea( p[i - 1], p[i], p[i + 1] );
+
+    AreaHeap heap( area );
+    heap.build( 1, nPoints - 2 );
+
+    QVector<bool> usePoint( nPoints, true );
+
+    while ( !heap.isEmpty() )
+    {
+        const int index = heap.top();
+
+        const double removedArea = area[index];
+        if ( removedArea >= minArea )
+            break;
+
+        heap.pop();
+        usePoint[index] = false;
+
+        const int i1 = prev[index];
+        const int i2 = next[index];
+
+        next[i1] = i2;
+        prev[i2] = i1;
+
+        /*
+           The area of a neighbour must not become smaller
+           than the area of a point, that has already been removed.
+           Otherwise the neighbour would be removed as a 
+           side effect of removing a less significant point.
+         */
+
+        if ( prev[i1] >= 0 )
+        {
+            area[i1] = qMax( removedArea,
+                qwtTriangleArea( p[ prev[i1] ], p[i1], p[i2] ) );
+            heap.update( i1 );
+        }
+
+        if ( next[i2] < nPoints )
+        {
+            area[i2] = qMax( removedArea,
+                qwtTriangleArea( p[i1], p[i2], p[ next[i2] ] ) );
+            heap.update( i2 );
+        }
+    }
+
+    QPolygonF stripped;
+    for ( int i = 0; i < nPoints; i++ )
+    {
+        if ( usePoint[i] )
+            stripped += p[i];
+    }
+
+    return stripped;
+}
+
+QPolygonF QwtWeedingCurveFitter::simplifyReumannWitkam(
+    const QPolygonF &points ) const
+{
+    const double toleranceSqr = d_data->tolerance * d_data->tolerance;
+
+    const QPointF *p = points.constData();
+    const int nPoints = points.size();
+
+    QPolygonF stripped;
+    stripped += p[0];
+
+    int key = 0;
+    while ( key < nPoints - 1 )
+    {
+        // the line through the key point and its successor
+
+        const double vecX = p[key + 1].x() - p[key].x();
+        const double vecY = p[key + 1].y() - p[key].y();
+        const double vecLengthSqr = vecX * vecX + vecY * vecY;
+
+        int i = key + 2;
+        for ( ; i < nPoints; i++ )
+        {
+            const double dx = p[i].x() - p[key].x();
+            const double dy = p[i].y() - p[key].y();
+
+            double distSqr;
+            if ( vecLengthSqr > 0.0 )
+            {
+                const double cross = dx * vecY - dy * vecX;
+                distSqr = cross * cross / vecLengthSqr;
+            }
+            else
+            {
+                distSqr = dx * dx + dy * dy;
+            }
+
+            if ( distSqr > toleranceSqr )
+                break;
+        }
+
+        // the last point inside of the corridor becomes the next key
+        key = i - 1;
+        stripped += p[key];
+    }
+
+    return stripped;
+}
@@ -34,25 +34,68 @@
   the number of points. By adjusting the tolerance parameter according to the
   axis scales QwtSplineCurveFitter can be used to implement different
   level of details to speed up painting of curves of many points.
+
+  For huge polygons one of the alternative algorithms ( setAlgorithm() )
+  might be a better choice. Chunks ( setChunkSize() ) can be simplified
+  in parallel threads ( setThreadCount() ).
 */
 class QWT_EXPORT QwtWeedingCurveFitter: public QwtCurveFitter
 {
 public:
+    /*!
+      \brief Simplification algorithm
+
+      \sa setAlgorithm()
+     */
+    enum Algorithm
+    {
+        /*!
+          Douglas and Peucker algorithm: the points with the maximum
+          distance from the line between the end points are inserted 
+          recursively. Worst case O( n * n ).
+         */
+        DouglasPeucker,
+
+        /*!
+          Visvalingam and Whyatt algorithm: the point with the smallest 
+          area of the triangle with its neighbours is removed, as long as
+          this area is below tolerance() * tolerance(). O( n * log( n ) ).
+         */
+        VisvalingamWhyatt,
+
+        /*!
+          Reumann and Witkam algorithm: in one pass all points are removed,
+          that are closer than tolerance() to the line through the last 
+          kept point and its successor. O( n ).
+         */
+        ReumannWitkam
+    };
+
     explicit QwtWeedingCurveFitter( double tolerance = 1.0 );
     virtual ~QwtWeedingCurveFitter();
 
+    void setAlgorithm( Algorithm );
+    Algorithm algorithm() const;
+
     void setTolerance( double );
     double tolerance() const;
 
     void setChunkSize( uint );
     uint chunkSize() const;
 
+    void setThreadCount( uint numThreads );
+    uint threadCount() const;
+
     virtual QPolygonF fitCurve( const QPolygonF & ) const;
     virtual QPainterPath fitCurvePath( const QPolygonF & ) const;
 
 private:
     virtual QPolygonF simplify( const QPolygonF & ) const;
 
+    QPolygonF simplifyDouglasPeucker( const QPolygonF & ) const;
+    QPolygonF simplifyVisvalingamWhyatt( const QPolygonF & ) const;
+    QPolygonF simplifyReumannWitkam( const QPolygonF & ) const;
+
     class Line;
 
     class PrivateData;
@@ -40,11 +40,13 @@ HEADERS += \
     qwt_scale_draw.h \
     qwt_scale_engine.h \
     qwt_scale_map.h \
+    qwt_scratch_arena.h \
     qwt_spline.h \
     qwt_spline_basis.h \
     qwt_spline_parametrization.h \
     qwt_spline_local.h \
     qwt_spline_cubic.h \
+    qwt_spline_incremental.h \
     qwt_spline_pleasing.h \
     qwt_spline_polynomial.h \
     qwt_symbol.h \
@@ -85,11 +87,13 @@ SOURCES += \
     qwt_scale_draw.cpp \
     qwt_scale_map.cpp \
     qwt_scale_engine.cpp \
+    qwt_scratch_arena.cpp \
     qwt_spline.cpp \
     qwt_spline_basis.cpp \
     qwt_spline_parametrization.cpp \
     qwt_spline_local.cpp \
     qwt_spline_cubic.cpp \
+    qwt_spline_incremental.cpp \
     qwt_spline_pleasing.cpp \
     qwt_symbol.cpp \
     qwt_system_clock.cpp \
@@ -113,6 +117,7 @@ contains(QWT_CONFIG, QwtPlot) {
         qwt_legend_label.h \
         qwt_plot.h \
         qwt_plot_renderer.h \
+        qwt_plot_batch_renderer.h \
         qwt_plot_curve.h \
         qwt_plot_dict.h \
         qwt_plot_directpainter.h \
@@ -162,6 +167,7 @@ contains(QWT_CONFIG, QwtPlot) {
         qwt_legend_label.cpp \
         qwt_plot.cpp \
         qwt_plot_renderer.cpp \
+        qwt_plot_batch_renderer.cpp \
         qwt_plot_xml.cpp \
         qwt_plot_axis.cpp \
         qwt_plot_curve.cpp \
@@ -0,0 +1,166 @@
+#include <qwt_date_scale_draw.h>
+#include <qwt_date_scale_engine.h>
+#include <QElapsedTimer>
+#include <QDebug>
+
+class DateScaleDraw: public QwtDateScaleDraw
+{
+public:
+	DateScaleDraw( Qt::TimeSpec timeSpec ):
+		QwtDateScaleDraw( timeSpec )
+	{
+	}
+
+	// the implementation of QwtDateScaleDraw::label() before
+	// the formats have been precompiled
+	QString qtLabel( double value ) const
+	{
+		const QDateTime dt = toDateTime( value );
+		const QString fmt = dateFormatOfDate( 
+			dt, intervalType( scaleDiv() ) );
+
+		return QwtDate::toString( dt, fmt, week0Type() );
+	}
+};
+
+int testLabels( const char *name, Qt::TimeSpec timeSpec, 
+	double from, double to )
+{
+	const int numRuns = 2000;
+
+	QwtDateScaleEngine engine( timeSpec );
+	engine.setUtcOffset( 3600 );
+
+	DateScaleDraw scaleDraw( timeSpec );
+	scaleDraw.setUtcOffset( 3600 );
+	scaleDraw.setScaleDiv( engine.divideScale( from, to, 10, 0 ) );
+
+	const QList<double> ticks = 
+		scaleDraw.scaleDiv().ticks( QwtScaleDiv::MajorTick );
+
+	int numErrors = 0;
+	for ( int i = 0; i < ticks.size(); i++ )
+	{
+		const QString s1 = scaleDraw.qtLabel( ticks[i] );
+		const QString s2 = scaleDraw.label( ticks[i] ).text();
+
+		if ( s1 != s2 )
+		{
+			qDebug() << "Mismatch:" << s1 << s2;
+			numErrors++;
+		}
+	}
+
+	QElapsedTimer timer;
+
+	timer.start();
+	for ( int run = 0; run < numRuns; run++ )
+	{
+		for ( int i = 0; i < ticks.size(); i++ )
+			( void )scaleDraw.qtLabel( ticks[i] );
+	}
+	const qint64 qtElapsed = timer.elapsed();
+
+	timer.start();
+	for ( int run = 0; run < numRuns; run++ )
+	{
+		for ( int i = 0; i < ticks.size(); i++ )
+			( void )scaleDraw.label( ticks[i] );
+	}
+	const qint64 qwtElapsed = timer.elapsed();
+
+	qDebug() << name << "Labels:" << numRuns * ticks.size()
+		<< "QDateTime::toString:" << qtElapsed
+		<< "Precompiled:" << qwtElapsed
+		<< "Errors:" << numErrors;
+
+	return numErrors;
+}
+
+static double toDouble( int year, int month, int day, 
+	int hour = 0, int minute = 0, int second = 0 )
+{
+	return QwtDate::toDouble( QDateTime( QDate( year, month, day ), 
+		QTime( hour, minute, second ), Qt::UTC ) );
+}
+
+int testTimeSpec( Qt::TimeSpec timeSpec )
+{
+	const double from = toDouble( 2014, 3, 27, 10, 20, 30 );
+
+	const double msecsPerHour = 3600.0 * 1000.0;
+	const double msecsPerDay = 24.0 * msecsPerHour;
+
+	int numErrors = 0;
+
+	numErrors += testLabels( "Milliseconds", timeSpec, from, from + 1000.0 );
+	numErrors += testLabels( "Seconds", timeSpec, from, from + 60 * 1000.0 );
+	numErrors += testLabels( "Minutes", timeSpec, from, from + msecsPerHour );
+	numErrors += testLabels( "Hours", timeSpec, from, from + msecsPerDay );
+	numErrors += testLabels( "Days", timeSpec, from, from + 10 * msecsPerDay );
+	numErrors += testLabels( "Weeks", timeSpec, from, from + 70 * msecsPerDay );
+	numErrors += testLabels( "Months", timeSpec, from, from + 365 * msecsPerDay );
+	numErrors += testLabels( "Years", timeSpec, from, from + 20 * 365 * msecsPerDay );
+
+	// before the epoch: negative values
+
+	const double epoch = toDouble( 1970, 1, 1 );
+	numErrors += testLabels( "Epoch Seconds", timeSpec, 
+		epoch - 30 * 1000.0, epoch + 30 * 1000.0 );
+	numErrors += testLabels( "Epoch Days", timeSpec, 
+		epoch - 5 * msecsPerDay, epoch + 5 * msecsPerDay );
+
+	const double past = toDouble( 1903, 6, 14, 8, 15 );
+	numErrors += testLabels( "1903 Hours", timeSpec, past, past + msecsPerDay );
+	numErrors += testLabels( "1903 Months", timeSpec, 
+		past, past + 365 * msecsPerDay );
+
+	// julian/gregorian calendar switch and years with less than 4 digits
+
+	const double gregorian = toDouble( 1582, 10, 10 );
+	numErrors += testLabels( "1582 Days", timeSpec, 
+		gregorian, gregorian + 10 * msecsPerDay );
+
+	const double ancient = toDouble( 900, 1, 1 );
+	numErrors += testLabels( "900 Years", timeSpec, 
+		ancient, ancient + 200 * 365 * msecsPerDay );
+
+	// leap days
+
+	numErrors += testLabels( "Leap Day 2000", timeSpec, 
+		toDouble( 2000, 2, 27 ), toDouble( 2000, 3, 2 ) );
+	numErrors += testLabels( "Leap Day 2016", timeSpec, 
+		toDouble( 2016, 2, 28, 12 ), toDouble( 2016, 3, 1, 12 ) );
+	numErrors += testLabels( "No Leap Day 1900", timeSpec, 
+		toDouble( 1900, 2, 27 ), toDouble( 1900, 3, 2 ) );
+
+	// year boundaries
+
+	numErrors += testLabels( "Year 1999/2000", timeSpec, 
+		toDouble( 1999, 12, 31, 22 ), toDouble( 2000, 1, 1, 2 ) );
+	numErrors += testLabels( "Year 1969/1970 Weeks", timeSpec, 
+		toDouble( 1969, 11, 20 ), toDouble( 1970, 2, 10 ) );
+	numErrors += testLabels( "Year 2020/2021 Minutes", timeSpec, 
+		toDouble( 2020, 12, 31, 23, 58 ), toDouble( 2021, 1, 1, 0, 2 ) );
+
+	return numErrors;
+}
+
+int main()
+{
+	int numErrors = 0;
+
+	qDebug() << "=== UTC";
+	numErrors += testTimeSpec( Qt::UTC );
+
+	qDebug() << "=== OffsetFromUTC";
+	numErrors += testTimeSpec( Qt::OffsetFromUTC );
+
+	qDebug() << "=== LocalTime";
+	numErrors += testTimeSpec( Qt::LocalTime );
+
+	if ( numErrors > 0 )
+		qDebug() << numErrors << "errors";
+
+	return numErrors > 0 ? 1 : 0;
+}
@@ -0,0 +1,350 @@
+#include <qwt_graphic.h>
+#include <qwt_painter_command.h>
+#include <qapplication.h>
+#include <qpainter.h>
+#include <qpainterpath.h>
+#include <qpixmap.h>
+#include <qimage.h>
+#include <qbrush.h>
+#include <qbuffer.h>
+#include <qdatastream.h>
+#include <qdebug.h>
+
+static QImage testImage()
+{
+    QImage image( 16, 12, QImage::Format_ARGB32 );
+    for ( int y = 0; y < image.height(); y++ )
+    {
+        for ( int x = 0; x < image.width(); x++ )
+            image.setPixel( x, y, qRgba( 16 * x, 20 * y, 128, 255 - 10 * x ) );
+    }
+
+    return image;
+}
+
+static QwtGraphic testGraphic()
+{
+    QwtGraphic graphic;
+    graphic.setDefaultSize( QSizeF( 120, 80 ) );
+    graphic.setRenderHint( QwtGraphic::RenderPensUnscaled, true );
+
+    QPainter painter( &graphic );
+    painter.setRenderHint( QPainter::Antialiasing, true );
+
+    // paths: lines, curves and both fill rules
+
+    painter.setPen( QPen( Qt::darkBlue, 2 ) );
+    painter.setBrush( Qt::yellow );
+
+    QPainterPath path;
+    path.moveTo( 5, 5 );
+    path.lineTo( 50, 10 );
+    path.cubicTo( 60, 20, 40, 40, 10, 30 );
+    path.closeSubpath();
+    painter.drawPath( path );
+
+    QPainterPath star;
+    star.setFillRule( Qt::WindingFill );
+    star.moveTo( 80, 5 );
+    star.lineTo( 95, 45 );
+    star.lineTo( 65, 20 );
+    star.lineTo( 100, 20 );
+    star.lineTo( 70, 45 );
+    star.closeSubpath();
+    painter.drawPath( star );
+
+    painter.drawEllipse( QRectF( 10, 45, 30, 20 ) );
+
+    // state changes, including some without any effect
+
+    painter.save();
+    painter.setPen( QPen( Qt::red, 0 ) );
+    painter.setPen( QPen( Qt::red, 0 ) );
+    painter.setBrush( QBrush( Qt::green, Qt::Dense4Pattern ) );
+    painter.setOpacity( 0.5 );
+    painter.translate( 50, 40 );
+    painter.rotate( 15 );
+    painter.setClipRect( QRectF( -5, -5, 40, 30 ) );
+    painter.drawRect( QRectF( 0, 0, 30, 20 ) );
+    painter.restore();
+
+    painter.setCompositionMode( QPainter::CompositionMode_Multiply );
+    painter.drawLine( QLineF( 0, 79, 119, 0 ) );
+    painter.setCompositionMode( QPainter::CompositionMode_SourceOver );
+
+    // pixmaps and images
+
+    QPixmap pixmap( 10, 10 );
+    pixmap.fill( Qt::magenta );
+    painter.drawPixmap( QRectF( 100, 60, 10, 10 ), pixmap, QRectF( 0, 0, 10, 10 ) );
+
+    painter.drawImage( QRectF( 85, 55, 16, 12 ), testImage() );
+
+    painter.end();
+
+    return graphic;
+}
+
+static int numCommands( const QwtGraphic &graphic, QwtPainterCommand::Type type )
+{
+    int count = 0;
+
+    const QVector<QwtPainterCommand> &commands = graphic.commands();
+    for ( int i = 0; i < commands.size(); i++ )
+    {
+        if ( commands[i].type() == type )
+            count++;
+    }
+
+    return count;
+}
+
+static QByteArray toByteArray( const QwtGraphic &graphic )
+{
+    QByteArray data;
+
+    QDataStream stream( &data, QIODevice::WriteOnly );
+    stream << graphic;
+
+    return data;
+}
+
+static bool fromByteArray( const QByteArray &data, QwtGraphic &graphic )
+{
+    QDataStream stream( data );
+    return graphic.load( stream ) && stream.status() == QDataStream::Ok;
+}
+
+static int testRoundTrip()
+{
+    int numErrors = 0;
+
+    const QwtGraphic graphic = testGraphic();
+    const QByteArray data = toByteArray( graphic );
+
+    QwtGraphic loaded;
+    if ( !fromByteArray( data, loaded ) )
+    {
+        qDebug() << "Round trip: loading failed";
+        return 1;
+    }
+
+    if ( loaded.defaultSize() != graphic.defaultSize()
+        || loaded.boundingRect() != graphic.boundingRect()
+        || loaded.controlPointRect() != graphic.controlPointRect()
+        || loaded.testRenderHint( QwtGraphic::RenderPensUnscaled ) !=
+            graphic.testRenderHint( QwtGraphic::RenderPensUnscaled ) )
+    {
+        qDebug() << "Round trip: different geometry";
+        numErrors++;
+    }
+
+    const QwtPainterCommand::Type types[] =
+    {
+        QwtPainterCommand::Path,
+        QwtPainterCommand::Pixmap,
+        QwtPainterCommand::Image
+    };
+
+    for ( uint i = 0; i < sizeof( types ) / sizeof( types[0] ); i++ )
+    {
+        const int n1 = numCommands( graphic, types[i] );
+        const int n2 = numCommands( loaded, types[i] );
+
+        if ( n1 == 0 || n1 != n2 )
+        {
+            qDebug() << "Round trip: commands of type" << types[i]
+                << ":" << n1 << "->" << n2;
+            numErrors++;
+        }
+    }
+
+    const int numStates = numCommands( loaded, QwtPainterCommand::State );
+    if ( numStates == 0
+        || numStates > numCommands( graphic, QwtPainterCommand::State ) )
+    {
+        qDebug() << "Round trip: wrong number of state commands:" << numStates;
+        numErrors++;
+    }
+
+    if ( loaded.toImage() != graphic.toImage() )
+    {
+        qDebug() << "Round trip: different rendering";
+        numErrors++;
+    }
+
+    // the state changes are reduced already, so saving again
+    // has to result in the same data
+
+    if ( toByteArray( loaded ) != data )
+    {
+        qDebug() << "Round trip: saving the loaded graphic differs";
+        numErrors++;
+    }
+
+    return numErrors;
+}
+
+/*
+  Paths, that don't overlap, with opaque pens and brushes - candidates
+  for being joined by QwtGraphic::optimize()
+ */
+static QwtGraphic gridGraphic( const QPen &pen, const QBrush &brush,
+    bool unscaledPens )
+{
+    QwtGraphic graphic;
+    graphic.setRenderHint( QwtGraphic::RenderPensUnscaled, unscaledPens );
+
+    QPainter painter( &graphic );
+    painter.setRenderHint( QPainter::Antialiasing, true );
+    painter.setPen( pen );
+    painter.setBrush( brush );
+
+    for ( int row = 0; row < 4; row++ )
+    {
+        for ( int col = 0; col < 6; col++ )
+        {
+            const QRectF rect( 10 + 30 * col, 10 + 30 * row, 14, 14 );
+
+            if ( ( row + col ) % 2 )
+                painter.drawEllipse( rect );
+            else
+                painter.drawRect( rect );
+        }
+    }
+
+    painter.end();
+
+    return graphic;
+}
+
+static int testOptimize()
+{
+    int numErrors = 0;
+
+    QLinearGradient gradient( 0.0, 0.0, 1.0, 1.0 );
+    gradient.setCoordinateMode( QGradient::ObjectBoundingMode );
+    gradient.setColorAt( 0.0, Qt::blue );
+    gradient.setColorAt( 1.0, Qt::yellow );
+
+    QPen cosmeticPen( Qt::black, 2.0 );
+    cosmeticPen.setCosmetic( true );
+
+    const struct
+    {
+        const char *name;
+        QPen pen;
+        QBrush brush;
+        bool unscaledPens;
+    } graphics[] =
+    {
+        { "Scaled pen", QPen( Qt::black, 3.0 ), QBrush( Qt::red ), false },
+        { "No pen", QPen( Qt::NoPen ), QBrush( Qt::red ), false },
+        { "Cosmetic pen", cosmeticPen, QBrush( Qt::red ), false },
+        { "Unscaled pen", QPen( Qt::black, 3.0 ), QBrush( Qt::red ), true },
+        { "Gradient", QPen( Qt::black, 1.0 ), QBrush( gradient ), false }
+    };
+
+    // sizes of the target: recorded size, scaled down and up
+    const QSize sizes[] = { QSize(), QSize( 48, 33 ), QSize( 380, 260 ) };
+
+    for ( uint i = 0; i < sizeof( graphics ) / sizeof( graphics[0] ); i++ )
+    {
+        const QwtGraphic graphic = gridGraphic( graphics[i].pen,
+            graphics[i].brush, graphics[i].unscaledPens );
+
+        QwtGraphic optimized = graphic;
+        optimized.optimize();
+
+        for ( uint j = 0; j < sizeof( sizes ) / sizeof( sizes[0] ); j++ )
+        {
+            const QSize &size = sizes[j];
+
+            const QImage image1 = size.isValid() 
+                ? graphic.toImage( size ) : graphic.toImage();
+            const QImage image2 = size.isValid() 
+                ? optimized.toImage( size ) : optimized.toImage();
+
+            if ( image1 != image2 )
+            {
+                qDebug() << "Optimize:" << graphics[i].name 
+                    << "different rendering for" << size;
+                numErrors++;
+            }
+        }
+    }
+
+    return numErrors;
+}
+
+static int testCorruptData()
+{
+    int numErrors = 0;
+
+    const QByteArray data = toByteArray( testGraphic() );
+
+    // truncated data
+
+    for ( int size = 0; size < data.size(); size++ )
+    {
+        QwtGraphic graphic;
+        if ( fromByteArray( data.left( size ), graphic ) || !graphic.isNull() )
+        {
+            qDebug() << "Truncated data: accepted" << size << "of"
+                << data.size() << "bytes";
+            numErrors++;
+        }
+    }
+
+    // huge counts, that can't be in the stream
+
+    {
+        QSizeF size;
+        qint32 hints;
+        QRectF rect1, rect2;
+        quint32 magic;
+        quint16 version;
+
+        QBuffer buffer;
+        buffer.setData( data );
+        buffer.open( QIODevice::ReadOnly );
+
+        QDataStream stream( &buffer );
+        stream >> magic >> version >> size >> hints >> rect1 >> rect2;
+
+        const int countPos = static_cast<int>( buffer.pos() );
+
+        const quint32 counts[] = { 0x7fffffff, 0x80000000, 0xfffffff0 };
+        for ( uint i = 0; i < sizeof( counts ) / sizeof( counts[0] ); i++ )
+        {
+            QByteArray corrupt = data;
+
+            QByteArray count;
+            QDataStream countStream( &count, QIODevice::WriteOnly );
+            countStream << counts[i];
+
+            corrupt.replace( countPos, count.size(), count );
+
+            QwtGraphic graphic;
+            if ( fromByteArray( corrupt, graphic ) || !graphic.isNull() )
+            {
+                qDebug() << "Huge count: accepted" << counts[i];
+                numErrors++;
+            }
+        }
+    }
+
+    return numErrors;
+}
+
+int main( int argc, char **argv )
+{
+    QApplication app( argc, argv );
+
+    const int numErrors = testRoundTrip() 
+        + testOptimize() + testCorruptData();
+    if ( numErrors > 0 )
+        qDebug() << numErrors << "errors";
+
+    return numErrors > 0 ? 1 : 0;
+}
@@ -9,10 +9,34 @@ void testSpline( const char *name, QwtSplineInterpolating *spline,
 {
 	spline->setParametrization( type );
 
-	QElapsedTimer timer;
-	timer.start();
-	const QVector<QLineF> lines = spline->bezierControlLines( points );
-	qDebug() << name << ":" << timer.elapsed();
+	// sequential implementation first, then the parallel one
+	const uint threadCounts[] = { 1, 0 };
+
+	for ( int i = 0; i < 2; i++ )
+	{
+		spline->setThreadCount( threadCounts[i] );
+
+		QElapsedTimer timer;
+		timer.start();
+		const QVector<QLineF> lines = spline->bezierControlLines( points );
+		qDebug() << name << "Threads:" << threadCounts[i] 
+			<< "Lines:" << timer.elapsed();
+
+		QwtSplineC1 *splineC1 = dynamic_cast<QwtSplineC1 *>( spline );
+		if ( splineC1 && type == QwtSplineParametrization::ParameterX )
+		{
+			timer.start();
+			const QVector<double> slopes = splineC1->slopes( points );
+			qDebug() << name << "Threads:" << threadCounts[i] 
+				<< "Slopes:" << timer.elapsed();
+
+			timer.start();
+			const QVector<QwtSplinePolynomial> polynomials = 
+				splineC1->polynomials( points );
+			qDebug() << name << "Threads:" << threadCounts[i] 
+				<< "Polynomials:" << timer.elapsed();
+		}
+	}
 }
 
 void testSplines( int paramType, const QPolygonF &points )
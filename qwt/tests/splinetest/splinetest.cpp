@@ -1,7 +1,9 @@
 #include <qwt_spline_cubic.h>
 #include <qwt_spline_local.h>
+#include <qwt_spline_incremental.h>
 #include <qwt_spline_parametrization.h>
 #include <qpolygon.h>
+#include <qmath.h>
 #include <qdebug.h>
 
 #define DEBUG_ERRORS 1
@@ -578,8 +580,172 @@ void testDuplicates()
     testPaths( "Last point twice", spline, points, points4 );
 }
 
+void testIncremental( const char *prompt, QwtSplineC1 *spline )
+{
+    spline->setParametrization( QwtSplineParametrization::ParameterX );
+
+    QPolygonF points;
+    for ( int i = 0; i < 500; i++ )
+        points += QPointF( i + 0.3 * ::sin( 0.7 * i ), 10.0 * ::sin( 0.1 * i ) );
+
+    QwtSplineIncremental incremental( spline );
+    incremental.setPoints( points.mid( 0, 200 ) );
+
+    for ( int i = 200; i < points.size(); i += 7 )
+        incremental.append( points.mid( i, 7 ) );
+
+    const QVector<double> m = spline->slopes( points );
+    const QVector<double> &mi = incremental.slopes();
+
+    bool ok = ( m.size() == mi.size() )
+        && ( incremental.polynomials().size() == points.size() - 1 );
+
+    for ( int i = 0; ok && i < m.size(); i++ )
+    {
+        if ( qAbs( m[i] - mi[i] ) > 1e-10 * qMax( 1.0, qAbs( m[i] ) ) )
+        {
+#if DEBUG_ERRORS > 0
+            qDebug() << "Slope at" << i << ":" << m[i] << mi[i];
+#endif
+            ok = false;
+        }
+    }
+
+    if ( !ok )
+        qDebug() << "Incremental Spline:" << prompt << "=> failed.";
+}
+
+void testIncremental()
+{
+    testIncremental( "Cardinal", new QwtSplineLocal( QwtSplineLocal::Cardinal ) );
+    testIncremental( "PChip", new QwtSplineLocal( QwtSplineLocal::PChip ) );
+    testIncremental( "Akima", new QwtSplineLocal( QwtSplineLocal::Akima ) );
+    testIncremental( "Cubic", new QwtSplineCubic() );
+}
+
+static inline bool fuzzyValue( double v1, double v2 )
+{
+    return qAbs( v1 - v2 ) <= 1e-9 * qMax( 1.0, qAbs( v1 ) );
+}
+
+static inline bool fuzzyValue( const QLineF &l1, const QLineF &l2 )
+{
+    return fuzzyValue( l1.x1(), l2.x1() ) && fuzzyValue( l1.y1(), l2.y1() )
+        && fuzzyValue( l1.x2(), l2.x2() ) && fuzzyValue( l1.y2(), l2.y2() );
+}
+
+static inline bool fuzzyValue( const QwtSplinePolynomial &p1, 
+    const QwtSplinePolynomial &p2 )
+{
+    return fuzzyValue( p1.c1, p2.c1 ) && fuzzyValue( p1.c2, p2.c2 )
+        && fuzzyValue( p1.c3, p2.c3 );
+}
+
+template< class T >
+static int compareValues( const QVector<T> &v1, const QVector<T> &v2 )
+{
+    if ( v1.size() != v2.size() )
+        return qMax( v1.size(), v2.size() );
+
+    int numErrors = 0;
+    for ( int i = 0; i < v1.size(); i++ )
+    {
+        if ( !fuzzyValue( v1[i], v2[i] ) )
+            numErrors++;
+    }
+
+    return numErrors;
+}
+
+void testParallel( const char *prompt, QwtSplineC1 *spline, 
+    const QPolygonF &points )
+{
+    spline->setParametrization( QwtSplineParametrization::ParameterX );
+    spline->setThreadCount( 1 );
+
+    const QVector<double> m1 = spline->slopes( points );
+    const QVector<QwtSplinePolynomial> p1 = spline->polynomials( points );
+    const QVector<QLineF> l1 = spline->bezierControlLines( points );
+
+    spline->setThreadCount( 4 );
+
+    const QVector<double> m2 = spline->slopes( points );
+    const QVector<QwtSplinePolynomial> p2 = spline->polynomials( points );
+    const QVector<QLineF> l2 = spline->bezierControlLines( points );
+
+    int numErrors = compareValues( m1, m2 ) 
+        + compareValues( p1, p2 ) + compareValues( l1, l2 );
+
+    const QwtSplineC2 *splineC2 = dynamic_cast<const QwtSplineC2 *>( spline );
+    if ( splineC2 )
+    {
+        spline->setThreadCount( 1 );
+        const QVector<double> cv1 = splineC2->curvatures( points );
+
+        spline->setThreadCount( 4 );
+        const QVector<double> cv2 = splineC2->curvatures( points );
+
+        numErrors += compareValues( cv1, cv2 );
+    }
+
+    if ( numErrors > 0 )
+    {
+        qDebug() << "Parallel Spline:" << prompt << "=> failed.";
+#if DEBUG_ERRORS > 0
+        qDebug() << "  values different from the sequential calculation:" 
+            << numErrors;
+#endif
+    }
+
+    delete spline;
+}
+
+void testParallel()
+{
+    // enough points for 4 threads
+
+    QPolygonF points;
+    for ( int i = 0; i < 400000; i++ )
+    {
+        const double x = i + 0.4 * ::sin( 0.3 * i );
+        points += QPointF( x, 100.0 * ::sin( 0.001 * i ) + ( qrand() % 10 ) );
+    }
+
+    testParallel( "Cardinal", new QwtSplineLocal( QwtSplineLocal::Cardinal ), points );
+    testParallel( "PChip", new QwtSplineLocal( QwtSplineLocal::PChip ), points );
+    testParallel( "Akima", new QwtSplineLocal( QwtSplineLocal::Akima ), points );
+
+    struct Condition
+    {
+        const char *name;
+        int condition;
+        double valueBegin;
+        double valueEnd;
+    } conditions[] =
+    {
+        { "Cubic Clamped1", QwtSpline::Clamped1, 0.5, 1.0 },
+        { "Cubic Clamped2", QwtSpline::Clamped2, 0.4, -0.8 },
+        { "Cubic Clamped3", QwtSpline::Clamped3, 0.03, 0.01 },
+        { "Cubic Linear Runout", QwtSpline::LinearRunout, 0.3, 0.7 },
+        { "Cubic Cubic Runout", QwtSplineC2::CubicRunout, 0.0, 0.0 },
+        { "Cubic Not A Knot", QwtSplineC2::NotAKnot, 0.0, 0.0 }
+    };
+
+    for ( uint i = 0; i < sizeof( conditions ) / sizeof( conditions[0] ); i++ )
+    {
+        const Condition &c = conditions[i];
+
+        QwtSplineCubic *spline = new QwtSplineCubic();
+        spline->setBoundaryConditions( c.condition, c.valueBegin, c.valueEnd );
+
+        testParallel( c.name, spline, points );
+    }
+}
+
 int main()
 {
     testSplines();
     testDuplicates();
+    testIncremental();
+    testParallel();
 }
@@ -13,4 +13,6 @@ TEMPLATE = subdirs
 
 SUBDIRS += \
     splinetest \
-    splineprof
+    splineprof \
+    dateprof \
+    graphictest